@@ -0,0 +1,199 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "benchmark.h"
+#include "cpu.h"
+#include "layer.h"
+#include "layer_type.h"
+
+static int g_loop_count = 10;
+
+static float random_float(float a, float b)
+{
+    return a + (b - a) * (rand() / (float)RAND_MAX);
+}
+
+static ncnn::Mat random_mat(int w, int h, int c, float a, float b)
+{
+    ncnn::Mat m(w, h, c);
+    for (int q = 0; q < c; q++)
+    {
+        float* ptr = m.channel(q);
+        for (int i = 0; i < w * h; i++)
+        {
+            ptr[i] = random_float(a, b);
+        }
+    }
+    return m;
+}
+
+static void benchmark(const char* comment, int typeindex, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& bottom_blobs, const ncnn::Option& opt)
+{
+    ncnn::Layer* op = ncnn::create_layer(typeindex);
+
+    op->load_param(pd);
+    op->create_pipeline(opt);
+
+    double time_min = DBL_MAX;
+    double time_max = -DBL_MAX;
+    double time_avg = 0;
+
+    int count = 0;
+    for (int i = 0; i < g_loop_count; i++)
+    {
+        std::vector<ncnn::Mat> top_blobs(1);
+
+        double start = ncnn::get_current_time();
+
+        int ret = op->forward(bottom_blobs, top_blobs, opt);
+
+        double end = ncnn::get_current_time();
+
+        if (ret != 0)
+        {
+            fprintf(stderr, "%s forward failed %d\n", comment, ret);
+            break;
+        }
+
+        double time = end - start;
+
+        time_min = std::min(time_min, time);
+        time_max = std::max(time_max, time);
+        time_avg += time;
+
+        count = top_blobs[0].h;
+    }
+
+    time_avg /= g_loop_count;
+
+    fprintf(stderr, "%20s  min = %7.2f  max = %7.2f  avg = %7.2f  detections = %d\n", comment, time_min, time_max, time_avg, count);
+
+    op->destroy_pipeline(opt);
+
+    delete op;
+}
+
+static void benchmark_detectionoutput(const ncnn::Option& opt)
+{
+    // ssd300 on voc
+    const int num_class = 21;
+    const int num_prior = 8732;
+
+    ncnn::ParamDict pd;
+    pd.set(0, num_class);
+    pd.set(1, 0.45f);  // nms_threshold
+    pd.set(2, 400);    // nms_top_k
+    pd.set(3, 200);    // keep_top_k
+    pd.set(4, 0.01f);  // confidence_threshold
+
+    ncnn::Mat priorbox(num_prior * 4, 2);
+    {
+        float* pb = priorbox.row(0);
+        float* var = priorbox.row(1);
+        for (int i = 0; i < num_prior; i++)
+        {
+            float cx = random_float(0.f, 1.f);
+            float cy = random_float(0.f, 1.f);
+            float bw = random_float(0.02f, 0.5f);
+            float bh = random_float(0.02f, 0.5f);
+            pb[i * 4] = cx - bw * 0.5f;
+            pb[i * 4 + 1] = cy - bh * 0.5f;
+            pb[i * 4 + 2] = cx + bw * 0.5f;
+            pb[i * 4 + 3] = cy + bh * 0.5f;
+            var[i * 4] = 0.1f;
+            var[i * 4 + 1] = 0.1f;
+            var[i * 4 + 2] = 0.2f;
+            var[i * 4 + 3] = 0.2f;
+        }
+    }
+
+    std::vector<ncnn::Mat> bottom_blobs(3);
+    bottom_blobs[0] = random_mat(num_prior * 4, 1, 1, -1.f, 1.f);
+    bottom_blobs[1] = random_mat(num_prior * num_class, 1, 1, 0.f, 0.1f);
+    bottom_blobs[2] = priorbox;
+
+    benchmark("DetectionOutput", ncnn::LayerType::DetectionOutput, pd, bottom_blobs, opt);
+}
+
+static void benchmark_yolov3detectionoutput(const ncnn::Option& opt)
+{
+    // yolov3 416x416 on coco
+    const int num_class = 80;
+    const int num_box = 3;
+
+    const float biases_data[18] = {10, 13, 16, 30, 33, 23, 30, 61, 62, 45, 59, 119, 116, 90, 156, 198, 373, 326};
+    const float mask_data[9] = {6, 7, 8, 3, 4, 5, 0, 1, 2};
+    const float anchors_scale_data[3] = {32, 16, 8};
+
+    ncnn::Mat biases(18);
+    ncnn::Mat mask(9);
+    ncnn::Mat anchors_scale(3);
+    std::copy(biases_data, biases_data + 18, (float*)biases);
+    std::copy(mask_data, mask_data + 9, (float*)mask);
+    std::copy(anchors_scale_data, anchors_scale_data + 3, (float*)anchors_scale);
+
+    ncnn::ParamDict pd;
+    pd.set(0, num_class);
+    pd.set(1, num_box);
+    pd.set(2, 0.01f); // confidence_threshold
+    pd.set(3, 0.45f); // nms_threshold
+    pd.set(4, biases);
+    pd.set(5, mask);
+    pd.set(6, anchors_scale);
+
+    std::vector<ncnn::Mat> bottom_blobs(3);
+    bottom_blobs[0] = random_mat(13, 13, num_box * (4 + 1 + num_class), -4.f, 1.f);
+    bottom_blobs[1] = random_mat(26, 26, num_box * (4 + 1 + num_class), -4.f, 1.f);
+    bottom_blobs[2] = random_mat(52, 52, num_box * (4 + 1 + num_class), -4.f, 1.f);
+
+    benchmark("Yolov3DetectionOutput", ncnn::LayerType::Yolov3DetectionOutput, pd, bottom_blobs, opt);
+}
+
+int main(int argc, char** argv)
+{
+    int num_threads = ncnn::get_physical_big_cpu_count();
+
+    if (argc >= 2)
+    {
+        g_loop_count = atoi(argv[1]);
+    }
+    if (argc >= 3)
+    {
+        num_threads = atoi(argv[2]);
+    }
+
+    if (g_loop_count <= 0)
+        g_loop_count = 1;
+
+    ncnn::Option opt;
+    opt.lightmode = true;
+    opt.num_threads = num_threads;
+    opt.use_packing_layout = false;
+
+    fprintf(stderr, "loop_count = %d\n", g_loop_count);
+    fprintf(stderr, "num_threads = %d\n", num_threads);
+
+    srand(7767517);
+
+    benchmark_detectionoutput(opt);
+    benchmark_yolov3detectionoutput(opt);
+
+    return 0;
+}
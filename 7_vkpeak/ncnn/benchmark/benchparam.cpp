@@ -0,0 +1,119 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "net.h"
+
+static int g_loop_count = 10;
+
+static int read_text(const char* path, std::vector<char>& text)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", path);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    text.resize(size + 1);
+    size_t nread = size > 0 ? fread(&text[0], 1, size, fp) : 0;
+    text[size] = '\0';
+    fclose(fp);
+
+    return nread == (size_t)size ? 0 : -1;
+}
+
+static void benchmark(const char* comment, const char* parampath, const char* text, bool from_mem)
+{
+    double time_min = DBL_MAX;
+    double time_max = -DBL_MAX;
+    double time_avg = 0;
+
+    for (int i = 0; i < g_loop_count; i++)
+    {
+        ncnn::Net net;
+
+        double start = ncnn::get_current_time();
+
+        int ret = from_mem ? net.load_param_mem(text) : net.load_param(parampath);
+
+        double end = ncnn::get_current_time();
+
+        if (ret != 0)
+        {
+            fprintf(stderr, "load_param %s failed\n", parampath);
+            return;
+        }
+
+        double time = end - start;
+
+        time_min = std::min(time_min, time);
+        time_max = std::max(time_max, time);
+        time_avg += time;
+    }
+
+    time_avg /= g_loop_count;
+
+    fprintf(stderr, "%20s  %4s  min = %7.2f  max = %7.2f  avg = %7.2f\n", comment, from_mem ? "mem" : "file", time_min, time_max, time_avg);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s [loop count] [param files...]\n", argv[0]);
+        return -1;
+    }
+
+    g_loop_count = atoi(argv[1]);
+    if (g_loop_count <= 0)
+        g_loop_count = 1;
+
+    fprintf(stderr, "loop_count = %d\n", g_loop_count);
+
+    for (int i = 2; i < argc; i++)
+    {
+        const char* parampath = argv[i];
+
+        std::vector<char> text;
+        if (read_text(parampath, text) != 0)
+            continue;
+
+        // strip directory and extension for display
+        std::string comment = parampath;
+        size_t slash = comment.find_last_of("/\\");
+        if (slash != std::string::npos)
+            comment = comment.substr(slash + 1);
+        size_t dot = comment.rfind(".param");
+        if (dot != std::string::npos)
+            comment = comment.substr(0, dot);
+
+        benchmark(comment.c_str(), parampath, &text[0], false);
+        benchmark(comment.c_str(), parampath, &text[0], true);
+    }
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+# run ncnnoptimize pass pipelines on small graphs
+# and check which layers are fused, folded or left alone
+
+# write the param text, optimize it with flag and read the optimized param back into out_var
+function(ncnnoptimize_case name param flag out_var)
+    file(WRITE ${TEST_WORK_DIR}/ncnnoptimize_${name}.param "${param}")
+
+    execute_process(COMMAND ${NCNNOPTIMIZE} ${TEST_WORK_DIR}/ncnnoptimize_${name}.param null ${TEST_WORK_DIR}/ncnnoptimize_${name}_opt.param ${TEST_WORK_DIR}/ncnnoptimize_${name}_opt.bin ${flag} RESULT_VARIABLE result ERROR_QUIET)
+    if(NOT "${result}" STREQUAL "0")
+        message(FATAL_ERROR "${name}: ncnnoptimize failed with return value '${result}'")
+    endif()
+
+    file(READ ${TEST_WORK_DIR}/ncnnoptimize_${name}_opt.param optimized_param)
+    set(${out_var} "${optimized_param}" PARENT_SCOPE)
+endfunction()
+
+# fail unless the optimized param has a line matching each pattern
+function(ncnnoptimize_expect name optimized_param)
+    foreach(pattern ${ARGN})
+        if(NOT optimized_param MATCHES "\n${pattern}")
+            message(FATAL_ERROR "${name}: expect '${pattern}'\n${optimized_param}")
+        endif()
+    endforeach()
+endfunction()
+
+# fail if the optimized param has a line matching any pattern
+function(ncnnoptimize_unexpect name optimized_param)
+    foreach(pattern ${ARGN})
+        if(optimized_param MATCHES "\n${pattern}")
+            message(FATAL_ERROR "${name}: unexpected '${pattern}'\n${optimized_param}")
+        endif()
+    endforeach()
+endfunction()
+
+# decomposed gelu + layernorm collapse into their fused layers
+ncnnoptimize_case(fuse
+"7767517
+23 30
+Input            data     0 1 data 0=64
+Split            splitx   1 3 data x0 x1 x2
+BinaryOp         pow3     1 1 x1 xp 0=6 1=1 2=3.000000e+00
+BinaryOp         mulc     1 1 xp xc 0=2 1=1 2=4.471500e-02
+BinaryOp         addx     2 1 x0 xc xs 0=0
+BinaryOp         mulsqrt  1 1 xs xr 0=2 1=1 2=7.978846e-01
+UnaryOp          tanh     1 1 xr xt 0=16
+BinaryOp         add1     1 1 xt xt1 0=0 1=1 2=1.000000e+00
+BinaryOp         mulx     2 1 x2 xt1 xm 0=2
+BinaryOp         half     1 1 xm gelu 0=2 1=1 2=5.000000e-01
+Split            splity   1 2 gelu y0 y1
+Reduction        mean0    1 1 y0 mu 0=3 1=0 -23303=1,-1 4=1 5=1
+BinaryOp         sub      2 1 y1 mu d 0=1
+Split            splitd   1 2 d d0 d1
+BinaryOp         sq       1 1 d0 d2 0=6 1=1 2=2.000000e+00
+Reduction        mean1    1 1 d2 var 0=3 1=0 -23303=1,-1 4=1 5=1
+BinaryOp         addeps   1 1 var ve 0=0 1=1 2=1.000000e-05
+UnaryOp          sqrt     1 1 ve sd 0=5
+BinaryOp         div      2 1 d1 sd n 0=3
+MemoryData       gamma    0 1 g 0=64
+BinaryOp         mulg     2 1 n g ng 0=2
+MemoryData       beta     0 1 b 0=64
+BinaryOp         addb     2 1 ng b out 0=0
+" 0 optimized_param)
+ncnnoptimize_expect(fuse "${optimized_param}" "GELU " "LayerNorm ")
+ncnnoptimize_unexpect(fuse "${optimized_param}" "BinaryOp " "UnaryOp " "Eltwise " "Reduction ")
+
+# a per-tensor gamma and beta scale the whole blob, not the normalized axis
+ncnnoptimize_case(layernorm_broadcast
+"7767517
+14 16
+Input            data     0 1 data 0=64
+Split            splity   1 2 data y0 y1
+Reduction        mean0    1 1 y0 mu 0=3 1=0 -23303=1,-1 4=1 5=1
+BinaryOp         sub      2 1 y1 mu d 0=1
+Split            splitd   1 2 d d0 d1
+BinaryOp         sq       1 1 d0 d2 0=6 1=1 2=2.000000e+00
+Reduction        mean1    1 1 d2 var 0=3 1=0 -23303=1,-1 4=1 5=1
+BinaryOp         addeps   1 1 var ve 0=0 1=1 2=1.000000e-05
+UnaryOp          sqrt     1 1 ve sd 0=5
+BinaryOp         div      2 1 d1 sd n 0=3
+MemoryData       gamma    0 1 g 0=1
+BinaryOp         mulg     2 1 n g ng 0=2
+MemoryData       beta     0 1 b 0=1
+BinaryOp         addb     2 1 ng b out 0=0
+" 0 optimized_param)
+ncnnoptimize_unexpect(layernorm_broadcast "${optimized_param}" "LayerNorm ")
+
+# a constant chain feeding a real layer becomes one MemoryData
+# a constant chain ending in a graph output survives as MemoryData
+ncnnoptimize_case(fold
+"7767517
+7 7
+Input            data     0 1 data 0=4 1=4
+MemoryData       c0       0 1 c0 0=16
+Reshape          r0       1 1 c0 c0r 0=4 1=4
+BinaryOp         add0     1 1 c0r c0a 0=0 1=1 2=1.000000e+00
+BinaryOp         mul      2 1 data c0a out 0=2
+MemoryData       c1       0 1 c1 0=8
+BinaryOp         mul1     1 1 c1 k 0=2 1=1 2=2.000000e+00
+" 0 optimized_param)
+ncnnoptimize_expect(fold "${optimized_param}" "MemoryData +add0 +0 1 c0a " "MemoryData +mul1 +0 1 k " "[A-Za-z]+ +mul +2 1 data c0a out ")
+ncnnoptimize_unexpect(fold "${optimized_param}" "Reshape " "MemoryData +c0 " "MemoryData +c1 " "BinaryOp +add0 " "BinaryOp +mul1 ")
+
+# only a constant zero Padding with a single Convolution consumer folds into the convolution pads
+ncnnoptimize_case(padding
+"7767517
+12 16
+Input                data   0 1 data 0=8 1=8 2=4
+Split                split  1 4 data d0 d1 d2 d3
+Padding              pad0   1 1 d0 p0 0=1 1=1 2=1 3=1
+Convolution          conv0  1 1 p0 c0 0=4 1=3 6=144
+Padding              pad1   1 1 d1 p1 0=1 1=1 2=1 3=1 5=1.000000e+00
+Convolution          conv1  1 1 p1 c1 0=4 1=3 6=144
+Padding              pad2   1 1 d2 p2 0=1 1=1 2=1 3=1
+Split                split2 1 2 p2 p20 p21
+Convolution          conv2  1 1 p20 c2 0=4 1=3 6=144
+Convolution          conv3  1 1 p21 c3 0=4 1=3 6=144
+Padding              pad3   1 1 d3 p3 0=1 1=1 2=1 3=1
+ConvolutionDepthWise dw0    1 1 p3 w0 0=4 1=3 6=36 7=4
+" 0 optimized_param)
+ncnnoptimize_expect(padding "${optimized_param}" "Convolution +conv0 +1 1 d0 c0[^\n]* 4=1" "ConvolutionDepthWise +dw0 +1 1 d3 w0[^\n]* 4=1" "Padding +pad1 " "Convolution +conv1 +1 1 p1 c1 " "Padding +pad2 " "Convolution +conv2 +1 1 p2[0-9]* c2 " "Convolution +conv3 +1 1 p2[0-9]* c3 ")
+ncnnoptimize_unexpect(padding "${optimized_param}" "Padding +pad0 " "Padding +pad3 ")
+
+# flag bit 2 fuses a depth-wise convolution and its 1x1 convolution consumer
+set(dwpw_param
+"7767517
+3 3
+Input                data   0 1 data 0=8 1=8 2=16
+ConvolutionDepthWise dw     1 1 data dw 0=16 1=3 4=1 5=1 6=144 7=16
+Convolution          pw     1 1 dw pw 0=32 1=1 5=1 6=512
+")
+ncnnoptimize_case(dwpw "${dwpw_param}" 2 optimized_param)
+ncnnoptimize_expect(dwpw "${optimized_param}" "ConvolutionDepthWisePointWise +dw +1 1 data pw ")
+ncnnoptimize_unexpect(dwpw "${optimized_param}" "ConvolutionDepthWise " "Convolution ")
+
+ncnnoptimize_case(dwpw_off "${dwpw_param}" 0 optimized_param)
+ncnnoptimize_expect(dwpw_off "${optimized_param}" "ConvolutionDepthWise +dw " "Convolution +pw ")
+ncnnoptimize_unexpect(dwpw_off "${optimized_param}" "ConvolutionDepthWisePointWise ")
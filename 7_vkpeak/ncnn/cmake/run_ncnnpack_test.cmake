@@ -0,0 +1,21 @@
+# write a small model, pack it with ncnn2mem
+# and check that the pack loads to the same outputs as the param and bin files
+
+execute_process(COMMAND ${TEST_EXECUTABLE} write ${TEST_WORK_DIR} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "writing the model failed")
+endif()
+
+execute_process(COMMAND ${NCNN2MEM}
+    ${TEST_WORK_DIR}/ncnnpack.param ${TEST_WORK_DIR}/ncnnpack.bin
+    ${TEST_WORK_DIR}/ncnnpack.id.h ${TEST_WORK_DIR}/ncnnpack.mem.h
+    ${TEST_WORK_DIR}/ncnnpack.ncnnpack
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "ncnn2mem failed")
+endif()
+
+execute_process(COMMAND ${TEST_EXECUTABLE} compare ${TEST_WORK_DIR} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "ncnnpack round trip failed")
+endif()
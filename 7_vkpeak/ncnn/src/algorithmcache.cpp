@@ -0,0 +1,178 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "algorithmcache.h"
+
+#include "cpu.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace ncnn {
+
+class AlgorithmCachePrivate
+{
+public:
+    struct algorithm_cache_entry
+    {
+        char cpu_model[256];
+        char signature[256];
+        int algorithm;
+    };
+
+    int find_entry(const char* cpu_model, const char* signature) const;
+    void insert_entry(const char* cpu_model, const char* signature, int algorithm);
+
+    mutable Mutex lock;
+    std::vector<algorithm_cache_entry> entries;
+};
+
+int AlgorithmCachePrivate::find_entry(const char* cpu_model, const char* signature) const
+{
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (strcmp(entries[i].cpu_model, cpu_model) == 0 && strcmp(entries[i].signature, signature) == 0)
+            return (int)i;
+    }
+
+    return -1;
+}
+
+void AlgorithmCachePrivate::insert_entry(const char* cpu_model, const char* signature, int algorithm)
+{
+    const int i = find_entry(cpu_model, signature);
+    if (i != -1)
+    {
+        entries[i].algorithm = algorithm;
+        return;
+    }
+
+    algorithm_cache_entry entry;
+    strncpy(entry.cpu_model, cpu_model, 255);
+    entry.cpu_model[255] = '\0';
+    strncpy(entry.signature, signature, 255);
+    entry.signature[255] = '\0';
+    entry.algorithm = algorithm;
+    entries.push_back(entry);
+}
+
+AlgorithmCache::AlgorithmCache()
+    : d(new AlgorithmCachePrivate)
+{
+}
+
+AlgorithmCache::~AlgorithmCache()
+{
+    clear();
+
+    delete d;
+}
+
+AlgorithmCache::AlgorithmCache(const AlgorithmCache&)
+    : d(0)
+{
+}
+
+AlgorithmCache& AlgorithmCache::operator=(const AlgorithmCache&)
+{
+    return *this;
+}
+
+#if NCNN_STDIO
+int AlgorithmCache::load(const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    MutexLockGuard lock(d->lock);
+
+    // one choice per line
+    // cpu model <tab> layer signature <tab> algorithm
+    char line[1024];
+    while (fgets(line, 1024, fp))
+    {
+        char* algorithm_tab = strrchr(line, '\t');
+        if (!algorithm_tab)
+            continue;
+
+        *algorithm_tab = '\0';
+
+        char* signature_tab = strchr(line, '\t');
+        if (!signature_tab)
+            continue;
+
+        *signature_tab = '\0';
+
+        d->insert_entry(line, signature_tab + 1, atoi(algorithm_tab + 1));
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+
+int AlgorithmCache::save(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    MutexLockGuard lock(d->lock);
+
+    for (size_t i = 0; i < d->entries.size(); i++)
+    {
+        const AlgorithmCachePrivate::algorithm_cache_entry& entry = d->entries[i];
+        fprintf(fp, "%s\t%s\t%d\n", entry.cpu_model, entry.signature, entry.algorithm);
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+#endif // NCNN_STDIO
+
+void AlgorithmCache::clear()
+{
+    MutexLockGuard lock(d->lock);
+
+    d->entries.clear();
+}
+
+int AlgorithmCache::find(const char* signature) const
+{
+    MutexLockGuard lock(d->lock);
+
+    const int i = d->find_entry(get_cpu_model_name(), signature);
+    if (i == -1)
+        return -1;
+
+    return d->entries[i].algorithm;
+}
+
+void AlgorithmCache::insert(const char* signature, int algorithm)
+{
+    MutexLockGuard lock(d->lock);
+
+    d->insert_entry(get_cpu_model_name(), signature, algorithm);
+}
+
+} // namespace ncnn
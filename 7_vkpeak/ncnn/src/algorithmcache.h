@@ -0,0 +1,67 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef NCNN_ALGORITHMCACHE_H
+#define NCNN_ALGORITHMCACHE_H
+
+#include "platform.h"
+
+namespace ncnn {
+
+// per layer kernel choices timed on the running machine
+// set the cache in opt.algorithm_cache before loading a net whose param carries input shape hints,
+// layers with several kernels for the same work then time every candidate for the hinted shape
+// and thread count at load and keep the fastest
+// choices are keyed by cpu model name and layer signature, so one file
+// collected on every kind of machine of a mixed fleet serves all of them
+// load the file before loading the net and save it afterwards to skip the timing next time
+class AlgorithmCachePrivate;
+class NCNN_EXPORT AlgorithmCache
+{
+public:
+    AlgorithmCache();
+    virtual ~AlgorithmCache();
+
+#if NCNN_STDIO
+    // merge the choices from a file written by save()
+    // return 0 if success
+    int load(const char* path);
+
+    // write the choices of all cpu models
+    // return 0 if success
+    int save(const char* path) const;
+#endif // NCNN_STDIO
+
+    // drop all choices
+    void clear();
+
+    // the algorithm chosen for the layer signature on this cpu model, -1 if not timed yet
+    // thread-safe
+    int find(const char* signature) const;
+
+    // record the algorithm chosen for the layer signature on this cpu model
+    // thread-safe
+    void insert(const char* signature, int algorithm);
+
+private:
+    AlgorithmCache(const AlgorithmCache&);
+    AlgorithmCache& operator=(const AlgorithmCache&);
+
+private:
+    AlgorithmCachePrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_ALGORITHMCACHE_H
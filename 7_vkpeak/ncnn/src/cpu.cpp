@@ -1361,6 +1361,87 @@ int get_physical_big_cpu_count()
     return g_cpucount - g_physical_cpucount;
 }
 
+static const char* get_cpumodelname()
+{
+    static char name[256];
+    const int size = 256;
+
+    name[0] = '\0';
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(0x80000000, cpu_info);
+
+    if (cpu_info[0] >= 0x80000004)
+    {
+        // brand string in 48 bytes
+        char brand[49];
+        x86_cpuid(0x80000002, (unsigned int*)brand);
+        x86_cpuid(0x80000003, (unsigned int*)(brand + 16));
+        x86_cpuid(0x80000004, (unsigned int*)(brand + 32));
+        brand[48] = '\0';
+
+        strncpy(name, brand, size - 1);
+        name[size - 1] = '\0';
+    }
+#elif defined __ANDROID__ || defined __linux__
+    FILE* fp = fopen("/proc/cpuinfo", "rb");
+    if (fp)
+    {
+        char line[1024];
+        while (!feof(fp))
+        {
+            char* s = fgets(line, 1024, fp);
+            if (!s)
+                break;
+
+            if (memcmp(line, "model name", 10) != 0 && memcmp(line, "Hardware", 8) != 0 && memcmp(line, "cpu model", 9) != 0)
+                continue;
+
+            const char* colon = strchr(line, ':');
+            if (!colon)
+                continue;
+
+            strncpy(name, colon + 1, size - 1);
+            name[size - 1] = '\0';
+            break;
+        }
+
+        fclose(fp);
+    }
+#elif __APPLE__
+    size_t name_len = size;
+    if (sysctlbyname("machdep.cpu.brand_string", name, &name_len, NULL, 0) != 0)
+        name[0] = '\0';
+#endif
+
+    // trim surrounding white spaces
+    int len = (int)strlen(name);
+    while (len > 0 && (name[len - 1] == ' ' || name[len - 1] == '\t' || name[len - 1] == '\n' || name[len - 1] == '\r'))
+        name[--len] = '\0';
+
+    int start = 0;
+    while (name[start] == ' ' || name[start] == '\t')
+        start++;
+
+    memmove(name, name + start, len - start + 1);
+
+    if (name[0] == '\0')
+    {
+        strncpy(name, "unknown", size - 1);
+        name[size - 1] = '\0';
+    }
+
+    return name;
+}
+
+static const char* g_cpu_model_name = get_cpumodelname();
+
+const char* get_cpu_model_name()
+{
+    return g_cpu_model_name;
+}
+
 #if (defined _WIN32 && !(defined __MINGW32__))
 static CpuSet get_smt_cpu_mask()
 {
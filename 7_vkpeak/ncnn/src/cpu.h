@@ -126,6 +126,10 @@ NCNN_EXPORT int get_physical_cpu_count();
 NCNN_EXPORT int get_physical_little_cpu_count();
 NCNN_EXPORT int get_physical_big_cpu_count();
 
+// cpu model name, such as the x86 brand string
+// returns "unknown" when the platform does not tell
+NCNN_EXPORT const char* get_cpu_model_name();
+
 // bind all threads on little clusters if powersave enabled
 // affects HMP arch cpu like ARM big.LITTLE
 // only implemented on android at the moment
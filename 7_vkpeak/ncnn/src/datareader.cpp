@@ -14,6 +14,7 @@
 
 #include "datareader.h"
 
+#include <ctype.h>
 #include <string.h>
 
 namespace ncnn {
@@ -118,18 +119,63 @@ DataReaderFromMemory& DataReaderFromMemory::operator=(const DataReaderFromMemory
 }
 
 #if NCNN_STRING
+static bool scan_skips_whitespace(const char* format)
+{
+    // conversions other than %[ %c %n skip leading whitespace by themselves
+    if (isspace((unsigned char)format[0]))
+        return true;
+
+    if (format[0] != '%')
+        return false;
+
+    const char* p = format + 1;
+    while (isdigit((unsigned char)*p))
+        p++;
+
+    return *p != '[' && *p != 'c' && *p != 'n' && *p != '%';
+}
+
 int DataReaderFromMemory::scan(const char* format, void* p) const
 {
+    char format_with_n_buf[64];
     size_t fmtlen = strlen(format);
-
-    char* format_with_n = new char[fmtlen + 4];
+    char* format_with_n = fmtlen + 3 <= sizeof(format_with_n_buf) ? format_with_n_buf : new char[fmtlen + 4];
     sprintf(format_with_n, "%s%%n", format);
 
+    const char* mem = (const char*)d->mem;
+    if (scan_skips_whitespace(format))
+    {
+        while (isspace((unsigned char)*mem))
+            mem++;
+    }
+
+    // sscanf measures the whole remaining string on every call
+    // scan a window holding only the next token so that parsing a large param is linear
+    // a single scan never consumes more than one whitespace delimited token
+    char window[512];
+    size_t window_len = 0;
+    bool in_token = false;
+    while (window_len < sizeof(window) - 1 && mem[window_len] != '\0')
+    {
+        bool is_space = isspace((unsigned char)mem[window_len]) != 0;
+        if (in_token && is_space)
+            break;
+
+        in_token = in_token || !is_space;
+        window[window_len] = mem[window_len];
+        window_len++;
+    }
+    window[window_len] = '\0';
+
     int nconsumed = 0;
-    int nscan = sscanf((const char*)d->mem, format_with_n, p, &nconsumed);
-    d->mem += nconsumed;
+    int nscan = sscanf(window, format_with_n, p, &nconsumed);
+    if (nconsumed > 0)
+    {
+        d->mem = (const unsigned char*)(mem + nconsumed);
+    }
 
-    delete[] format_with_n;
+    if (format_with_n != format_with_n_buf)
+        delete[] format_with_n;
 
     return nconsumed > 0 ? nscan : 0;
 }
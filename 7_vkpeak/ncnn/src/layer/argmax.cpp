@@ -14,7 +14,9 @@
 
 #include "argmax.h"
 
+#include <float.h>
 #include <functional>
+#include <math.h>
 
 namespace ncnn {
 
@@ -27,6 +29,7 @@ int ArgMax::load_param(const ParamDict& pd)
 {
     out_max_val = pd.get(0, 0);
     topk = pd.get(1, 1);
+    softmax = pd.get(2, 0);
 
     return 0;
 }
@@ -35,10 +38,12 @@ int ArgMax::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) co
 {
     int size = bottom_blob.total();
 
+    const int k = std::min(topk, size);
+
     if (out_max_val)
-        top_blob.create(topk, 2, 4u, opt.blob_allocator);
+        top_blob.create(k, 2, 4u, opt.blob_allocator);
     else
-        top_blob.create(topk, 1, 4u, opt.blob_allocator);
+        top_blob.create(k, 1, 4u, opt.blob_allocator);
     if (top_blob.empty())
         return -100;
 
@@ -53,22 +58,33 @@ int ArgMax::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) co
         vec[i] = std::make_pair(ptr[i], i);
     }
 
-    std::partial_sort(vec.begin(), vec.begin() + topk, vec.end(),
+    std::partial_sort(vec.begin(), vec.begin() + k, vec.end(),
                       std::greater<std::pair<float, int> >());
 
     float* outptr = top_blob;
     if (out_max_val)
     {
-        float* valptr = outptr + topk;
-        for (int i = 0; i < topk; i++)
+        float max = -FLT_MAX;
+        float sum = 0.f;
+        if (softmax)
+        {
+            max = vec[0].first;
+            for (int i = 0; i < size; i++)
+            {
+                sum += expf(ptr[i] - max);
+            }
+        }
+
+        float* valptr = outptr + k;
+        for (int i = 0; i < k; i++)
         {
-            outptr[i] = vec[i].first;
+            outptr[i] = softmax ? expf(vec[i].first - max) / sum : vec[i].first;
             valptr[i] = vec[i].second;
         }
     }
     else
     {
-        for (int i = 0; i < topk; i++)
+        for (int i = 0; i < k; i++)
         {
             outptr[i] = vec[i].second;
         }
@@ -31,6 +31,9 @@ public:
 public:
     int out_max_val;
     int topk;
+
+    // output the softmax probabilities of the topk instead of the raw values
+    int softmax;
 };
 
 } // namespace ncnn
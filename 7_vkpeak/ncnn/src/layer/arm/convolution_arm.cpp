@@ -137,6 +137,15 @@ int Convolution_arm::create_pipeline(const Option& opt)
 #if NCNN_INT8
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
+        if (bottom_blob_int8_zero_point != 0)
+        {
+            // asymmetric int8 activation runs on the reference implementation
+            support_packing = false;
+            support_fp16_storage = false;
+            support_bf16_storage = false;
+            return 0;
+        }
+
         return create_pipeline_int8_arm(opt);
     }
 #endif
@@ -461,6 +470,9 @@ int Convolution_arm::forward(const Mat& bottom_blob, Mat& top_blob, const Option
 #if NCNN_INT8
     if (opt.use_int8_inference && int8_scale_term)
     {
+        if (bottom_blob_int8_zero_point != 0)
+            return Convolution::forward(bottom_blob, top_blob, opt);
+
         return forward_int8_arm(bottom_blob, top_blob, opt);
     }
 #endif
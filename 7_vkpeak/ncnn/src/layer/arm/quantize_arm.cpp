@@ -41,8 +41,24 @@ Quantize_arm::Quantize_arm()
 #endif
 }
 
+int Quantize_arm::create_pipeline(const Option& /*opt*/)
+{
+    if (zero_point != 0)
+    {
+        // asymmetric quantization runs on the reference implementation
+        support_packing = false;
+        support_fp16_storage = false;
+        support_bf16_storage = false;
+    }
+
+    return 0;
+}
+
 int Quantize_arm::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+    if (zero_point != 0)
+        return Quantize::forward(bottom_blob, top_blob, opt);
+
     int elembits = bottom_blob.elembits();
 
 #if NCNN_ARM82
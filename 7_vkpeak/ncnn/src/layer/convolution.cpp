@@ -48,6 +48,10 @@ int Convolution::load_param(const ParamDict& pd)
 
     dynamic_weight = pd.get(19, 0);
 
+#if NCNN_INT8
+    bottom_blob_int8_zero_point = pd.get(20, 0);
+#endif
+
     if (dynamic_weight)
     {
         one_blob_only = false;
@@ -349,12 +353,21 @@ void Convolution::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered
     const int kernel_extent_w = dilation_w * (_kernel_w - 1) + 1;
     const int kernel_extent_h = dilation_h * (_kernel_h - 1) + 1;
 
+    float border_value = pad_value;
+#if NCNN_INT8
+    if (bottom_blob.elembits() == 8)
+    {
+        // asymmetric int8 pads with the zero point
+        border_value += bottom_blob_int8_zero_point;
+    }
+#endif
+
     bottom_blob_bordered = bottom_blob;
     if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0)
     {
         Option opt_b = opt;
         opt_b.blob_allocator = opt.workspace_allocator;
-        copy_make_border(bottom_blob, bottom_blob_bordered, pad_top, pad_bottom, pad_left, pad_right, BORDER_CONSTANT, pad_value, opt_b);
+        copy_make_border(bottom_blob, bottom_blob_bordered, pad_top, pad_bottom, pad_left, pad_right, BORDER_CONSTANT, border_value, opt_b);
     }
     else if (pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
     {
@@ -365,7 +378,7 @@ void Convolution::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered
         {
             Option opt_b = opt;
             opt_b.blob_allocator = opt.workspace_allocator;
-            copy_make_border(bottom_blob, bottom_blob_bordered, hpad / 2, hpad - hpad / 2, wpad / 2, wpad - wpad / 2, BORDER_CONSTANT, pad_value, opt_b);
+            copy_make_border(bottom_blob, bottom_blob_bordered, hpad / 2, hpad - hpad / 2, wpad / 2, wpad - wpad / 2, BORDER_CONSTANT, border_value, opt_b);
         }
     }
     else if (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234)
@@ -377,7 +390,7 @@ void Convolution::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered
         {
             Option opt_b = opt;
             opt_b.blob_allocator = opt.workspace_allocator;
-            copy_make_border(bottom_blob, bottom_blob_bordered, hpad - hpad / 2, hpad / 2, wpad - wpad / 2, wpad / 2, BORDER_CONSTANT, pad_value, opt_b);
+            copy_make_border(bottom_blob, bottom_blob_bordered, hpad - hpad / 2, hpad / 2, wpad - wpad / 2, wpad / 2, BORDER_CONSTANT, border_value, opt_b);
         }
     }
 }
@@ -409,7 +422,7 @@ int Convolution::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Optio
         Option opt_g = opt;
         opt_g.blob_allocator = opt.workspace_allocator;
 
-        quantize_to_int8(bottom_blob, bottom_blob_unbordered, bottom_blob_int8_scales, opt_g);
+        quantize_to_int8(bottom_blob, bottom_blob_unbordered, bottom_blob_int8_scales, bottom_blob_int8_zero_point, opt_g);
     }
 
     Mat bottom_blob_bordered;
@@ -474,7 +487,7 @@ int Convolution::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Optio
 
                     for (int k = 0; k < maxk; k++)
                     {
-                        int val = sptr[space_ofs[k]];
+                        int val = sptr[space_ofs[k]] - bottom_blob_int8_zero_point;
                         int wt = kptr[k];
                         sum += val * wt;
                     }
@@ -76,6 +76,9 @@ public:
     Mat weight_data_int8_scales;
     Mat bottom_blob_int8_scales;
     Mat top_blob_int8_scales;
+
+    // asymmetric int8 input, fp32 zero maps to this value
+    int bottom_blob_int8_zero_point;
 #endif
 };
 
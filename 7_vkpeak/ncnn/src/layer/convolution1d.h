@@ -35,6 +35,8 @@ public:
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 
 protected:
+    int forward_streaming(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
     void make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered, const Option& opt) const;
     void make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered, int kernel_w, const Option& opt) const;
 
@@ -57,6 +59,10 @@ public:
 
     int dynamic_weight;
 
+    // keep the trailing input frames in a cache blob and
+    // only compute the output frames of newly arrived input
+    int streaming;
+
     // model
     Mat weight_data;
     Mat bias_data;
@@ -17,6 +17,7 @@
 #include "layer_type.h"
 
 #include "fused_activation.h"
+#include "streaming_cache.h"
 
 namespace ncnn {
 
@@ -42,8 +43,9 @@ int ConvolutionDepthWise1D::load_param(const ParamDict& pd)
     activation_params = pd.get(10, Mat());
 
     dynamic_weight = pd.get(19, 0);
+    streaming = pd.get(20, 0);
 
-    if (dynamic_weight)
+    if (dynamic_weight || streaming)
     {
         one_blob_only = false;
     }
@@ -197,6 +199,9 @@ int ConvolutionDepthWise1D::forward(const Mat& bottom_blob, Mat& top_blob, const
 
 int ConvolutionDepthWise1D::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
+    if (streaming)
+        return forward_streaming(bottom_blobs, top_blobs, opt);
+
     const Mat& bottom_blob = bottom_blobs[0];
     const Mat& _weight_data = bottom_blobs[1];
     Mat& top_blob = top_blobs[0];
@@ -241,6 +246,49 @@ int ConvolutionDepthWise1D::forward(const std::vector<Mat>& bottom_blobs, std::v
     return 0;
 }
 
+int ConvolutionDepthWise1D::forward_streaming(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    // bottom_blobs = input frames, cache from the previous chunk (optional)
+    // top_blobs = output frames, cache for the next chunk (optional)
+    const Mat& bottom_blob = bottom_blobs[0];
+    const Mat cache = bottom_blobs.size() >= 2 ? bottom_blobs[1] : Mat();
+
+    // pad_left frames of pad_value stand in for the history of the first chunk
+    Mat bottom_blob_bordered;
+    int ret = streaming_concat(bottom_blob, cache, pad_left, pad_value, bottom_blob_bordered, opt);
+    if (ret != 0)
+        return ret;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int outw = streaming_output_w(bottom_blob_bordered.w, kernel_extent_w, stride_w);
+
+    // make_padding is a no-op in streaming mode
+    if (outw > 0)
+    {
+        ret = forward(bottom_blob_bordered, top_blobs[0], opt);
+        if (ret != 0)
+            return ret;
+
+        ret = streaming_trim_output(top_blobs[0], outw, opt);
+        if (ret != 0)
+            return ret;
+    }
+    else
+    {
+        // not enough frames for one output yet, everything goes to the cache
+        top_blobs[0].release();
+    }
+
+    if (top_blobs.size() >= 2)
+    {
+        ret = streaming_keep_tail(bottom_blob_bordered, outw * stride_w, top_blobs[1], opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 void ConvolutionDepthWise1D::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered, const Option& opt) const
 {
     make_padding(bottom_blob, bottom_blob_bordered, kernel_w, opt);
@@ -253,6 +301,9 @@ void ConvolutionDepthWise1D::make_padding(const Mat& bottom_blob, Mat& bottom_bl
     const int kernel_extent_w = dilation_w * (_kernel_w - 1) + 1;
 
     bottom_blob_bordered = bottom_blob;
+    if (streaming)
+        return;
+
     if (pad_left > 0 || pad_right > 0)
     {
         Option opt_b = opt;
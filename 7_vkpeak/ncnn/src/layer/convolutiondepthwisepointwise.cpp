@@ -0,0 +1,236 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "convolutiondepthwisepointwise.h"
+
+#include "fused_activation.h"
+
+namespace ncnn {
+
+ConvolutionDepthWisePointWise::ConvolutionDepthWisePointWise()
+{
+    one_blob_only = true;
+    support_inplace = false;
+}
+
+int ConvolutionDepthWisePointWise::load_param(const ParamDict& pd)
+{
+    num_output = pd.get(0, 0);
+    kernel_w = pd.get(1, 0);
+    kernel_h = pd.get(11, kernel_w);
+    dilation_w = pd.get(2, 1);
+    dilation_h = pd.get(12, dilation_w);
+    stride_w = pd.get(3, 1);
+    stride_h = pd.get(13, stride_w);
+    pad_left = pd.get(4, 0);
+    pad_right = pd.get(15, pad_left);
+    pad_top = pd.get(14, pad_left);
+    pad_bottom = pd.get(16, pad_top);
+    pad_value = pd.get(18, 0.f);
+    bias_term = pd.get(5, 0);
+    weight_data_size = pd.get(6, 0);
+    activation_type = pd.get(9, 0);
+    activation_params = pd.get(10, Mat());
+
+    pointwise_num_output = pd.get(20, 0);
+    pointwise_bias_term = pd.get(25, 0);
+    pointwise_weight_data_size = pd.get(26, 0);
+    pointwise_activation_type = pd.get(29, 0);
+    pointwise_activation_params = pd.get(30, Mat());
+
+    if (weight_data_size != num_output * kernel_w * kernel_h || pointwise_weight_data_size != num_output * pointwise_num_output)
+    {
+        // reject non depth-wise or mismatched point-wise weight
+        return -100;
+    }
+
+    return 0;
+}
+
+int ConvolutionDepthWisePointWise::load_model(const ModelBin& mb)
+{
+    weight_data = mb.load(weight_data_size, 0);
+    if (weight_data.empty())
+        return -100;
+
+    if (bias_term)
+    {
+        bias_data = mb.load(num_output, 1);
+        if (bias_data.empty())
+            return -100;
+    }
+
+    pointwise_weight_data = mb.load(pointwise_weight_data_size, 0);
+    if (pointwise_weight_data.empty())
+        return -100;
+
+    if (pointwise_bias_term)
+    {
+        pointwise_bias_data = mb.load(pointwise_num_output, 1);
+        if (pointwise_bias_data.empty())
+            return -100;
+    }
+
+    return 0;
+}
+
+int ConvolutionDepthWisePointWise::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int _pad_left, _pad_right, _pad_top, _pad_bottom;
+    resolve_padding(bottom_blob.w, bottom_blob.h, _pad_left, _pad_right, _pad_top, _pad_bottom);
+
+    Mat bottom_blob_bordered = bottom_blob;
+    if (_pad_left > 0 || _pad_right > 0 || _pad_top > 0 || _pad_bottom > 0)
+    {
+        Option opt_b = opt;
+        opt_b.blob_allocator = opt.workspace_allocator;
+        copy_make_border(bottom_blob, bottom_blob_bordered, _pad_top, _pad_bottom, _pad_left, _pad_right, BORDER_CONSTANT, pad_value, opt_b);
+        if (bottom_blob_bordered.empty())
+            return -100;
+    }
+
+    const int w = bottom_blob_bordered.w;
+    const int h = bottom_blob_bordered.h;
+    const size_t elemsize = bottom_blob_bordered.elemsize;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const int outw = (w - kernel_extent_w) / stride_w + 1;
+    const int outh = (h - kernel_extent_h) / stride_h + 1;
+    const int size = outw * outh;
+
+    const int maxk = kernel_w * kernel_h;
+
+    // kernel offsets
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = w * dilation_h - kernel_w * dilation_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2;
+                p1++;
+                p2 += dilation_w;
+            }
+            p2 += gap;
+        }
+    }
+
+    // depth-wise
+    Mat depthwise_blob(outw, outh, num_output, elemsize, opt.workspace_allocator);
+    if (depthwise_blob.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g = 0; g < num_output; g++)
+    {
+        float* outptr = depthwise_blob.channel(g);
+        const float* kptr = (const float*)weight_data + maxk * g;
+        const Mat m = bottom_blob_bordered.channel(g);
+
+        for (int i = 0; i < outh; i++)
+        {
+            for (int j = 0; j < outw; j++)
+            {
+                float sum = 0.f;
+
+                if (bias_term)
+                    sum = bias_data[g];
+
+                const float* sptr = m.row(i * stride_h) + j * stride_w;
+
+                for (int k = 0; k < maxk; k++)
+                {
+                    sum += sptr[space_ofs[k]] * kptr[k];
+                }
+
+                outptr[j] = activation_ss(sum, activation_type, activation_params);
+            }
+
+            outptr += outw;
+        }
+    }
+
+    // point-wise
+    top_blob.create(outw, outh, pointwise_num_output, elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < pointwise_num_output; p++)
+    {
+        float* outptr = top_blob.channel(p);
+        const float* kptr = (const float*)pointwise_weight_data + num_output * p;
+
+        for (int i = 0; i < size; i++)
+        {
+            float sum = 0.f;
+
+            if (pointwise_bias_term)
+                sum = pointwise_bias_data[p];
+
+            for (int q = 0; q < num_output; q++)
+            {
+                sum += depthwise_blob.channel(q)[i] * kptr[q];
+            }
+
+            outptr[i] = activation_ss(sum, pointwise_activation_type, pointwise_activation_params);
+        }
+    }
+
+    return 0;
+}
+
+void ConvolutionDepthWisePointWise::resolve_padding(int w, int h, int& _pad_left, int& _pad_right, int& _pad_top, int& _pad_bottom) const
+{
+    _pad_left = pad_left;
+    _pad_right = pad_right;
+    _pad_top = pad_top;
+    _pad_bottom = pad_bottom;
+
+    if (pad_left == -233 || pad_left == -234)
+    {
+        const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+        const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+        int wpad = kernel_extent_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_extent_h + (h - 1) / stride_h * stride_h - h;
+        wpad = wpad > 0 ? wpad : 0;
+        hpad = hpad > 0 ? hpad : 0;
+
+        if (pad_left == -233)
+        {
+            // tensorflow padding=SAME or onnx padding=SAME_UPPER
+            _pad_left = wpad / 2;
+            _pad_right = wpad - wpad / 2;
+            _pad_top = hpad / 2;
+            _pad_bottom = hpad - hpad / 2;
+        }
+        else
+        {
+            // onnx padding=SAME_LOWER
+            _pad_left = wpad - wpad / 2;
+            _pad_right = wpad / 2;
+            _pad_top = hpad - hpad / 2;
+            _pad_bottom = hpad / 2;
+        }
+    }
+}
+
+} // namespace ncnn
@@ -0,0 +1,78 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef LAYER_CONVOLUTIONDEPTHWISEPOINTWISE_H
+#define LAYER_CONVOLUTIONDEPTHWISEPOINTWISE_H
+
+#include "layer.h"
+
+namespace ncnn {
+
+// depth-wise convolution followed by 1x1 convolution, as in mobilenet style blocks
+class ConvolutionDepthWisePointWise : public Layer
+{
+public:
+    ConvolutionDepthWisePointWise();
+
+    virtual int load_param(const ParamDict& pd);
+
+    virtual int load_model(const ModelBin& mb);
+
+    virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+
+protected:
+    void resolve_padding(int w, int h, int& _pad_left, int& _pad_right, int& _pad_top, int& _pad_bottom) const;
+
+public:
+    // depth-wise param
+    int num_output;
+    int kernel_w;
+    int kernel_h;
+    int dilation_w;
+    int dilation_h;
+    int stride_w;
+    int stride_h;
+    int pad_left; // -233=SAME_UPPER -234=SAME_LOWER
+    int pad_right;
+    int pad_top;
+    int pad_bottom;
+    float pad_value;
+    int bias_term;
+
+    int weight_data_size;
+
+    // 0=none 1=relu 2=leakyrelu 3=clip 4=sigmoid
+    int activation_type;
+    Mat activation_params;
+
+    // point-wise param
+    int pointwise_num_output;
+    int pointwise_bias_term;
+
+    int pointwise_weight_data_size;
+
+    int pointwise_activation_type;
+    Mat pointwise_activation_params;
+
+    // model
+    Mat weight_data;
+    Mat bias_data;
+
+    Mat pointwise_weight_data;
+    Mat pointwise_bias_data;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_CONVOLUTIONDEPTHWISEPOINTWISE_H
@@ -0,0 +1,223 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef LAYER_DETECTION_POSTPROCESS_H
+#define LAYER_DETECTION_POSTPROCESS_H
+
+#include "platform.h"
+
+#include <algorithm>
+#include <vector>
+
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+
+// score sorting and non-maximum suppression shared by
+// DetectionOutput, Proposal, YoloDetectionOutput and Yolov3DetectionOutput
+
+namespace ncnn {
+
+// strict order by score descending, equal scores keep the lower index first
+static inline bool detection_score_greater(const float* scores, int a, int b)
+{
+    return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+}
+
+// quicksort that stops descending into partitions at or beyond position k
+static inline void detection_partial_qsort(const float* scores, int* indices, int left, int right, int k)
+{
+    int i = left;
+    int j = right;
+    int p = indices[(left + right) / 2];
+
+    while (i <= j)
+    {
+        while (detection_score_greater(scores, indices[i], p))
+            i++;
+
+        while (detection_score_greater(scores, p, indices[j]))
+            j--;
+
+        if (i <= j)
+        {
+            // swap
+            std::swap(indices[i], indices[j]);
+
+            i++;
+            j--;
+        }
+    }
+
+    if (left < j)
+        detection_partial_qsort(scores, indices, left, j, k);
+
+    if (i < right && i < k)
+        detection_partial_qsort(scores, indices, i, right, k);
+}
+
+// indices of the topk highest scores in descending order, topk < 0 keeps all
+// costs O(n + topk log topk) instead of sorting everything
+static inline void topk_descent(const float* scores, int n, int topk, std::vector<int>& indices)
+{
+    const int k = topk < 0 ? n : std::min(topk, n);
+
+    indices.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        indices[i] = i;
+    }
+
+    if (n > 1 && k > 0)
+        detection_partial_qsort(scores, &indices[0], 0, n - 1, k);
+
+    indices.resize(k);
+}
+
+// sort datas and scores by score descending and keep the first topk, topk < 0 keeps all
+template<typename T>
+static void sort_descent_inplace(std::vector<T>& datas, std::vector<float>& scores, int topk = -1)
+{
+    if (datas.empty() || scores.empty())
+        return;
+
+    std::vector<int> indices;
+    topk_descent(&scores[0], (int)scores.size(), topk, indices);
+
+    const int k = (int)indices.size();
+
+    std::vector<T> datas_sorted(k);
+    std::vector<float> scores_sorted(k);
+    for (int i = 0; i < k; i++)
+    {
+        datas_sorted[i] = datas[indices[i]];
+        scores_sorted[i] = scores[indices[i]];
+    }
+
+    datas = datas_sorted;
+    scores = scores_sorted;
+}
+
+// greedy nms over boxes already sorted by score
+// boxes are given as separate xmin ymin xmax ymax arrays so that one box
+// is tested against several picked boxes per instruction
+static inline void nms_sorted_boxes(const float* xmin, const float* ymin, const float* xmax, const float* ymax, int n, float nms_threshold, std::vector<size_t>& picked)
+{
+    picked.clear();
+
+    if (n == 0)
+        return;
+
+    // picked boxes in structure-of-arrays layout
+    std::vector<float> picked_boxes(n * 5);
+    float* px0 = &picked_boxes[0];
+    float* py0 = px0 + n;
+    float* px1 = py0 + n;
+    float* py1 = px1 + n;
+    float* parea = py1 + n;
+
+    int picked_count = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        const float ax0 = xmin[i];
+        const float ay0 = ymin[i];
+        const float ax1 = xmax[i];
+        const float ay1 = ymax[i];
+        const float aarea = (ax1 - ax0) * (ay1 - ay0);
+
+        bool keep = true;
+
+        int j = 0;
+#if __SSE2__
+        {
+            __m128 _ax0 = _mm_set1_ps(ax0);
+            __m128 _ay0 = _mm_set1_ps(ay0);
+            __m128 _ax1 = _mm_set1_ps(ax1);
+            __m128 _ay1 = _mm_set1_ps(ay1);
+            __m128 _aarea = _mm_set1_ps(aarea);
+            __m128 _thresh = _mm_set1_ps(nms_threshold);
+            __m128 _zero = _mm_setzero_ps();
+            for (; j + 3 < picked_count; j += 4)
+            {
+                __m128 _w = _mm_sub_ps(_mm_min_ps(_ax1, _mm_loadu_ps(px1 + j)), _mm_max_ps(_ax0, _mm_loadu_ps(px0 + j)));
+                __m128 _h = _mm_sub_ps(_mm_min_ps(_ay1, _mm_loadu_ps(py1 + j)), _mm_max_ps(_ay0, _mm_loadu_ps(py0 + j)));
+                __m128 _inter = _mm_mul_ps(_mm_max_ps(_w, _zero), _mm_max_ps(_h, _zero));
+                __m128 _union = _mm_sub_ps(_mm_add_ps(_aarea, _mm_loadu_ps(parea + j)), _inter);
+
+                // IoU = inter_area / union_area
+                if (_mm_movemask_ps(_mm_cmpgt_ps(_inter, _mm_mul_ps(_thresh, _union))))
+                {
+                    keep = false;
+                    break;
+                }
+            }
+        }
+#endif // __SSE2__
+        for (; keep && j < picked_count; j++)
+        {
+            float w = std::min(ax1, px1[j]) - std::max(ax0, px0[j]);
+            float h = std::min(ay1, py1[j]) - std::max(ay0, py0[j]);
+            float inter_area = std::max(w, 0.f) * std::max(h, 0.f);
+            float union_area = aarea + parea[j] - inter_area;
+
+            // IoU = inter_area / union_area
+            if (inter_area > nms_threshold * union_area)
+                keep = false;
+        }
+
+        if (!keep)
+            continue;
+
+        px0[picked_count] = ax0;
+        py0[picked_count] = ay0;
+        px1[picked_count] = ax1;
+        py1[picked_count] = ay1;
+        parea[picked_count] = aarea;
+        picked_count++;
+
+        picked.push_back(i);
+    }
+}
+
+// greedy nms for any box type with xmin ymin xmax ymax members
+template<typename T>
+static void nms_sorted_bboxes(const std::vector<T>& bboxes, std::vector<size_t>& picked, float nms_threshold)
+{
+    const int n = (int)bboxes.size();
+    if (n == 0)
+    {
+        picked.clear();
+        return;
+    }
+
+    std::vector<float> boxes(n * 4);
+    float* xmin = &boxes[0];
+    float* ymin = xmin + n;
+    float* xmax = ymin + n;
+    float* ymax = xmax + n;
+    for (int i = 0; i < n; i++)
+    {
+        xmin[i] = bboxes[i].xmin;
+        ymin[i] = bboxes[i].ymin;
+        xmax[i] = bboxes[i].xmax;
+        ymax[i] = bboxes[i].ymax;
+    }
+
+    nms_sorted_boxes(xmin, ymin, xmax, ymax, n, nms_threshold, picked);
+}
+
+} // namespace ncnn
+
+#endif // LAYER_DETECTION_POSTPROCESS_H
@@ -31,8 +31,22 @@ Quantize_loongarch::Quantize_loongarch()
 #endif
 }
 
+int Quantize_loongarch::create_pipeline(const Option& /*opt*/)
+{
+    if (zero_point != 0)
+    {
+        // asymmetric quantization runs on the reference implementation
+        support_packing = false;
+    }
+
+    return 0;
+}
+
 int Quantize_loongarch::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+    if (zero_point != 0)
+        return Quantize::forward(bottom_blob, top_blob, opt);
+
     int dims = bottom_blob.dims;
     int elempack = bottom_blob.elempack;
 
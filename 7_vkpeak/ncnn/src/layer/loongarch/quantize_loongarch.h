@@ -24,6 +24,8 @@ class Quantize_loongarch : virtual public Quantize
 public:
     Quantize_loongarch();
 
+    virtual int create_pipeline(const Option& opt);
+
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 };
 
@@ -133,6 +133,13 @@ int Convolution_mips::create_pipeline(const Option& opt)
 #if NCNN_INT8
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
+        if (bottom_blob_int8_zero_point != 0)
+        {
+            // asymmetric int8 activation runs on the reference implementation
+            support_packing = false;
+            return 0;
+        }
+
         return create_pipeline_int8_mips(opt);
     }
 #endif
@@ -250,6 +257,9 @@ int Convolution_mips::forward(const Mat& bottom_blob, Mat& top_blob, const Optio
 #if NCNN_INT8
     if (opt.use_int8_inference && int8_scale_term)
     {
+        if (bottom_blob_int8_zero_point != 0)
+            return Convolution::forward(bottom_blob, top_blob, opt);
+
         return forward_int8_mips(bottom_blob, top_blob, opt);
     }
 #endif
@@ -24,6 +24,8 @@ class Quantize_mips : virtual public Quantize
 public:
     Quantize_mips();
 
+    virtual int create_pipeline(const Option& opt);
+
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 };
 
@@ -33,6 +33,12 @@ int Padding::load_param(const ParamDict& pd)
     per_channel_pad_data_size = pd.get(6, 0);
     front = pd.get(7, 0);
     behind = pd.get(8, 0);
+    streaming = pd.get(20, 0);
+
+    if (streaming)
+    {
+        one_blob_only = false;
+    }
 
     return 0;
 }
@@ -455,4 +461,46 @@ int Padding::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) c
     return 0;
 }
 
+int Padding::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    // bottom_blobs = input frames, stream position (optional)
+    // top_blobs = output frames, stream position (optional)
+    if (!streaming || per_channel_pad_data_size)
+        return -1;
+
+    const Mat& bottom_blob = bottom_blobs[0];
+    Mat& top_blob = top_blobs[0];
+
+    // the stream position counts the input frames seen so far, none means a new stream
+    const bool stream_begin = bottom_blobs.size() < 2 || bottom_blobs[1].empty();
+    const float position = stream_begin ? 0.f : bottom_blobs[1][0];
+
+    if (stream_begin && left > 0)
+    {
+        copy_make_border_3d(bottom_blob, top_blob, top, bottom, left, 0, front, behind, type, value, opt);
+    }
+    else if (top > 0 || bottom > 0 || front > 0 || behind > 0)
+    {
+        copy_make_border_3d(bottom_blob, top_blob, top, bottom, 0, 0, front, behind, type, value, opt);
+    }
+    else
+    {
+        top_blob = bottom_blob;
+    }
+    if (top_blob.empty())
+        return -100;
+
+    if (top_blobs.size() >= 2)
+    {
+        Mat& top_position = top_blobs[1];
+        top_position.create(1, 4u, opt.blob_allocator);
+        if (top_position.empty())
+            return -100;
+
+        top_position[0] = position + bottom_blob.w;
+    }
+
+    return 0;
+}
+
 } // namespace ncnn
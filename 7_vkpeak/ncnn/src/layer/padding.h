@@ -30,6 +30,8 @@ public:
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
 public:
     int top;
     int bottom;
@@ -43,6 +45,9 @@ public:
     // per channel pad value
     int per_channel_pad_data_size;
     Mat per_channel_pad_data;
+
+    // pad left only at the beginning of a stream and never pad right
+    int streaming;
 };
 
 } // namespace ncnn
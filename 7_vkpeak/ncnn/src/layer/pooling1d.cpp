@@ -15,6 +15,7 @@
 #include "pooling1d.h"
 
 #include "layer_type.h"
+#include "streaming_cache.h"
 
 #include <float.h>
 
@@ -38,6 +39,12 @@ int Pooling1D::load_param(const ParamDict& pd)
     avgpool_count_include_pad = pd.get(6, 0);
     adaptive_pooling = pd.get(7, 0);
     out_w = pd.get(8, 0);
+    streaming = pd.get(20, 0);
+
+    if (streaming)
+    {
+        one_blob_only = false;
+    }
 
     return 0;
 }
@@ -192,7 +199,7 @@ int Pooling1D::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
     }
     else if (pooling_type == PoolMethod_AVE)
     {
-        if (avgpool_count_include_pad == 0)
+        if (avgpool_count_include_pad == 0 && !streaming)
         {
             int wtailpad = 0;
 
@@ -262,12 +269,66 @@ int Pooling1D::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
     return 0;
 }
 
+int Pooling1D::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    // bottom_blobs = input frames, cache from the previous chunk (optional)
+    // top_blobs = output frames, cache for the next chunk (optional)
+    if (!streaming || global_pooling || adaptive_pooling)
+        return -1;
+
+    const Mat& bottom_blob = bottom_blobs[0];
+    const Mat cache = bottom_blobs.size() >= 2 ? bottom_blobs[1] : Mat();
+
+    float pad_value = 0.f;
+    if (pooling_type == PoolMethod_MAX)
+    {
+        pad_value = bottom_blob.elemsize == 1 ? -128.f : -FLT_MAX;
+    }
+
+    // pad_left frames stand in for the history of the first chunk
+    Mat bottom_blob_bordered;
+    int ret = streaming_concat(bottom_blob, cache, pad_left, pad_value, bottom_blob_bordered, opt);
+    if (ret != 0)
+        return ret;
+
+    const int outw = streaming_output_w(bottom_blob_bordered.w, kernel_w, stride_w);
+
+    // make_padding is a no-op in streaming mode
+    if (outw > 0)
+    {
+        ret = forward(bottom_blob_bordered, top_blobs[0], opt);
+        if (ret != 0)
+            return ret;
+
+        ret = streaming_trim_output(top_blobs[0], outw, opt);
+        if (ret != 0)
+            return ret;
+    }
+    else
+    {
+        // not enough frames for one output yet, everything goes to the cache
+        top_blobs[0].release();
+    }
+
+    if (top_blobs.size() >= 2)
+    {
+        ret = streaming_keep_tail(bottom_blob_bordered, outw * stride_w, top_blobs[1], opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 void Pooling1D::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered, const Option& opt) const
 {
     int w = bottom_blob.w;
 
     bottom_blob_bordered = bottom_blob;
 
+    if (streaming)
+        return;
+
     float pad_value = 0.f;
     if (pooling_type == PoolMethod_MAX)
     {
@@ -28,6 +28,8 @@ public:
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
     enum PoolMethod
     {
         PoolMethod_MAX = 0,
@@ -49,6 +51,10 @@ public:
     int avgpool_count_include_pad;
     int adaptive_pooling;
     int out_w;
+
+    // keep the trailing input frames in a cache blob and
+    // only compute the output frames of newly arrived input
+    int streaming;
 };
 
 } // namespace ncnn
@@ -27,6 +27,7 @@ Quantize::Quantize()
 int Quantize::load_param(const ParamDict& pd)
 {
     scale_data_size = pd.get(0, 1);
+    zero_point = pd.get(1, 0);
 
     return 0;
 }
@@ -70,7 +71,7 @@ int Quantize::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
             #pragma omp parallel for num_threads(opt.num_threads)
             for (int i = 0; i < w; i++)
             {
-                outptr[i] = float2int8(ptr[i] * scale);
+                outptr[i] = float2int8(ptr[i] * scale + zero_point);
             }
         }
         else
@@ -78,7 +79,7 @@ int Quantize::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
             #pragma omp parallel for num_threads(opt.num_threads)
             for (int i = 0; i < w; i++)
             {
-                outptr[i] = float2int8(ptr[i] * scale_data[i]);
+                outptr[i] = float2int8(ptr[i] * scale_data[i] + zero_point);
             }
         }
     }
@@ -102,7 +103,7 @@ int Quantize::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
 
             for (int j = 0; j < w; j++)
             {
-                outptr0[j] = float2int8(ptr0[j] * scale);
+                outptr0[j] = float2int8(ptr0[j] * scale + zero_point);
             }
         }
     }
@@ -128,7 +129,7 @@ int Quantize::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
 
             for (int i = 0; i < size; i++)
             {
-                outptr[i] = float2int8(ptr[i] * scale);
+                outptr[i] = float2int8(ptr[i] * scale + zero_point);
             }
         }
     }
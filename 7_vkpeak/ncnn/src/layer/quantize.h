@@ -33,6 +33,9 @@ public:
 public:
     int scale_data_size;
     Mat scale_data;
+
+    // asymmetric quantization, added after scaling
+    int zero_point;
 };
 
 } // namespace ncnn
@@ -0,0 +1,150 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef LAYER_STREAMING_CACHE_H
+#define LAYER_STREAMING_CACHE_H
+
+#include "mat.h"
+
+#include <algorithm>
+#include <string.h>
+
+// frame cache helpers for the streaming mode of the 1d sliding window layers
+// the input is a 2d blob of w frames by h channels, the cache holds the trailing
+// frames of the previous chunk that the next output frames still need
+// a cache without shape (dims == 0) starts a new stream, while a cache with
+// shape but zero frames continues a stream that has nothing pending
+
+namespace ncnn {
+
+// prepend the cached frames to the newly arrived ones
+// a new stream starts with initial_frames frames of pad_value instead
+static int streaming_concat(const Mat& bottom_blob, const Mat& cache, int initial_frames, float pad_value, Mat& bottom_blob_bordered, const Option& opt)
+{
+    Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+
+    bottom_blob_bordered = bottom_blob;
+
+    if (cache.dims == 0)
+    {
+        if (initial_frames > 0)
+        {
+            copy_make_border(bottom_blob, bottom_blob_bordered, 0, 0, initial_frames, 0, BORDER_CONSTANT, pad_value, opt_b);
+            if (bottom_blob_bordered.empty())
+                return -100;
+        }
+
+        return 0;
+    }
+
+    if (cache.w == 0)
+        return 0;
+
+    Mat cache_packed = cache;
+    if (cache.elempack != bottom_blob.elempack)
+    {
+        convert_packing(cache, cache_packed, bottom_blob.elempack, opt_b);
+        if (cache_packed.empty())
+            return -100;
+    }
+
+    if (cache_packed.h != bottom_blob.h || cache_packed.elemsize != bottom_blob.elemsize)
+        return -1;
+
+    const int cache_w = cache_packed.w;
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const size_t elemsize = bottom_blob.elemsize;
+
+    bottom_blob_bordered.create(cache_w + w, h, elemsize, bottom_blob.elempack, opt.workspace_allocator);
+    if (bottom_blob_bordered.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int i = 0; i < h; i++)
+    {
+        unsigned char* outptr = bottom_blob_bordered.row<unsigned char>(i);
+
+        memcpy(outptr, cache_packed.row<const unsigned char>(i), cache_w * elemsize);
+        memcpy(outptr + cache_w * elemsize, bottom_blob.row<const unsigned char>(i), w * elemsize);
+    }
+
+    return 0;
+}
+
+// output frames to emit over w buffered frames
+// an output is deferred to the next chunk until the window after it starts within the buffer,
+// so the next cache never has to skip frames that have not arrived yet when stride > kernel_extent
+static inline int streaming_output_w(int w, int kernel_extent, int stride)
+{
+    return w < kernel_extent ? 0 : std::min((w - kernel_extent) / stride + 1, w / stride);
+}
+
+// drop the deferred output frame the full window computation produced
+static int streaming_trim_output(Mat& top_blob, int outw, const Option& opt)
+{
+    if (top_blob.w == outw)
+        return 0;
+
+    // copied row by row, as copy_cut_border would unpack a packed top_blob
+    const int h = top_blob.h;
+    const size_t elemsize = top_blob.elemsize;
+
+    Mat top_blob_trimmed;
+    top_blob_trimmed.create(outw, h, elemsize, top_blob.elempack, opt.blob_allocator);
+    if (top_blob_trimmed.empty())
+        return -100;
+
+    for (int i = 0; i < h; i++)
+    {
+        memcpy(top_blob_trimmed.row<unsigned char>(i), top_blob.row<const unsigned char>(i), outw * elemsize);
+    }
+
+    top_blob = top_blob_trimmed;
+
+    return 0;
+}
+
+// keep the frames from consumed onwards as the cache for the next chunk
+static int streaming_keep_tail(const Mat& bottom_blob_bordered, int consumed, Mat& cache, const Option& opt)
+{
+    const int cache_w = bottom_blob_bordered.w - consumed;
+    const int h = bottom_blob_bordered.h;
+    const size_t elemsize = bottom_blob_bordered.elemsize;
+
+    if (cache_w == 0)
+    {
+        // keep the shape so that the next chunk continues the stream,
+        // unpacked so that nothing tries to repack a blob without data
+        const int elempack = bottom_blob_bordered.elempack;
+        cache.create(0, h * elempack, elemsize / elempack, 1, opt.blob_allocator);
+        return 0;
+    }
+
+    cache.create(cache_w, h, elemsize, bottom_blob_bordered.elempack, opt.blob_allocator);
+    if (cache.empty())
+        return -100;
+
+    for (int i = 0; i < h; i++)
+    {
+        memcpy(cache.row<unsigned char>(i), bottom_blob_bordered.row<const unsigned char>(i) + consumed * elemsize, cache_w * elemsize);
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
+
+#endif // LAYER_STREAMING_CACHE_H
@@ -0,0 +1,293 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "argmax_x86.h"
+
+#include <float.h>
+#include <functional>
+#include <math.h>
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#if __AVX512F__
+#include "avx512_mathfun.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+
+namespace ncnn {
+
+typedef std::pair<float, int> argmax_entry;
+
+// fold the softmax state (max2, sum2) into (max, sum), sum being relative to max
+static inline void softmax_state_merge(float& max, float& sum, float max2, float sum2)
+{
+    if (max2 > max)
+    {
+        sum = sum * expf(max - max2) + sum2;
+        max = max2;
+    }
+    else
+    {
+        sum += sum2 * expf(max2 - max);
+    }
+}
+
+#if __SSE2__
+static void softmax_state_merge_lanes(float& max, float& sum, const float* lane_max, const float* lane_sum, int lanes)
+{
+    for (int j = 0; j < lanes; j++)
+    {
+        softmax_state_merge(max, sum, lane_max[j], lane_sum[j]);
+    }
+}
+#endif // __SSE2__
+
+// keep the value if it ranks into the topk heap
+// the heap top is the smallest entry, the incoming index is always larger than
+// any index in the heap, so an equal value ranks higher just like in ArgMax
+static inline void topk_heap_push(std::vector<argmax_entry>& heap, float v, int index, float& threshold)
+{
+    if (v < threshold)
+        return;
+
+    std::pop_heap(heap.begin(), heap.end(), std::greater<argmax_entry>());
+    heap.back() = argmax_entry(v, index);
+    std::push_heap(heap.begin(), heap.end(), std::greater<argmax_entry>());
+
+    threshold = heap.front().first;
+}
+
+// single pass over ptr[begin, end)
+// tracks the running max and the sum of exp(x - max) while keeping the topk entries in a min-heap,
+// a whole vector is dropped with one compare unless some lane reaches the smallest kept value
+static void argmax_softmax_segment(const float* ptr, int begin, int end, int topk, bool with_softmax, std::vector<argmax_entry>& heap, float& max, float& sum)
+{
+    max = -FLT_MAX;
+    sum = 0.f;
+
+    heap.clear();
+
+    int i = begin;
+    for (; i < end && (int)heap.size() < topk; i++)
+    {
+        if (with_softmax)
+            softmax_state_merge(max, sum, ptr[i], 1.f);
+
+        heap.push_back(argmax_entry(ptr[i], i));
+        std::push_heap(heap.begin(), heap.end(), std::greater<argmax_entry>());
+    }
+
+    if (heap.empty())
+        return;
+
+    float threshold = heap.front().first;
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (i + 15 < end)
+    {
+        __m512 _max = _mm512_set1_ps(-FLT_MAX);
+        __m512 _sum = _mm512_setzero_ps();
+        for (; i + 15 < end; i += 16)
+        {
+            __m512 _p = _mm512_loadu_ps(ptr + i);
+
+            if (with_softmax)
+            {
+                if (_mm512_cmp_ps_mask(_p, _max, _CMP_GT_OQ))
+                {
+                    __m512 _max_new = _mm512_max_ps(_max, _p);
+                    _sum = _mm512_mul_ps(_sum, exp512_ps(_mm512_sub_ps(_max, _max_new)));
+                    _max = _max_new;
+                }
+                _sum = _mm512_add_ps(_sum, exp512_ps(_mm512_sub_ps(_p, _max)));
+            }
+
+            if (_mm512_cmp_ps_mask(_p, _mm512_set1_ps(threshold), _CMP_GE_OQ))
+            {
+                float tmp[16];
+                _mm512_storeu_ps(tmp, _p);
+                for (int j = 0; j < 16; j++)
+                {
+                    topk_heap_push(heap, tmp[j], i + j, threshold);
+                }
+            }
+        }
+
+        float lane_max[16];
+        float lane_sum[16];
+        _mm512_storeu_ps(lane_max, _max);
+        _mm512_storeu_ps(lane_sum, _sum);
+        softmax_state_merge_lanes(max, sum, lane_max, lane_sum, 16);
+    }
+#endif // __AVX512F__
+    if (i + 7 < end)
+    {
+        __m256 _max = _mm256_set1_ps(-FLT_MAX);
+        __m256 _sum = _mm256_setzero_ps();
+        for (; i + 7 < end; i += 8)
+        {
+            __m256 _p = _mm256_loadu_ps(ptr + i);
+
+            if (with_softmax)
+            {
+                if (_mm256_movemask_ps(_mm256_cmp_ps(_p, _max, _CMP_GT_OQ)))
+                {
+                    __m256 _max_new = _mm256_max_ps(_max, _p);
+                    _sum = _mm256_mul_ps(_sum, exp256_ps(_mm256_sub_ps(_max, _max_new)));
+                    _max = _max_new;
+                }
+                _sum = _mm256_add_ps(_sum, exp256_ps(_mm256_sub_ps(_p, _max)));
+            }
+
+            if (_mm256_movemask_ps(_mm256_cmp_ps(_p, _mm256_set1_ps(threshold), _CMP_GE_OQ)))
+            {
+                float tmp[8];
+                _mm256_storeu_ps(tmp, _p);
+                for (int j = 0; j < 8; j++)
+                {
+                    topk_heap_push(heap, tmp[j], i + j, threshold);
+                }
+            }
+        }
+
+        float lane_max[8];
+        float lane_sum[8];
+        _mm256_storeu_ps(lane_max, _max);
+        _mm256_storeu_ps(lane_sum, _sum);
+        softmax_state_merge_lanes(max, sum, lane_max, lane_sum, 8);
+    }
+#endif // __AVX__
+    if (i + 3 < end)
+    {
+        __m128 _max = _mm_set1_ps(-FLT_MAX);
+        __m128 _sum = _mm_setzero_ps();
+        for (; i + 3 < end; i += 4)
+        {
+            __m128 _p = _mm_loadu_ps(ptr + i);
+
+            if (with_softmax)
+            {
+                if (_mm_movemask_ps(_mm_cmpgt_ps(_p, _max)))
+                {
+                    __m128 _max_new = _mm_max_ps(_max, _p);
+                    _sum = _mm_mul_ps(_sum, exp_ps(_mm_sub_ps(_max, _max_new)));
+                    _max = _max_new;
+                }
+                _sum = _mm_add_ps(_sum, exp_ps(_mm_sub_ps(_p, _max)));
+            }
+
+            if (_mm_movemask_ps(_mm_cmpge_ps(_p, _mm_set1_ps(threshold))))
+            {
+                float tmp[4];
+                _mm_storeu_ps(tmp, _p);
+                for (int j = 0; j < 4; j++)
+                {
+                    topk_heap_push(heap, tmp[j], i + j, threshold);
+                }
+            }
+        }
+
+        float lane_max[4];
+        float lane_sum[4];
+        _mm_storeu_ps(lane_max, _max);
+        _mm_storeu_ps(lane_sum, _sum);
+        softmax_state_merge_lanes(max, sum, lane_max, lane_sum, 4);
+    }
+#endif // __SSE2__
+    for (; i < end; i++)
+    {
+        if (with_softmax)
+            softmax_state_merge(max, sum, ptr[i], 1.f);
+
+        topk_heap_push(heap, ptr[i], i, threshold);
+    }
+}
+
+int ArgMax_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int size = bottom_blob.total();
+
+    const int k = std::min(topk, size);
+
+    if (out_max_val)
+        top_blob.create(k, 2, 4u, opt.blob_allocator);
+    else
+        top_blob.create(k, 1, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const float* ptr = bottom_blob;
+
+    const bool with_softmax = out_max_val && softmax;
+
+    // split large inputs into one segment per thread and merge the partial results,
+    // small ones are not worth the thread wake-up
+    const int segment_size_min = 16384;
+    const int segment_count = std::max(1, std::min(opt.num_threads, size / segment_size_min));
+    const int segment_size = (size + segment_count - 1) / segment_count;
+
+    std::vector<std::vector<argmax_entry> > heaps(segment_count);
+    std::vector<float> maxs(segment_count);
+    std::vector<float> sums(segment_count);
+
+    #pragma omp parallel for num_threads(segment_count)
+    for (int t = 0; t < segment_count; t++)
+    {
+        const int begin = t * segment_size;
+        const int end = std::min(begin + segment_size, size);
+
+        argmax_softmax_segment(ptr, begin, end, k, with_softmax, heaps[t], maxs[t], sums[t]);
+    }
+
+    std::vector<argmax_entry> vec = heaps[0];
+    float max = maxs[0];
+    float sum = sums[0];
+    for (int t = 1; t < segment_count; t++)
+    {
+        vec.insert(vec.end(), heaps[t].begin(), heaps[t].end());
+        softmax_state_merge(max, sum, maxs[t], sums[t]);
+    }
+
+    std::partial_sort(vec.begin(), vec.begin() + k, vec.end(),
+                      std::greater<argmax_entry>());
+
+    float* outptr = top_blob;
+    if (out_max_val)
+    {
+        float* valptr = outptr + k;
+        for (int i = 0; i < k; i++)
+        {
+            outptr[i] = with_softmax ? expf(vec[i].first - max) / sum : vec[i].first;
+            valptr[i] = vec[i].second;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < k; i++)
+        {
+            outptr[i] = vec[i].second;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,364 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "convolution3d_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif
+#endif // __SSE2__
+#include "x86_usability.h"
+
+#include "fused_activation.h"
+#include "weightcache.h"
+
+namespace ncnn {
+
+#include "convolution_sgemm.h"
+
+#if __SSE2__
+#include "convolution_sgemm_pack4.h"
+#include "convolution_sgemm_pack1to4.h"
+#include "convolution_sgemm_pack4to1.h"
+
+#if __AVX__
+#include "convolution_sgemm_pack8.h"
+#include "convolution_sgemm_pack4to8.h"
+#include "convolution_sgemm_pack1to8.h"
+#include "convolution_sgemm_pack8to4.h"
+#include "convolution_sgemm_pack8to1.h"
+
+#if __AVX512F__
+#include "convolution_sgemm_pack16.h"
+#include "convolution_sgemm_pack8to16.h"
+#include "convolution_sgemm_pack4to16.h"
+#include "convolution_sgemm_pack1to16.h"
+#include "convolution_sgemm_pack16to8.h"
+#include "convolution_sgemm_pack16to4.h"
+#include "convolution_sgemm_pack16to1.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+
+Convolution3D_x86::Convolution3D_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+
+    activation = 0;
+}
+
+// gather the input volume into the layout expected by im2col_sgemm_*
+// bottom_im2col = (outw * outh * tile_d, maxk, inch/elempack), taps ordered as kd-kh-kw
+static void convolution3d_im2col(const Mat& bottom_blob, Mat& bottom_im2col, int z0, int tile_d, int outw, int outh, int kernel_w, int kernel_h, int kernel_d, int dilation_w, int dilation_h, int dilation_d, int stride_w, int stride_h, int stride_d, const Option& opt)
+{
+    const int w = bottom_blob.w;
+    const int inch = bottom_blob.c;
+    const int elempack = bottom_blob.elempack;
+
+    const int gap = (w * stride_h - outw * stride_w) * elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < inch; p++)
+    {
+        const Mat img = bottom_blob.channel(p);
+        float* ptr = bottom_im2col.channel(p);
+
+        for (int r = 0; r < kernel_d; r++)
+        {
+            for (int u = 0; u < kernel_h; u++)
+            {
+                for (int v = 0; v < kernel_w; v++)
+                {
+                    for (int z = 0; z < tile_d; z++)
+                    {
+                        const float* sptr = img.depth((z0 + z) * stride_d + dilation_d * r).row(dilation_h * u) + dilation_w * v * elempack;
+
+                        for (int i = 0; i < outh; i++)
+                        {
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+                            if (elempack == 16)
+                            {
+                                for (int j = 0; j < outw; j++)
+                                {
+                                    _mm512_store_ps(ptr, _mm512_load_ps(sptr));
+
+                                    sptr += stride_w * 16;
+                                    ptr += 16;
+                                }
+                            }
+#endif // __AVX512F__
+                            if (elempack == 8)
+                            {
+                                for (int j = 0; j < outw; j++)
+                                {
+                                    _mm256_store_ps(ptr, _mm256_load_ps(sptr));
+
+                                    sptr += stride_w * 8;
+                                    ptr += 8;
+                                }
+                            }
+#endif // __AVX__
+                            if (elempack == 4)
+                            {
+                                for (int j = 0; j < outw; j++)
+                                {
+                                    _mm_store_ps(ptr, _mm_load_ps(sptr));
+
+                                    sptr += stride_w * 4;
+                                    ptr += 4;
+                                }
+                            }
+#endif // __SSE2__
+                            if (elempack == 1)
+                            {
+                                for (int j = 0; j < outw; j++)
+                                {
+                                    ptr[0] = sptr[0];
+
+                                    sptr += stride_w;
+                                    ptr += 1;
+                                }
+                            }
+
+                            sptr += gap;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+int Convolution3D_x86::create_pipeline(const Option& opt)
+{
+    activation = create_activation_layer(activation_type, activation_params, opt);
+
+    const int maxk = kernel_w * kernel_h * kernel_d;
+    const int num_input = weight_data_size / maxk / num_output;
+
+    int elempack = 1;
+    int out_elempack = 1;
+
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        elempack = num_input % 16 == 0 ? 16 : num_input % 8 == 0 ? 8 : num_input % 4 == 0 ? 4 : 1;
+        out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        elempack = num_input % 8 == 0 ? 8 : num_input % 4 == 0 ? 4 : 1;
+        out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#else
+        elempack = num_input % 4 == 0 ? 4 : 1;
+        out_elempack = num_output % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+
+    // the 2d sgemm kernel transforms only see maxk, so hand them the flattened 3d window
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16 && out_elempack == 16)
+        convolution_im2col_sgemm_transform_kernel_pack16_avx512(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 8 && out_elempack == 16)
+        convolution_im2col_sgemm_transform_kernel_pack8to16_avx512(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 4 && out_elempack == 16)
+        convolution_im2col_sgemm_transform_kernel_pack4to16_avx512(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 1 && out_elempack == 16)
+        convolution_im2col_sgemm_transform_kernel_pack1to16_avx512(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 16 && out_elempack == 8)
+        convolution_im2col_sgemm_transform_kernel_pack16to8_avx512(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 16 && out_elempack == 4)
+        convolution_im2col_sgemm_transform_kernel_pack16to4_avx512(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 16 && out_elempack == 1)
+        convolution_im2col_sgemm_transform_kernel_pack16to1_avx512(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+#endif // __AVX512F__
+    if (elempack == 8 && out_elempack == 8)
+        convolution_im2col_sgemm_transform_kernel_pack8_avx(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 4 && out_elempack == 8)
+        convolution_im2col_sgemm_transform_kernel_pack4to8_avx(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 1 && out_elempack == 8)
+        convolution_im2col_sgemm_transform_kernel_pack1to8_avx(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 8 && out_elempack == 4)
+        convolution_im2col_sgemm_transform_kernel_pack8to4_avx(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 8 && out_elempack == 1)
+        convolution_im2col_sgemm_transform_kernel_pack8to1_avx(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+#endif // __AVX__
+    if (elempack == 4 && out_elempack == 4)
+        convolution_im2col_sgemm_transform_kernel_pack4_sse(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 1 && out_elempack == 4)
+        convolution_im2col_sgemm_transform_kernel_pack1to4_sse(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+    if (elempack == 4 && out_elempack == 1)
+        convolution_im2col_sgemm_transform_kernel_pack4to1_sse(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+#endif // __SSE2__
+    if (elempack == 1 && out_elempack == 1)
+        convolution_im2col_sgemm_transform_kernel_sse(weight_data, weight_sgemm_data, num_input, num_output, maxk, 1);
+
+    if (opt.weight_cache)
+    {
+        weight_sgemm_data = opt.weight_cache->share(weight_sgemm_data);
+    }
+
+    if (opt.lightmode)
+    {
+        weight_data.release();
+    }
+
+    return 0;
+}
+
+int Convolution3D_x86::destroy_pipeline(const Option& opt)
+{
+    if (activation)
+    {
+        activation->destroy_pipeline(opt);
+        delete activation;
+        activation = 0;
+    }
+
+    return 0;
+}
+
+int Convolution3D_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int d = bottom_blob.d;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+    int elempack = bottom_blob.elempack;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+    const int kernel_extent_d = dilation_d * (kernel_d - 1) + 1;
+
+    Mat bottom_blob_bordered;
+    make_padding(bottom_blob, bottom_blob_bordered, opt);
+    if (bottom_blob_bordered.empty())
+        return -100;
+
+    w = bottom_blob_bordered.w;
+    h = bottom_blob_bordered.h;
+    d = bottom_blob_bordered.d;
+
+    const int outw = (w - kernel_extent_w) / stride_w + 1;
+    const int outh = (h - kernel_extent_h) / stride_h + 1;
+    const int outd = (d - kernel_extent_d) / stride_d + 1;
+
+    int out_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#else
+        out_elempack = num_output % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+    size_t out_elemsize = elemsize / elempack * out_elempack;
+
+    top_blob.create(outw, outh, outd, num_output / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const int maxk = kernel_w * kernel_h * kernel_d;
+    const int num_input = channels * elempack;
+
+    // process the output in slabs of whole depth slices so that the im2col buffer
+    // and the sgemm repack stay within a fixed workspace budget
+    const size_t im2col_budget = 16 * 1024 * 1024;
+    const size_t im2col_slice_bytes = (size_t)outw * outh * maxk * num_input * 4u;
+    int tile_d = im2col_slice_bytes >= im2col_budget ? 1 : (int)(im2col_budget / im2col_slice_bytes);
+    tile_d = std::min(tile_d, outd);
+
+    // every slab of top_blob starts as aligned as its channels for the aligned simd store
+    while (tile_d < outd && (size_t)tile_d * outw * outh * out_elemsize % 16 != 0)
+    {
+        tile_d++;
+    }
+
+    for (int z0 = 0; z0 < outd; z0 += tile_d)
+    {
+        const int tile_dd = std::min(tile_d, outd - z0);
+        const int size = outw * outh * tile_dd;
+
+        Mat bottom_im2col(size, maxk, channels, elemsize, elempack, opt.workspace_allocator);
+        if (bottom_im2col.empty())
+            return -100;
+
+        convolution3d_im2col(bottom_blob_bordered, bottom_im2col, z0, tile_dd, outw, outh, kernel_w, kernel_h, kernel_d, dilation_w, dilation_h, dilation_d, stride_w, stride_h, stride_d, opt);
+
+        // view the output depth slab as a 2d blob sharing the channel stride of top_blob
+        Mat top_tile(size, 1, top_blob.c, top_blob.channel(0).depth(z0).data, out_elemsize, out_elempack);
+        top_tile.cstep = top_blob.cstep;
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+        if (elempack == 16 && out_elempack == 16)
+            im2col_sgemm_pack16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 8 && out_elempack == 16)
+            im2col_sgemm_pack8to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 4 && out_elempack == 16)
+            im2col_sgemm_pack4to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 1 && out_elempack == 16)
+            im2col_sgemm_pack1to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 16 && out_elempack == 8)
+            im2col_sgemm_pack16to8_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 16 && out_elempack == 4)
+            im2col_sgemm_pack16to4_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 16 && out_elempack == 1)
+            im2col_sgemm_pack16to1_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __AVX512F__
+        if (elempack == 8 && out_elempack == 8)
+            im2col_sgemm_pack8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 4 && out_elempack == 8)
+            im2col_sgemm_pack4to8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 1 && out_elempack == 8)
+            im2col_sgemm_pack1to8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 8 && out_elempack == 4)
+            im2col_sgemm_pack8to4_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 8 && out_elempack == 1)
+            im2col_sgemm_pack8to1_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __AVX__
+        if (elempack == 4 && out_elempack == 4)
+            im2col_sgemm_pack4_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 1 && out_elempack == 4)
+            im2col_sgemm_pack1to4_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 4 && out_elempack == 1)
+            im2col_sgemm_pack4to1_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __SSE2__
+        if (elempack == 1 && out_elempack == 1)
+            im2col_sgemm_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+    }
+
+    if (activation)
+    {
+        activation->forward_inplace(top_blob, opt);
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -514,10 +514,28 @@ static void conv3x3s1_winograd23_int8_sse(const Mat& bottom_blob, Mat& top_blob,
     copy_cut_border(top_blob_bordered, top_blob, 0, top_blob_bordered.h - top_blob.h, 0, top_blob_bordered.w - top_blob.w, opt);
 }
 
+#if __SSE2__
+#if !(__AVX512VNNI__ || __AVXVNNI__ || __AVX2__ || __XOP__)
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+void conv3x3s1_winograd43_int8_sse_avx512vnni(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX2__ && !__AVXVNNI__
+void conv3x3s1_winograd43_int8_sse_avxvnni(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__
+void conv3x3s1_winograd43_int8_sse_avx2(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_XOP && __SSE2__ && !__XOP__
+void conv3x3s1_winograd43_int8_sse_xop(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel, const Option& opt);
+#endif
+#endif
+#endif // __SSE2__
+
 static void conv3x3s1_winograd43_transform_kernel_int8_sse(const Mat& kernel, Mat& kernel_tm, int inch, int outch, const Option& opt)
 {
-    kernel_tm.create(6 * 6, inch, outch, (size_t)2u);
-
     // G
     // const float ktm[6][3] = {
     //     {  1.0f/4,     0.0f,    0.0f},
@@ -527,22 +545,40 @@ static void conv3x3s1_winograd43_transform_kernel_int8_sse(const Mat& kernel, Ma
     //     { 1.0f/24, -1.0f/12,  1.0f/6},
     //     {    0.0f,     0.0f,    1.0f}
     // };
+    // rows scaled by 24 except the last one scaled by 6 so that U fits in int16,
+    // the output transform multiplies the last row and column back by 4
     const short ktm[6][3] = {
         {6, 0, 0},
         {-4, -4, -4},
         {-4, 4, -4},
         {1, 2, 4},
         {1, -2, 4},
-        {0, 0, 24}
+        {0, 0, 6}
     };
 
+    // interleave input channel pairs so that the dot is a pmaddwd over two channels
+    // dst = 2a-36-inch/2a-outch
+    const int inch2 = (inch + 1) / 2;
+
+    kernel_tm.create(36 * 2, inch2, outch, (size_t)2u);
+
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int p = 0; p < outch; p++)
     {
-        for (int q = 0; q < inch; q++)
+        for (int q = 0; q < inch2 * 2; q++)
         {
+            short* kernel_tm0 = kernel_tm.channel(p).row<short>(q / 2) + q % 2;
+
+            if (q >= inch)
+            {
+                for (int n = 0; n < 36; n++)
+                {
+                    kernel_tm0[n * 2] = 0;
+                }
+                continue;
+            }
+
             const signed char* kernel0 = (const signed char*)kernel + p * inch * 9 + q * 9;
-            short* kernel_tm0 = kernel_tm.channel(p).row<short>(q);
 
             // transform kernel
             const signed char* k0 = kernel0;
@@ -565,7 +601,7 @@ static void conv3x3s1_winograd43_transform_kernel_int8_sse(const Mat& kernel, Ma
 
                 for (int i = 0; i < 6; i++)
                 {
-                    kernel_tm0[j * 6 + i] = tmpp[0] * ktm[i][0] + tmpp[1] * ktm[i][1] + tmpp[2] * ktm[i][2];
+                    kernel_tm0[(j * 6 + i) * 2] = tmpp[0] * ktm[i][0] + tmpp[1] * ktm[i][1] + tmpp[2] * ktm[i][2];
                 }
             }
         }
@@ -574,6 +610,42 @@ static void conv3x3s1_winograd43_transform_kernel_int8_sse(const Mat& kernel, Ma
 
 static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_tm, const Option& opt)
 {
+#if __SSE2__
+#if !(__AVX512VNNI__ || __AVXVNNI__ || __AVX2__ || __XOP__)
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx512_vnni())
+    {
+        conv3x3s1_winograd43_int8_sse_avx512vnni(bottom_blob, top_blob, kernel_tm, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX2__ && !__AVXVNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        conv3x3s1_winograd43_int8_sse_avxvnni(bottom_blob, top_blob, kernel_tm, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        conv3x3s1_winograd43_int8_sse_avx2(bottom_blob, top_blob, kernel_tm, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_XOP && __SSE2__ && !__XOP__
+    if (ncnn::cpu_support_x86_xop())
+    {
+        conv3x3s1_winograd43_int8_sse_xop(bottom_blob, top_blob, kernel_tm, opt);
+        return;
+    }
+#endif
+#endif
+#endif // __SSE2__
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     int inch = bottom_blob.c;
@@ -582,6 +654,8 @@ static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob,
     int outh = top_blob.h;
     int outch = top_blob.c;
 
+    const int inch2 = (inch + 1) / 2;
+
     // pad to 4n+2, winograd F(4,3)
     Mat bottom_blob_bordered = bottom_blob;
 
@@ -605,7 +679,8 @@ static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob,
 
         const int tiles = nColBlocks * nRowBlocks;
 
-        bottom_blob_tm.create(6 * 6, tiles, inch, 2u, opt.workspace_allocator);
+        // input channel pairs interleaved like the kernel
+        bottom_blob_tm.create(6 * 6 * 2, tiles, inch2, 2u, opt.workspace_allocator);
 
         // BT
         // const float itm[4][4] = {
@@ -625,114 +700,72 @@ static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob,
         // 5 =	4 * r01 - 5 * r03 + r05
 
         #pragma omp parallel for num_threads(opt.num_threads)
-        for (int q = 0; q < inch; q++)
+        for (int qq = 0; qq < inch2; qq++)
         {
-            const signed char* img = bottom_blob_bordered.channel(q);
-            short* out_tm0 = bottom_blob_tm.channel(q);
-
-            for (int j = 0; j < nColBlocks; j++)
+            for (int c = 0; c < 2; c++)
             {
-                const signed char* r0 = img + w * j * 4;
-                const signed char* r1 = r0 + w;
-                const signed char* r2 = r1 + w;
-                const signed char* r3 = r2 + w;
-                const signed char* r4 = r3 + w;
-                const signed char* r5 = r4 + w;
+                const int q = qq * 2 + c;
 
-                for (int i = 0; i < nRowBlocks; i++)
-                {
-                    short d0[6], d1[6], d2[6], d3[6], d4[6], d5[6];
-                    short w0[6], w1[6], w2[6], w3[6], w4[6], w5[6];
-                    short t0[6], t1[6], t2[6], t3[6], t4[6], t5[6];
+                short* out_tm0 = (short*)bottom_blob_tm.channel(qq) + c;
 
-                    // load
-                    for (int n = 0; n < 6; n++)
-                    {
-                        d0[n] = r0[n];
-                        d1[n] = r1[n];
-                        d2[n] = r2[n];
-                        d3[n] = r3[n];
-                        d4[n] = r4[n];
-                        d5[n] = r5[n];
-                    }
-                    // w = B_t * d
-                    for (int n = 0; n < 6; n++)
-                    {
-                        w0[n] = 4 * d0[n] - 5 * d2[n] + d4[n];
-                        w1[n] = -4 * d1[n] - 4 * d2[n] + d3[n] + d4[n];
-                        w2[n] = 4 * d1[n] - 4 * d2[n] - d3[n] + d4[n];
-                        w3[n] = -2 * d1[n] - d2[n] + 2 * d3[n] + d4[n];
-                        w4[n] = 2 * d1[n] - d2[n] - 2 * d3[n] + d4[n];
-                        w5[n] = 4 * d1[n] - 5 * d3[n] + d5[n];
-                    }
-                    // transpose d to d_t
-                    {
-                        t0[0] = w0[0];
-                        t1[0] = w0[1];
-                        t2[0] = w0[2];
-                        t3[0] = w0[3];
-                        t4[0] = w0[4];
-                        t5[0] = w0[5];
-                        t0[1] = w1[0];
-                        t1[1] = w1[1];
-                        t2[1] = w1[2];
-                        t3[1] = w1[3];
-                        t4[1] = w1[4];
-                        t5[1] = w1[5];
-                        t0[2] = w2[0];
-                        t1[2] = w2[1];
-                        t2[2] = w2[2];
-                        t3[2] = w2[3];
-                        t4[2] = w2[4];
-                        t5[2] = w2[5];
-                        t0[3] = w3[0];
-                        t1[3] = w3[1];
-                        t2[3] = w3[2];
-                        t3[3] = w3[3];
-                        t4[3] = w3[4];
-                        t5[3] = w3[5];
-                        t0[4] = w4[0];
-                        t1[4] = w4[1];
-                        t2[4] = w4[2];
-                        t3[4] = w4[3];
-                        t4[4] = w4[4];
-                        t5[4] = w4[5];
-                        t0[5] = w5[0];
-                        t1[5] = w5[1];
-                        t2[5] = w5[2];
-                        t3[5] = w5[3];
-                        t4[5] = w5[4];
-                        t5[5] = w5[5];
-                    }
-                    // d = B_t * d_t
-                    for (int n = 0; n < 6; n++)
-                    {
-                        d0[n] = 4 * t0[n] - 5 * t2[n] + t4[n];
-                        d1[n] = -4 * t1[n] - 4 * t2[n] + t3[n] + t4[n];
-                        d2[n] = 4 * t1[n] - 4 * t2[n] - t3[n] + t4[n];
-                        d3[n] = -2 * t1[n] - t2[n] + 2 * t3[n] + t4[n];
-                        d4[n] = 2 * t1[n] - t2[n] - 2 * t3[n] + t4[n];
-                        d5[n] = 4 * t1[n] - 5 * t3[n] + t5[n];
-                    }
-                    // save to out_tm
-                    for (int n = 0; n < 6; n++)
+                if (q >= inch)
+                {
+                    for (int i = 0; i < tiles * 36; i++)
                     {
-                        out_tm0[n] = d0[n];
-                        out_tm0[n + 6] = d1[n];
-                        out_tm0[n + 12] = d2[n];
-                        out_tm0[n + 18] = d3[n];
-                        out_tm0[n + 24] = d4[n];
-                        out_tm0[n + 30] = d5[n];
+                        out_tm0[i * 2] = 0;
                     }
+                    continue;
+                }
 
-                    r0 += 4;
-                    r1 += 4;
-                    r2 += 4;
-                    r3 += 4;
-                    r4 += 4;
-                    r5 += 4;
+                const signed char* img = bottom_blob_bordered.channel(q);
 
-                    out_tm0 += 36;
+                for (int j = 0; j < nColBlocks; j++)
+                {
+                    const signed char* r0 = img + w * j * 4;
+                    const signed char* r1 = r0 + w;
+                    const signed char* r2 = r1 + w;
+                    const signed char* r3 = r2 + w;
+                    const signed char* r4 = r3 + w;
+                    const signed char* r5 = r4 + w;
+
+                    for (int i = 0; i < nRowBlocks; i++)
+                    {
+                        short w0[6], w1[6], w2[6], w3[6], w4[6], w5[6];
+
+                        // w = B_t * d
+                        for (int n = 0; n < 6; n++)
+                        {
+                            w0[n] = 4 * r0[n] - 5 * r2[n] + r4[n];
+                            w1[n] = -4 * r1[n] - 4 * r2[n] + r3[n] + r4[n];
+                            w2[n] = 4 * r1[n] - 4 * r2[n] - r3[n] + r4[n];
+                            w3[n] = -2 * r1[n] - r2[n] + 2 * r3[n] + r4[n];
+                            w4[n] = 2 * r1[n] - r2[n] - 2 * r3[n] + r4[n];
+                            w5[n] = 4 * r1[n] - 5 * r3[n] + r5[n];
+                        }
+
+                        // d = w * B, stored column major like the kernel
+                        short* wm[6] = {w0, w1, w2, w3, w4, w5};
+                        for (int m = 0; m < 6; m++)
+                        {
+                            const short* t = wm[m];
+
+                            out_tm0[(0 * 6 + m) * 2] = 4 * t[0] - 5 * t[2] + t[4];
+                            out_tm0[(1 * 6 + m) * 2] = -4 * t[1] - 4 * t[2] + t[3] + t[4];
+                            out_tm0[(2 * 6 + m) * 2] = 4 * t[1] - 4 * t[2] - t[3] + t[4];
+                            out_tm0[(3 * 6 + m) * 2] = -2 * t[1] - t[2] + 2 * t[3] + t[4];
+                            out_tm0[(4 * 6 + m) * 2] = 2 * t[1] - t[2] - 2 * t[3] + t[4];
+                            out_tm0[(5 * 6 + m) * 2] = 4 * t[1] - 5 * t[3] + t[5];
+                        }
+
+                        r0 += 4;
+                        r1 += 4;
+                        r2 += 4;
+                        r3 += 4;
+                        r4 += 4;
+                        r5 += 4;
+
+                        out_tm0 += 36 * 2;
+                    }
                 }
             }
         }
@@ -762,16 +795,90 @@ static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob,
             {
                 int* output0_tm = out0_tm.row<int>(i);
 
+#if __SSE2__
+#if __AVX2__
+                __m256i _sum0 = _mm256_setzero_si256();
+                __m256i _sum1 = _mm256_setzero_si256();
+                __m256i _sum2 = _mm256_setzero_si256();
+                __m256i _sum3 = _mm256_setzero_si256();
+                __m128i _sum4 = _mm_setzero_si128();
+
+                for (int qq = 0; qq < inch2; qq++)
+                {
+                    const short* r0 = bottom_blob_tm.channel(qq).row<const short>(i);
+                    const short* k0 = kernel0_tm.row<const short>(qq);
+
+                    __m256i _r0 = _mm256_loadu_si256((const __m256i*)r0);
+                    __m256i _r1 = _mm256_loadu_si256((const __m256i*)(r0 + 16));
+                    __m256i _r2 = _mm256_loadu_si256((const __m256i*)(r0 + 32));
+                    __m256i _r3 = _mm256_loadu_si256((const __m256i*)(r0 + 48));
+                    __m128i _r4 = _mm_loadu_si128((const __m128i*)(r0 + 64));
+
+                    __m256i _k0 = _mm256_loadu_si256((const __m256i*)k0);
+                    __m256i _k1 = _mm256_loadu_si256((const __m256i*)(k0 + 16));
+                    __m256i _k2 = _mm256_loadu_si256((const __m256i*)(k0 + 32));
+                    __m256i _k3 = _mm256_loadu_si256((const __m256i*)(k0 + 48));
+                    __m128i _k4 = _mm_loadu_si128((const __m128i*)(k0 + 64));
+
+#if __AVXVNNI__ || __AVX512VNNI__
+                    _sum0 = _mm256_dpwssd_epi32(_sum0, _r0, _k0);
+                    _sum1 = _mm256_dpwssd_epi32(_sum1, _r1, _k1);
+                    _sum2 = _mm256_dpwssd_epi32(_sum2, _r2, _k2);
+                    _sum3 = _mm256_dpwssd_epi32(_sum3, _r3, _k3);
+#else
+                    _sum0 = _mm256_add_epi32(_sum0, _mm256_madd_epi16(_r0, _k0));
+                    _sum1 = _mm256_add_epi32(_sum1, _mm256_madd_epi16(_r1, _k1));
+                    _sum2 = _mm256_add_epi32(_sum2, _mm256_madd_epi16(_r2, _k2));
+                    _sum3 = _mm256_add_epi32(_sum3, _mm256_madd_epi16(_r3, _k3));
+#endif
+                    _sum4 = _mm_add_epi32(_sum4, _mm_madd_epi16(_r4, _k4));
+                }
+
+                _mm256_storeu_si256((__m256i*)output0_tm, _sum0);
+                _mm256_storeu_si256((__m256i*)(output0_tm + 8), _sum1);
+                _mm256_storeu_si256((__m256i*)(output0_tm + 16), _sum2);
+                _mm256_storeu_si256((__m256i*)(output0_tm + 24), _sum3);
+                _mm_storeu_si128((__m128i*)(output0_tm + 32), _sum4);
+#else  // __AVX2__
+                __m128i _sum[9];
+                for (int n = 0; n < 9; n++)
+                {
+                    _sum[n] = _mm_setzero_si128();
+                }
+
+                for (int qq = 0; qq < inch2; qq++)
+                {
+                    const short* r0 = bottom_blob_tm.channel(qq).row<const short>(i);
+                    const short* k0 = kernel0_tm.row<const short>(qq);
+
+                    for (int n = 0; n < 9; n++)
+                    {
+                        __m128i _r0 = _mm_loadu_si128((const __m128i*)(r0 + n * 8));
+                        __m128i _k0 = _mm_loadu_si128((const __m128i*)(k0 + n * 8));
+#if __XOP__
+                        _sum[n] = _mm_maddd_epi16(_r0, _k0, _sum[n]);
+#else
+                        _sum[n] = _mm_add_epi32(_sum[n], _mm_madd_epi16(_r0, _k0));
+#endif
+                    }
+                }
+
+                for (int n = 0; n < 9; n++)
+                {
+                    _mm_storeu_si128((__m128i*)(output0_tm + n * 4), _sum[n]);
+                }
+#endif // __AVX2__
+#else  // __SSE2__
                 int sum0[36] = {0};
 
-                for (int q = 0; q < inch; q++)
+                for (int qq = 0; qq < inch2; qq++)
                 {
-                    const short* r0 = bottom_blob_tm.channel(q).row<short>(i);
-                    const short* k0 = kernel0_tm.row<short>(q);
+                    const short* r0 = bottom_blob_tm.channel(qq).row<const short>(i);
+                    const short* k0 = kernel0_tm.row<const short>(qq);
 
                     for (int n = 0; n < 36; n++)
                     {
-                        sum0[n] += (int)r0[n] * k0[n];
+                        sum0[n] += (int)r0[n * 2] * k0[n * 2] + (int)r0[n * 2 + 1] * k0[n * 2 + 1];
                     }
                 }
 
@@ -779,6 +886,7 @@ static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob,
                 {
                     output0_tm[n] = sum0[n];
                 }
+#endif // __SSE2__
             }
         }
     }
@@ -787,7 +895,14 @@ static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob,
 
     // BEGIN transform output
     Mat top_blob_bordered;
-    top_blob_bordered.create(outw, outh, outch, 4u, opt.workspace_allocator);
+    if (outw == top_blob.w && outh == top_blob.h)
+    {
+        top_blob_bordered = top_blob;
+    }
+    else
+    {
+        top_blob_bordered.create(outw, outh, outch, 4u, opt.workspace_allocator);
+    }
     {
         // AT
         // const float itm[4][6] = {
@@ -800,7 +915,7 @@ static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob,
         // 0 =	r00 + r01 + r02 + r03 +	r04
         // 1 =		  r01 - r02 + 2 * (r03 - r04)
         // 2 =		  r01 + r02 + 4 * (r03 + r04)
-        // 3 =		  r01 - r02 + 8 * (r03 - r04)  + r05
+        // 3 =		  r01 - r02 + 8 * (r03 - r04)  + r05 * 4
 
         int w_tm = outw / 4 * 6;
         int h_tm = outh / 4 * 6;
@@ -823,72 +938,35 @@ static void conv3x3s1_winograd43_int8_sse(const Mat& bottom_blob, Mat& top_blob,
 
                 for (int i = 0; i < nRowBlocks; i++)
                 {
-                    int* out_tile = out_tm.row<int>(j * nRowBlocks + i);
+                    const int* out_tile = out_tm.row<const int>(j * nRowBlocks + i);
 
-                    int s0[6], s1[6], s2[6], s3[6], s4[6], s5[6];
-                    int w0[6], w1[6], w2[6], w3[6];
-                    int d0[4], d1[4], d2[4], d3[4], d4[4], d5[4];
-                    int o0[4], o1[4], o2[4], o3[4];
-                    // load
-                    for (int n = 0; n < 6; n++)
-                    {
-                        s0[n] = out_tile[n];
-                        s1[n] = out_tile[n + 6];
-                        s2[n] = out_tile[n + 12];
-                        s3[n] = out_tile[n + 18];
-                        s4[n] = out_tile[n + 24];
-                        s5[n] = out_tile[n + 30];
-                    }
                     // w = A_T * W
+                    int w0[6], w1[6], w2[6], w3[6];
                     for (int n = 0; n < 6; n++)
                     {
-                        w0[n] = s0[n] + s1[n] + s2[n] + s3[n] + s4[n];
-                        w1[n] = s1[n] - s2[n] + 2 * s3[n] - 2 * s4[n];
-                        w2[n] = s1[n] + s2[n] + 4 * s3[n] + 4 * s4[n];
-                        w3[n] = s1[n] - s2[n] + 8 * s3[n] - 8 * s4[n] + s5[n];
+                        const int s0 = out_tile[n];
+                        const int s1 = out_tile[n + 6];
+                        const int s2 = out_tile[n + 12];
+                        const int s3 = out_tile[n + 18];
+                        const int s4 = out_tile[n + 24];
+                        const int s5 = out_tile[n + 30];
+
+                        w0[n] = s0 + s1 + s2 + s3 + s4;
+                        w1[n] = s1 - s2 + 2 * s3 - 2 * s4;
+                        w2[n] = s1 + s2 + 4 * s3 + 4 * s4;
+                        w3[n] = s1 - s2 + 8 * s3 - 8 * s4 + 4 * s5;
                     }
-                    // transpose w to w_t
-                    {
-                        d0[0] = w0[0];
-                        d0[1] = w1[0];
-                        d0[2] = w2[0];
-                        d0[3] = w3[0];
-                        d1[0] = w0[1];
-                        d1[1] = w1[1];
-                        d1[2] = w2[1];
-                        d1[3] = w3[1];
-                        d2[0] = w0[2];
-                        d2[1] = w1[2];
-                        d2[2] = w2[2];
-                        d2[3] = w3[2];
-                        d3[0] = w0[3];
-                        d3[1] = w1[3];
-                        d3[2] = w2[3];
-                        d3[3] = w3[3];
-                        d4[0] = w0[4];
-                        d4[1] = w1[4];
-                        d4[2] = w2[4];
-                        d4[3] = w3[4];
-                        d5[0] = w0[5];
-                        d5[1] = w1[5];
-                        d5[2] = w2[5];
-                        d5[3] = w3[5];
-                    }
-                    // Y = A_T * w_t
-                    for (int n = 0; n < 4; n++)
-                    {
-                        o0[n] = d0[n] + d1[n] + d2[n] + d3[n] + d4[n];
-                        o1[n] = d1[n] - d2[n] + 2 * d3[n] - 2 * d4[n];
-                        o2[n] = d1[n] + d2[n] + 4 * d3[n] + 4 * d4[n];
-                        o3[n] = d1[n] - d2[n] + 8 * d3[n] - 8 * d4[n] + d5[n];
-                    }
-                    // save to top blob tm
-                    for (int n = 0; n < 4; n++)
+
+                    // Y = A_T * w_t, w0 to w3 are the output columns
+                    int* wm[4] = {w0, w1, w2, w3};
+                    for (int m = 0; m < 4; m++)
                     {
-                        outRow0[n] = o0[n] / 576;
-                        outRow1[n] = o1[n] / 576;
-                        outRow2[n] = o2[n] / 576;
-                        outRow3[n] = o3[n] / 576;
+                        const int* d = wm[m];
+
+                        outRow0[m] = (d[0] + d[1] + d[2] + d[3] + d[4]) / 576;
+                        outRow1[m] = (d[1] - d[2] + 2 * d[3] - 2 * d[4]) / 576;
+                        outRow2[m] = (d[1] + d[2] + 4 * d[3] + 4 * d[4]) / 576;
+                        outRow3[m] = (d[1] - d[2] + 8 * d[3] - 8 * d[4] + 4 * d[5]) / 576;
                     }
 
                     outRow0 += 4;
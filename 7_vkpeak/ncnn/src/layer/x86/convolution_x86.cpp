@@ -29,9 +29,13 @@
 #include "x86_activation.h"
 #include "x86_usability.h"
 
+#include "algorithmcache.h"
 #include "benchmark.h"
 #include "cpu.h"
 #include "layer_type.h"
+#include "weightcache.h"
+
+#include <float.h>
 
 namespace ncnn {
 
@@ -145,6 +149,8 @@ Convolution_x86::Convolution_x86()
 
     activation = 0;
     convolution_dilation1 = 0;
+
+    algorithm = 0;
 }
 
 static void convolution_transform_kernel_packed_sse(const Mat& weight_data, Mat& weight_data_tm, int num_input, int num_output, int kernel_w, int kernel_h, int elempack, int out_elempack)
@@ -183,6 +189,152 @@ static void convolution_transform_kernel_packed_sse(const Mat& weight_data, Mat&
     }
 }
 
+// resolve the explicit or SAME padding into border sizes
+// returns false when there is nothing to pad or the padding cannot be done virtually
+static bool convolution_resolve_border(int w, int h, int kernel_extent_w, int kernel_extent_h, int stride_w, int stride_h, int pad_left, int pad_right, int pad_top, int pad_bottom, int& border_left, int& border_right, int& border_top, int& border_bottom)
+{
+    if (pad_left == -233 && pad_right == -233 && pad_top == -233 && pad_bottom == -233)
+    {
+        // tensorflow padding=SAME or onnx padding=SAME_UPPER
+        int wpad = kernel_extent_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_extent_h + (h - 1) / stride_h * stride_h - h;
+        border_left = wpad / 2;
+        border_right = wpad - wpad / 2;
+        border_top = hpad / 2;
+        border_bottom = hpad - hpad / 2;
+    }
+    else if (pad_left == -234 && pad_right == -234 && pad_top == -234 && pad_bottom == -234)
+    {
+        // onnx padding=SAME_LOWER
+        int wpad = kernel_extent_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_extent_h + (h - 1) / stride_h * stride_h - h;
+        border_left = wpad - wpad / 2;
+        border_right = wpad / 2;
+        border_top = hpad - hpad / 2;
+        border_bottom = hpad / 2;
+    }
+    else
+    {
+        border_left = pad_left;
+        border_right = pad_right;
+        border_top = pad_top;
+        border_bottom = pad_bottom;
+    }
+
+    if (border_left < 0 || border_right < 0 || border_top < 0 || border_bottom < 0)
+        return false;
+
+    return border_left > 0 || border_right > 0 || border_top > 0 || border_bottom > 0;
+}
+
+// im2col of the output rows [y0, y0 + tile_h) straight from the unpadded input, taps falling into the border read border_value
+// bottom_im2col = (outw * tile_h, maxk, inch/elempack) with any elemsize
+static void convolution_im2col_bordered(const Mat& bottom_blob, Mat& bottom_im2col, const unsigned char* border_value, int outw, int y0, int tile_h, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int border_left, int border_top, const Option& opt)
+{
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const int inch = bottom_blob.c;
+    const size_t elemsize = bottom_blob.elemsize;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < inch; p++)
+    {
+        const Mat img = bottom_blob.channel(p);
+        unsigned char* ptr = bottom_im2col.channel(p);
+
+        for (int u = 0; u < kernel_h; u++)
+        {
+            for (int v = 0; v < kernel_w; v++)
+            {
+                // output columns [j0, j1) read inside the input row
+                const int sx0 = dilation_w * v - border_left;
+                int j0 = sx0 >= 0 ? 0 : (-sx0 + stride_w - 1) / stride_w;
+                int j1 = w - sx0 <= 0 ? 0 : (w - sx0 + stride_w - 1) / stride_w;
+                j0 = std::min(j0, outw);
+                j1 = std::max(std::min(j1, outw), j0);
+
+                for (int i = y0; i < y0 + tile_h; i++)
+                {
+                    const int sy = stride_h * i + dilation_h * u - border_top;
+
+                    if (sy < 0 || sy >= h)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            memcpy(ptr, border_value, elemsize);
+                            ptr += elemsize;
+                        }
+                        continue;
+                    }
+
+                    for (int j = 0; j < j0; j++)
+                    {
+                        memcpy(ptr, border_value, elemsize);
+                        ptr += elemsize;
+                    }
+
+                    const unsigned char* sptr = img.row<const unsigned char>(sy) + (sx0 + j0 * stride_w) * elemsize;
+
+                    if (stride_w == 1)
+                    {
+                        memcpy(ptr, sptr, (j1 - j0) * elemsize);
+                        ptr += (j1 - j0) * elemsize;
+                    }
+                    else
+                    {
+                        for (int j = j0; j < j1; j++)
+                        {
+                            memcpy(ptr, sptr, elemsize);
+                            sptr += stride_w * elemsize;
+                            ptr += elemsize;
+                        }
+                    }
+
+                    for (int j = j1; j < outw; j++)
+                    {
+                        memcpy(ptr, border_value, elemsize);
+                        ptr += elemsize;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// output rows per im2col band
+// gathering a band right before the sgemm repacks it keeps both in cache,
+// instead of streaming a full size im2col buffer through memory twice,
+// while every band still carries enough output pixels to feed all threads
+static int convolution_im2col_tile_h(int outw, int outh, int maxk, int channels, size_t elemsize, int num_threads)
+{
+    const size_t im2col_budget = 512 * 1024;
+    const size_t im2col_row_bytes = (size_t)outw * maxk * channels * elemsize;
+    int tile_h = im2col_row_bytes >= im2col_budget ? 1 : (int)(im2col_budget / im2col_row_bytes);
+
+    const int tile_h_min = (64 * num_threads + outw - 1) / outw;
+    tile_h = std::max(tile_h, tile_h_min);
+
+    return std::min(tile_h, outh);
+}
+
+// the option flags that make the fp32 pipeline pick one kernel family
+// algorithm 0 keeps the built-in heuristic
+// 1 = winograd63  2 = winograd43  3 = winograd23  4 = sgemm  5 = direct
+static Option convolution_algorithm_option(const Option& opt, int algorithm)
+{
+    if (algorithm == 0)
+        return opt;
+
+    Option opt_algorithm = opt;
+    opt_algorithm.use_winograd_convolution = algorithm >= 1 && algorithm <= 3;
+    opt_algorithm.use_winograd63_convolution = algorithm == 1;
+    opt_algorithm.use_winograd43_convolution = algorithm == 2;
+    opt_algorithm.use_winograd23_convolution = algorithm == 3;
+    opt_algorithm.use_sgemm_convolution = algorithm == 4;
+
+    return opt_algorithm;
+}
+
 int Convolution_x86::create_pipeline(const Option& opt)
 {
     if (dynamic_weight)
@@ -197,6 +349,16 @@ int Convolution_x86::create_pipeline(const Option& opt)
     }
 #endif
 
+    if (opt.algorithm_cache)
+    {
+        algorithm = select_algorithm(opt);
+    }
+
+    return create_pipeline_fp32_x86(convolution_algorithm_option(opt, algorithm));
+}
+
+int Convolution_x86::create_pipeline_fp32_x86(const Option& opt)
+{
     int kernel_size = kernel_w * kernel_h;
     int num_input = weight_data_size / kernel_size / num_output;
 
@@ -711,6 +873,15 @@ int Convolution_x86::create_pipeline(const Option& opt)
         }
     }
 
+    if (opt.weight_cache)
+    {
+        weight_data_tm = opt.weight_cache->share(weight_data_tm);
+        weight_sgemm_data = opt.weight_cache->share(weight_sgemm_data);
+        weight_winograd23_data = opt.weight_cache->share(weight_winograd23_data);
+        weight_winograd43_data = opt.weight_cache->share(weight_winograd43_data);
+        weight_winograd63_data = opt.weight_cache->share(weight_winograd63_data);
+    }
+
     if (opt.lightmode)
     {
         weight_data.release();
@@ -719,6 +890,136 @@ int Convolution_x86::create_pipeline(const Option& opt)
     return 0;
 }
 
+int Convolution_x86::select_algorithm(const Option& opt)
+{
+    // timing needs the input shape hint from the param
+    if (bottom_shapes.size() != 1 || bottom_shapes[0].dims != 3)
+        return 0;
+
+    const int w = bottom_shapes[0].w;
+    const int h = bottom_shapes[0].h;
+    const int num_input = weight_data_size / (kernel_w * kernel_h) / num_output;
+    if (w <= 0 || h <= 0 || bottom_shapes[0].c != num_input)
+        return 0;
+
+    // these run a single kernel whatever the option flags are
+    if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && ((stride_w == 1 && stride_h == 1) || (stride_w == 2 && stride_h == 2)))
+        return 0;
+
+    if (!opt.use_packing_layout && kernel_w == kernel_h && dilation_w != 1 && dilation_h == dilation_w && stride_w == 1 && stride_h == 1)
+        return 0;
+
+    // only the kernel families the option allows
+    int candidates[5];
+    int candidate_count = 0;
+    if (opt.use_winograd_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+    {
+        if (opt.use_winograd63_convolution)
+            candidates[candidate_count++] = 1;
+        if (opt.use_winograd43_convolution)
+            candidates[candidate_count++] = 2;
+        if (opt.use_winograd23_convolution)
+            candidates[candidate_count++] = 3;
+    }
+    if (opt.use_sgemm_convolution)
+        candidates[candidate_count++] = 4;
+    candidates[candidate_count++] = 5;
+
+    if (candidate_count == 1)
+        return 0;
+
+    int candidate_mask = 0;
+    for (int i = 0; i < candidate_count; i++)
+    {
+        candidate_mask |= 1 << candidates[i];
+    }
+
+    char signature[256];
+    sprintf(signature, "Convolution_x86 %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d", w, h, num_input, num_output, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_right, pad_top, pad_bottom, opt.use_packing_layout, opt.num_threads, candidate_mask);
+
+    int algorithm = opt.algorithm_cache->find(signature);
+    if (algorithm >= 0 && algorithm <= 5)
+        return algorithm;
+
+    // time every candidate on the hinted shape
+    Option opt_tune = opt;
+    opt_tune.lightmode = false;
+    opt_tune.weight_cache = 0;
+    opt_tune.algorithm_cache = 0;
+
+    int elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        elempack = num_input % 16 == 0 ? 16 : num_input % 8 == 0 ? 8 : num_input % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        elempack = num_input % 8 == 0 ? 8 : num_input % 4 == 0 ? 4 : 1;
+#else
+        elempack = num_input % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+
+    Mat bottom_blob(w, h, num_input, 4u, opt.workspace_allocator);
+    if (bottom_blob.empty())
+        return 0;
+
+    bottom_blob.fill(0.1f);
+
+    Mat bottom_blob_packed;
+    convert_packing(bottom_blob, bottom_blob_packed, elempack, opt_tune);
+    if (bottom_blob_packed.empty())
+        return 0;
+
+    algorithm = 0;
+    double time_best = DBL_MAX;
+    for (int i = 0; i < candidate_count; i++)
+    {
+        const Option opt_algorithm = convolution_algorithm_option(opt_tune, candidates[i]);
+
+        create_pipeline_fp32_x86(opt_algorithm);
+
+        // the first run warms up caches and allocators
+        double time_min = DBL_MAX;
+        for (int j = 0; j < 4; j++)
+        {
+            Mat top_blob;
+
+            double start = get_current_time();
+
+            int ret = forward_fp32_x86(bottom_blob_packed, top_blob, opt_algorithm);
+
+            double end = get_current_time();
+
+            if (ret != 0)
+            {
+                time_min = DBL_MAX;
+                break;
+            }
+
+            if (j > 0)
+                time_min = std::min(time_min, end - start);
+        }
+
+        weight_data_tm.release();
+        weight_sgemm_data.release();
+        weight_winograd23_data.release();
+        weight_winograd43_data.release();
+        weight_winograd63_data.release();
+
+        if (time_min < time_best)
+        {
+            time_best = time_min;
+            algorithm = candidates[i];
+        }
+    }
+
+    opt.algorithm_cache->insert(signature, algorithm);
+
+    return algorithm;
+}
+
 int Convolution_x86::destroy_pipeline(const Option& opt)
 {
     if (activation)
@@ -747,6 +1048,11 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     }
 #endif
 
+    return forward_fp32_x86(bottom_blob, top_blob, convolution_algorithm_option(opt, algorithm));
+}
+
+int Convolution_x86::forward_fp32_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
     // flattened blob, implement as InnerProduct
     if (bottom_blob.dims == 1 && kernel_w == 1 && kernel_h == 1)
     {
@@ -796,6 +1102,25 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
     const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
 
+    // the generic im2col-sgemm path gathers the border virtually instead of padding a full copy first,
+    // and gathers large inputs band by band instead of building the whole im2col buffer
+    if (!weight_sgemm_data.empty() && !(kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && ((stride_w == 1 && stride_h == 1) || (stride_w == 2 && stride_h == 2))))
+    {
+        int border_left, border_right, border_top, border_bottom;
+        bool use_im2col_tiles = convolution_resolve_border(w, h, kernel_extent_w, kernel_extent_h, stride_w, stride_h, pad_left, pad_right, pad_top, pad_bottom, border_left, border_right, border_top, border_bottom);
+        if (!use_im2col_tiles && border_left == 0 && border_right == 0 && border_top == 0 && border_bottom == 0)
+        {
+            const int outw = (w - kernel_extent_w) / stride_w + 1;
+            const int outh = (h - kernel_extent_h) / stride_h + 1;
+            use_im2col_tiles = outw > 0 && outh > 0 && convolution_im2col_tile_h(outw, outh, kernel_w * kernel_h, channels, elemsize, opt.num_threads) < outh;
+        }
+
+        if (use_im2col_tiles)
+        {
+            return forward_im2col_sgemm_bordered(bottom_blob, top_blob, border_left, border_right, border_top, border_bottom, opt);
+        }
+    }
+
     Mat bottom_blob_bordered;
     make_padding(bottom_blob, bottom_blob_bordered, opt);
     if (bottom_blob_bordered.empty())
@@ -1864,10 +2189,12 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
         {
             convolution_im2col_sgemm_transform_kernel_int8_sse(weight_data, weight_sgemm_data, num_input, num_output, kernel_w, kernel_h);
         }
-        else if (opt.use_winograd_convolution && opt.use_winograd23_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1 && num_input >= 16 && num_output >= 16)
+        else if (opt.use_winograd_convolution && (opt.use_winograd23_convolution || opt.use_winograd43_convolution) && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1 && num_input >= 16 && num_output >= 16)
         {
-            conv3x3s1_winograd23_transform_kernel_int8_sse(weight_data, weight_winograd23_data, num_input, num_output, opt);
-            // conv3x3s1_winograd43_transform_kernel_int8_sse(weight_data, weight_winograd43_data, num_input, num_output, opt);
+            if (opt.use_winograd43_convolution)
+                conv3x3s1_winograd43_transform_kernel_int8_sse(weight_data, weight_winograd43_data, num_input, num_output, opt);
+            else // if (opt.use_winograd23_convolution)
+                conv3x3s1_winograd23_transform_kernel_int8_sse(weight_data, weight_winograd23_data, num_input, num_output, opt);
         }
         else if (opt.use_sgemm_convolution)
         {
@@ -1892,6 +2219,34 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
         scale_in_data[p] = scale_in;
     }
 
+    if (bottom_blob_int8_zero_point != 0)
+    {
+        // sum(w * (x + z)) = sum(w * x) + z * sum(w), fold the second term into bias
+        bias_data_int8.create(num_output);
+        for (int p = 0; p < num_output; p++)
+        {
+            const signed char* kptr = (const signed char*)weight_data + maxk * num_input * p;
+
+            int sum = 0;
+            for (int k = 0; k < maxk * num_input; k++)
+            {
+                sum += kptr[k];
+            }
+
+            float bias = bias_term ? bias_data[p] : 0.f;
+            bias_data_int8[p] = bias - bottom_blob_int8_zero_point * sum * scale_in_data[p];
+        }
+    }
+
+    if (opt.weight_cache)
+    {
+        weight_data_tm = opt.weight_cache->share(weight_data_tm);
+        weight_sgemm_data = opt.weight_cache->share(weight_sgemm_data);
+        weight_winograd23_data = opt.weight_cache->share(weight_winograd23_data);
+        weight_winograd43_data = opt.weight_cache->share(weight_winograd43_data);
+        weight_winograd63_data = opt.weight_cache->share(weight_winograd63_data);
+    }
+
     if (opt.lightmode)
     {
         weight_data.release();
@@ -1900,6 +2255,88 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
     return 0;
 }
 
+// im2col-sgemm int8 straight from the unpadded input into the int32 top_blob
+// the output is processed in bands of whole rows, each band is gathered into
+// a cache sized im2col panel and multiplied before the next one is built
+static int convolution_im2col_sgemm_bordered_int8(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel, signed char border_value, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int border_left, int border_top, const Option& opt)
+{
+    const int channels = bottom_blob.c;
+    const size_t elemsize = bottom_blob.elemsize;
+    const int elempack = bottom_blob.elempack;
+
+    const int outw = top_blob.w;
+    const int outh = top_blob.h;
+    const int out_elempack = top_blob.elempack;
+
+    const int maxk = kernel_w * kernel_h;
+
+    signed char border_values[8];
+    for (int i = 0; i < 8; i++)
+    {
+        border_values[i] = border_value;
+    }
+
+    int tile_h = convolution_im2col_tile_h(outw, outh, maxk, channels, elemsize, opt.num_threads);
+
+    // every band of top_blob starts as aligned as its channels for the aligned simd store
+    while (tile_h < outh && (size_t)tile_h * outw * top_blob.elemsize % 16 != 0)
+    {
+        tile_h++;
+    }
+
+    for (int y0 = 0; y0 < outh; y0 += tile_h)
+    {
+        const int tile_hh = std::min(tile_h, outh - y0);
+        const int size = outw * tile_hh;
+
+        Mat bottom_im2col(size, maxk, channels, elemsize, elempack, opt.workspace_allocator);
+        if (bottom_im2col.empty())
+            return -100;
+
+        convolution_im2col_bordered(bottom_blob, bottom_im2col, (const unsigned char*)border_values, outw, y0, tile_hh, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, border_left, border_top, opt);
+
+        // view the output band as a 2d blob sharing the channel stride of top_blob
+        Mat top_tile(size, 1, top_blob.c, top_blob.channel(0).row<int>(y0), top_blob.elemsize, out_elempack);
+        top_tile.cstep = top_blob.cstep;
+
+#if __SSE2__
+        if (elempack == 8 && out_elempack == 4)
+            im2col_sgemm_pack8to4_int8_sse(bottom_im2col, top_tile, kernel, opt);
+        if (elempack == 1 && out_elempack == 4)
+            im2col_sgemm_pack1to4_int8_sse(bottom_im2col, top_tile, kernel, opt);
+        if (elempack == 8 && out_elempack == 1)
+            im2col_sgemm_pack8to1_int8_sse(bottom_im2col, top_tile, kernel, opt);
+#endif // __SSE2__
+        if (elempack == 1 && out_elempack == 1)
+            im2col_sgemm_int8_sse(bottom_im2col, top_tile, kernel, opt);
+    }
+
+    return 0;
+}
+
+// whether forward_int8_x86 dispatches to the generic im2col-sgemm kernel
+// rather than one of the specialized 1x1 3x3 7x7 and winograd kernels
+static bool convolution_int8_use_im2col_sgemm(int elempack, int out_elempack_int32, int num_input, int num_output, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, const Option& opt)
+{
+    if (!opt.use_sgemm_convolution)
+        return false;
+
+    if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && ((stride_w == 1 && stride_h == 1) || (stride_w == 2 && stride_h == 2)))
+        return false;
+
+    if (elempack == 8)
+    {
+        return !(opt.use_winograd_convolution && opt.use_winograd43_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1);
+    }
+
+    if (out_elempack_int32 == 4)
+    {
+        return !(dilation_w == 1 && dilation_h == 1 && ((kernel_w == 3 && kernel_h == 3 && stride_w == 1 && stride_h == 1) || (kernel_w == 3 && kernel_h == 3 && stride_w == 2 && stride_h == 2) || (kernel_w == 7 && kernel_h == 7 && stride_w == 2 && stride_h == 2)));
+    }
+
+    return !(opt.use_winograd_convolution && (opt.use_winograd23_convolution || opt.use_winograd43_convolution) && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1 && num_input >= 16 && num_output >= 16);
+}
+
 int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
     int elembits = bottom_blob.elembits();
@@ -1909,23 +2346,60 @@ int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, con
     {
         Option opt_q = opt;
         opt_q.blob_allocator = opt.workspace_allocator;
-        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scales, opt_q);
+        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scales, bottom_blob_int8_zero_point, opt_q);
     }
 
     //     NCNN_LOGE("Convolution_arm input %d x %d  ksize=%d %d  stride=%d %d", w, h, kernel_w, kernel_h, stride_w, stride_h);
 
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    int channels = bottom_blob_int8.c;
+    int elempack = bottom_blob_int8.elempack;
+
+    int out_elempack_int32 = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+        out_elempack_int32 = num_output % 4 == 0 ? 4 : 1;
+    }
+#endif // __SSE2__
+
+    // the generic im2col-sgemm path gathers the border virtually instead of padding a full copy first
+    const bool use_im2col_sgemm = convolution_int8_use_im2col_sgemm(elempack, out_elempack_int32, channels * elempack, num_output, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+
+    int border_left = 0;
+    int border_right = 0;
+    int border_top = 0;
+    int border_bottom = 0;
+    bool use_im2col_tiles = use_im2col_sgemm && convolution_resolve_border(bottom_blob_int8.w, bottom_blob_int8.h, kernel_extent_w, kernel_extent_h, stride_w, stride_h, pad_left, pad_right, pad_top, pad_bottom, border_left, border_right, border_top, border_bottom);
+    if (use_im2col_sgemm && !use_im2col_tiles && border_left == 0 && border_right == 0 && border_top == 0 && border_bottom == 0)
+    {
+        // large inputs are gathered band by band instead of building the whole im2col buffer
+        const int outw = (bottom_blob_int8.w - kernel_extent_w) / stride_w + 1;
+        const int outh = (bottom_blob_int8.h - kernel_extent_h) / stride_h + 1;
+        use_im2col_tiles = outw > 0 && outh > 0 && convolution_im2col_tile_h(outw, outh, kernel_w * kernel_h, channels, bottom_blob_int8.elemsize, opt.num_threads) < outh;
+    }
+
     Mat bottom_blob_bordered;
-    make_padding(bottom_blob_int8, bottom_blob_bordered, opt);
-    if (bottom_blob_bordered.empty())
-        return -100;
+    if (use_im2col_tiles)
+    {
+        bottom_blob_bordered = bottom_blob_int8;
+    }
+    else
+    {
+        border_left = 0;
+        border_right = 0;
+        border_top = 0;
+        border_bottom = 0;
 
-    int w = bottom_blob_bordered.w;
-    int h = bottom_blob_bordered.h;
-    int channels = bottom_blob_bordered.c;
-    int elempack = bottom_blob_bordered.elempack;
+        make_padding(bottom_blob_int8, bottom_blob_bordered, opt);
+        if (bottom_blob_bordered.empty())
+            return -100;
+    }
 
-    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
-    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+    int w = bottom_blob_bordered.w + border_left + border_right;
+    int h = bottom_blob_bordered.h + border_top + border_bottom;
 
     int outw = (w - kernel_extent_w) / stride_w + 1;
     int outh = (h - kernel_extent_h) / stride_h + 1;
@@ -1951,133 +2425,141 @@ int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, con
 
     const int num_input = channels * elempack;
 
-    int out_elempack_int32 = 1;
-#if __SSE2__
-    if (opt.use_packing_layout)
-    {
-        out_elempack_int32 = num_output % 4 == 0 ? 4 : 1;
-    }
-#endif // __SSE2__
-
     Mat top_blob_int32;
     top_blob_int32.create(outw, outh, num_output / out_elempack_int32, (size_t)(4u * out_elempack_int32), out_elempack_int32, opt.workspace_allocator);
     if (top_blob_int32.empty())
         return -100;
 
-#if __SSE2__
-    if (elempack == 8 && out_elempack_int32 == 4)
-    {
-        if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
-        {
-            conv1x1s1_sgemm_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
-        {
-            conv1x1s2_sgemm_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (opt.use_winograd_convolution && opt.use_winograd43_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
-        {
-            conv3x3s1_winograd43_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_winograd43_data, opt);
-        }
-        else if (opt.use_sgemm_convolution)
-        {
-            convolution_im2col_sgemm_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
-        }
-        else
-        {
-            convolution_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
-        }
-    }
+    // asymmetric int8 pads with the zero point
+    const signed char border_value = static_cast<signed char>(pad_value + bottom_blob_int8_zero_point);
 
-    if (elempack == 1 && out_elempack_int32 == 4)
+    if (use_im2col_tiles)
     {
-        if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
-        {
-            conv1x1s1_sgemm_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
-        {
-            conv1x1s2_sgemm_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
-        {
-            conv3x3s1_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
-        {
-            conv3x3s2_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (kernel_w == 7 && kernel_h == 7 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
-        {
-            conv7x7s2_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (opt.use_sgemm_convolution) // TODO better condition && num_input >= 8 && num_output >= 8)
-        {
-            convolution_im2col_sgemm_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
-        }
-        else
-        {
-            convolution_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
-        }
+        int ret = convolution_im2col_sgemm_bordered_int8(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, border_value, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, border_left, border_top, opt);
+        if (ret != 0)
+            return ret;
     }
-
-    if (elempack == 8 && out_elempack_int32 == 1)
+    else
     {
-        if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
-        {
-            conv1x1s1_sgemm_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
-        {
-            conv1x1s2_sgemm_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (opt.use_winograd_convolution && opt.use_winograd43_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+#if __SSE2__
+        if (elempack == 8 && out_elempack_int32 == 4)
         {
-            conv3x3s1_winograd43_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_winograd43_data, opt);
+            if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            {
+                conv1x1s1_sgemm_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            {
+                conv1x1s2_sgemm_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (opt.use_winograd_convolution && opt.use_winograd43_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            {
+                conv3x3s1_winograd43_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_winograd43_data, opt);
+            }
+            else if (opt.use_sgemm_convolution)
+            {
+                convolution_im2col_sgemm_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            }
+            else
+            {
+                convolution_pack8to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            }
         }
-        else if (opt.use_sgemm_convolution) // TODO better condition && num_input >= 8 && num_output >= 8)
+
+        if (elempack == 1 && out_elempack_int32 == 4)
         {
-            convolution_im2col_sgemm_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            {
+                conv1x1s1_sgemm_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            {
+                conv1x1s2_sgemm_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            {
+                conv3x3s1_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            {
+                conv3x3s2_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (kernel_w == 7 && kernel_h == 7 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            {
+                conv7x7s2_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (opt.use_sgemm_convolution) // TODO better condition && num_input >= 8 && num_output >= 8)
+            {
+                convolution_im2col_sgemm_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            }
+            else
+            {
+                convolution_pack1to4_int8_sse(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            }
         }
-        else
+
+        if (elempack == 8 && out_elempack_int32 == 1)
         {
-            convolution_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            {
+                conv1x1s1_sgemm_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            {
+                conv1x1s2_sgemm_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (opt.use_winograd_convolution && opt.use_winograd43_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            {
+                conv3x3s1_winograd43_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_winograd43_data, opt);
+            }
+            else if (opt.use_sgemm_convolution) // TODO better condition && num_input >= 8 && num_output >= 8)
+            {
+                convolution_im2col_sgemm_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            }
+            else
+            {
+                convolution_pack8to1_int8_sse(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            }
         }
-    }
 #endif // __SSE2__
 
-    if (elempack == 1 && out_elempack_int32 == 1)
-    {
-        if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
-        {
-            conv1x1s1_sgemm_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
-        {
-            conv1x1s2_sgemm_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
-        }
-        else if (opt.use_winograd_convolution && opt.use_winograd23_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1 && num_input >= 16 && num_output >= 16)
+        if (elempack == 1 && out_elempack_int32 == 1)
         {
-            conv3x3s1_winograd23_int8_sse(bottom_blob_bordered, top_blob_int32, weight_winograd23_data, opt);
-            // conv3x3s1_winograd43_int8_sse(bottom_blob_bordered, top_blob_int32, weight_winograd43_data, opt);
-        }
-        else if (opt.use_sgemm_convolution)
-        {
-            convolution_im2col_sgemm_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
-        }
-        else
-        {
-            convolution_int8(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            {
+                conv1x1s1_sgemm_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            {
+                conv1x1s2_sgemm_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, opt);
+            }
+            else if (opt.use_winograd_convolution && (opt.use_winograd23_convolution || opt.use_winograd43_convolution) && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1 && num_input >= 16 && num_output >= 16)
+            {
+                if (opt.use_winograd43_convolution)
+                    conv3x3s1_winograd43_int8_sse(bottom_blob_bordered, top_blob_int32, weight_winograd43_data, opt);
+                else // if (opt.use_winograd23_convolution)
+                    conv3x3s1_winograd23_int8_sse(bottom_blob_bordered, top_blob_int32, weight_winograd23_data, opt);
+            }
+            else if (opt.use_sgemm_convolution)
+            {
+                convolution_im2col_sgemm_int8_sse(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            }
+            else
+            {
+                convolution_int8(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
+            }
         }
     }
 
+    const Mat& bias_data_corrected = bottom_blob_int8_zero_point != 0 ? bias_data_int8 : bias_data;
+
     if (use_int8_requantize)
     {
-        requantize_from_int32_to_int8(top_blob_int32, top_blob, scale_in_data, top_blob_int8_scales, bias_data, activation_type, activation_params, opt);
+        requantize_from_int32_to_int8(top_blob_int32, top_blob, scale_in_data, top_blob_int8_scales, bias_data_corrected, activation_type, activation_params, opt);
     }
     else
     {
-        dequantize_from_int32(top_blob_int32, top_blob, scale_in_data, bias_data, opt);
+        dequantize_from_int32(top_blob_int32, top_blob, scale_in_data, bias_data_corrected, opt);
 
         if (activation)
         {
@@ -2089,6 +2571,119 @@ int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, con
 }
 #endif // NCNN_INT8
 
+int Convolution_x86::forward_im2col_sgemm_bordered(const Mat& bottom_blob, Mat& top_blob, int border_left, int border_right, int border_top, int border_bottom, const Option& opt) const
+{
+    const int w = bottom_blob.w + border_left + border_right;
+    const int h = bottom_blob.h + border_top + border_bottom;
+    const int channels = bottom_blob.c;
+    const size_t elemsize = bottom_blob.elemsize;
+    const int elempack = bottom_blob.elempack;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const int outw = (w - kernel_extent_w) / stride_w + 1;
+    const int outh = (h - kernel_extent_h) / stride_h + 1;
+    int out_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#else
+        out_elempack = num_output % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+    size_t out_elemsize = elemsize / elempack * out_elempack;
+
+    top_blob.create(outw, outh, num_output / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const int maxk = kernel_w * kernel_h;
+
+    float border_value[16];
+    for (int i = 0; i < 16; i++)
+    {
+        border_value[i] = pad_value;
+    }
+
+    // process the output in bands of whole rows, each band is gathered into
+    // a cache sized im2col panel and multiplied before the next one is built
+    int tile_h = convolution_im2col_tile_h(outw, outh, maxk, channels, elemsize, opt.num_threads);
+
+    // every band of top_blob starts as aligned as its channels for the aligned simd store
+    while (tile_h < outh && (size_t)tile_h * outw * out_elemsize % 16 != 0)
+    {
+        tile_h++;
+    }
+
+    for (int y0 = 0; y0 < outh; y0 += tile_h)
+    {
+        const int tile_hh = std::min(tile_h, outh - y0);
+        const int size = outw * tile_hh;
+
+        Mat bottom_im2col(size, maxk, channels, elemsize, elempack, opt.workspace_allocator);
+        if (bottom_im2col.empty())
+            return -100;
+
+        convolution_im2col_bordered(bottom_blob, bottom_im2col, (const unsigned char*)border_value, outw, y0, tile_hh, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, border_left, border_top, opt);
+
+        // view the output band as a 2d blob sharing the channel stride of top_blob
+        Mat top_tile(size, 1, top_blob.c, top_blob.channel(0).row(y0), out_elemsize, out_elempack);
+        top_tile.cstep = top_blob.cstep;
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+        if (elempack == 16 && out_elempack == 16)
+            im2col_sgemm_pack16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 8 && out_elempack == 16)
+            im2col_sgemm_pack8to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 4 && out_elempack == 16)
+            im2col_sgemm_pack4to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 1 && out_elempack == 16)
+            im2col_sgemm_pack1to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 16 && out_elempack == 8)
+            im2col_sgemm_pack16to8_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 16 && out_elempack == 4)
+            im2col_sgemm_pack16to4_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 16 && out_elempack == 1)
+            im2col_sgemm_pack16to1_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __AVX512F__
+        if (elempack == 8 && out_elempack == 8)
+            im2col_sgemm_pack8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 4 && out_elempack == 8)
+            im2col_sgemm_pack4to8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 1 && out_elempack == 8)
+            im2col_sgemm_pack1to8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 8 && out_elempack == 4)
+            im2col_sgemm_pack8to4_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 8 && out_elempack == 1)
+            im2col_sgemm_pack8to1_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __AVX__
+        if (elempack == 4 && out_elempack == 4)
+            im2col_sgemm_pack4_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 1 && out_elempack == 4)
+            im2col_sgemm_pack1to4_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+        if (elempack == 4 && out_elempack == 1)
+            im2col_sgemm_pack4to1_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __SSE2__
+        if (elempack == 1 && out_elempack == 1)
+            im2col_sgemm_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+    }
+
+    if (activation)
+    {
+        activation->forward_inplace(top_blob, opt);
+    }
+
+    return 0;
+}
+
 int Convolution_x86::forwardDilation_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
     int w = bottom_blob.w;
@@ -32,11 +32,15 @@ public:
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 
 protected:
+    int create_pipeline_fp32_x86(const Option& opt);
+    int forward_fp32_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+    int select_algorithm(const Option& opt);
 #if NCNN_INT8
     int create_pipeline_int8_x86(const Option& opt);
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #endif
     int forwardDilation_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+    int forward_im2col_sgemm_bordered(const Mat& bottom_blob, Mat& top_blob, int border_left, int border_right, int border_top, int border_bottom, const Option& opt) const;
 
 public:
     Layer* activation;
@@ -50,8 +54,14 @@ public:
     // forwardDilation
     Layer* convolution_dilation1;
 
+    // kernel family timed with opt.algorithm_cache, 0 = built-in heuristic
+    int algorithm;
+
 #if NCNN_INT8
     Mat scale_in_data;
+
+    // bias with the zero point correction for asymmetric int8 input
+    Mat bias_data_int8;
 #endif
 };
 
@@ -22,6 +22,7 @@ namespace ncnn {
 #include "convolution_sgemm_pack1to4_int8.h"
 #include "convolution_sgemm_pack8to1_int8.h"
 #include "convolution_sgemm_pack8to4_int8.h"
+#include "convolution_3x3_int8.h"
 #include "convolution_3x3_pack8to1_int8.h"
 #include "convolution_3x3_pack8to4_int8.h"
 
@@ -31,6 +32,11 @@ void im2col_sgemm_int8_sse_avx2(const Mat& bottom_im2col, Mat& top_blob, const M
     im2col_sgemm_int8_sse(bottom_im2col, top_blob, kernel, opt);
 }
 
+void conv3x3s1_winograd43_int8_sse_avx2(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel, const Option& opt)
+{
+    conv3x3s1_winograd43_int8_sse(bottom_blob, top_blob, kernel, opt);
+}
+
 // pack1to4
 void im2col_sgemm_pack1to4_int8_sse_avx2(const Mat& bottom_im2col, Mat& top_blob, const Mat& kernel, const Option& opt)
 {
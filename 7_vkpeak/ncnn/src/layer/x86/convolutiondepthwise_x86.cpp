@@ -25,6 +25,7 @@
 #include "x86_usability.h"
 
 #include "layer_type.h"
+#include "weightcache.h"
 
 namespace ncnn {
 
@@ -132,6 +133,11 @@ int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
             }
         }
 
+        if (opt.weight_cache)
+        {
+            weight_data_tm = opt.weight_cache->share(weight_data_tm);
+        }
+
         if (opt.lightmode)
         {
             weight_data.release();
@@ -0,0 +1,244 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "convolutiondepthwisepointwise_x86.h"
+
+#include "layer_type.h"
+
+namespace ncnn {
+
+ConvolutionDepthWisePointWise_x86::ConvolutionDepthWisePointWise_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+
+    convolutiondepthwise = 0;
+    convolution = 0;
+}
+
+int ConvolutionDepthWisePointWise_x86::create_pipeline(const Option& opt)
+{
+    // depth-wise, padded band by band in forward
+    {
+        convolutiondepthwise = ncnn::create_layer(ncnn::LayerType::ConvolutionDepthWise);
+
+        // set param
+        ncnn::ParamDict pd;
+        pd.set(0, num_output); // num_output
+        pd.set(1, kernel_w);
+        pd.set(11, kernel_h);
+        pd.set(2, dilation_w);
+        pd.set(12, dilation_h);
+        pd.set(3, stride_w);
+        pd.set(13, stride_h);
+        pd.set(4, 0);  // pad_w
+        pd.set(14, 0); // pad_h
+        pd.set(5, bias_term);
+        pd.set(6, weight_data_size);
+        pd.set(7, num_output); // group
+        pd.set(9, activation_type);
+        pd.set(10, activation_params);
+
+        convolutiondepthwise->load_param(pd);
+
+        // set weights
+        ncnn::Mat weights[2];
+        weights[0] = weight_data;
+        weights[1] = bias_data;
+
+        convolutiondepthwise->load_model(ModelBinFromMatArray(weights));
+
+        convolutiondepthwise->create_pipeline(opt);
+    }
+
+    // point-wise
+    {
+        convolution = ncnn::create_layer(ncnn::LayerType::Convolution);
+
+        // set param
+        ncnn::ParamDict pd;
+        pd.set(0, pointwise_num_output); // num_output
+        pd.set(1, 1);
+        pd.set(11, 1);
+        pd.set(5, pointwise_bias_term);
+        pd.set(6, pointwise_weight_data_size);
+        pd.set(9, pointwise_activation_type);
+        pd.set(10, pointwise_activation_params);
+
+        convolution->load_param(pd);
+
+        // set weights
+        ncnn::Mat weights[2];
+        weights[0] = pointwise_weight_data;
+        weights[1] = pointwise_bias_data;
+
+        convolution->load_model(ModelBinFromMatArray(weights));
+
+        convolution->create_pipeline(opt);
+    }
+
+    if (opt.lightmode)
+    {
+        weight_data.release();
+        bias_data.release();
+        pointwise_weight_data.release();
+        pointwise_bias_data.release();
+    }
+
+    return 0;
+}
+
+int ConvolutionDepthWisePointWise_x86::destroy_pipeline(const Option& opt)
+{
+    if (convolutiondepthwise)
+    {
+        convolutiondepthwise->destroy_pipeline(opt);
+        delete convolutiondepthwise;
+        convolutiondepthwise = 0;
+    }
+
+    if (convolution)
+    {
+        convolution->destroy_pipeline(opt);
+        delete convolution;
+        convolution = 0;
+    }
+
+    return 0;
+}
+
+// output rows per fused band
+// the padded input rows, the depth-wise rows and their sgemm repack of one band stay in cache
+// until the point-wise convolution consumes them, instead of writing the whole intermediate
+// feature map out and reading it back, while every band still carries enough pixels to feed all threads
+static int convolutiondepthwisepointwise_tile_h(int w, int outw, int outh, int stride_h, int channels, int outch, int num_threads)
+{
+    const size_t band_budget = 512 * 1024;
+
+    // the whole intermediate feature map stays in cache anyway
+    if ((size_t)outw * outh * channels * sizeof(float) <= band_budget)
+        return outh;
+
+    const size_t band_row_bytes = ((size_t)w * stride_h * channels + (size_t)outw * channels * 2 + (size_t)outw * outch) * sizeof(float);
+    int tile_h = band_row_bytes >= band_budget ? 1 : (int)(band_budget / band_row_bytes);
+
+    const int tile_h_min = (64 * num_threads + outw - 1) / outw;
+    tile_h = std::max(tile_h, tile_h_min);
+
+    return std::min(tile_h, outh);
+}
+
+int ConvolutionDepthWisePointWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const int channels = bottom_blob.c;
+    const size_t elemsize = bottom_blob.elemsize;
+    const int elempack = bottom_blob.elempack;
+
+    int _pad_left, _pad_right, _pad_top, _pad_bottom;
+    resolve_padding(w, h, _pad_left, _pad_right, _pad_top, _pad_bottom);
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const int outw = (w + _pad_left + _pad_right - kernel_extent_w) / stride_w + 1;
+    const int outh = (h + _pad_top + _pad_bottom - kernel_extent_h) / stride_h + 1;
+
+    // the same output packing the point-wise Convolution_x86 picks
+    int out_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        out_elempack = pointwise_num_output % 16 == 0 ? 16 : pointwise_num_output % 8 == 0 ? 8 : pointwise_num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        out_elempack = pointwise_num_output % 8 == 0 ? 8 : pointwise_num_output % 4 == 0 ? 4 : 1;
+#else
+        out_elempack = pointwise_num_output % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+    const size_t out_elemsize = elemsize / elempack * out_elempack;
+
+    top_blob.create(outw, outh, pointwise_num_output / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    int tile_h = convolutiondepthwisepointwise_tile_h(w, outw, outh, stride_h, num_output, pointwise_num_output, opt.num_threads);
+    if (_pad_top >= kernel_extent_h || _pad_bottom >= kernel_extent_h)
+    {
+        // some band would read padding only
+        tile_h = outh;
+    }
+
+    // every band of top_blob starts as aligned as its channels for the aligned simd load and store
+    while (tile_h < outh && (size_t)tile_h * outw * out_elemsize % 16 != 0)
+    {
+        tile_h++;
+    }
+
+    const bool has_pad = _pad_left > 0 || _pad_right > 0 || _pad_top > 0 || _pad_bottom > 0;
+
+    Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+
+    // point-wise writes into the band of top_blob
+    Option opt_pw = opt;
+    opt_pw.blob_allocator = top_blob.allocator;
+
+    Mat bottom_band_bordered;
+    Mat depthwise_tile;
+    for (int y0 = 0; y0 < outh; y0 += tile_h)
+    {
+        const int band_h = std::min(tile_h, outh - y0);
+
+        // input rows of this band, negative and beyond h in padding
+        const int iy0 = y0 * stride_h - _pad_top;
+        const int iy1 = (y0 + band_h - 1) * stride_h - _pad_top + kernel_extent_h;
+
+        const int r0 = std::max(iy0, 0);
+        const int r1 = std::min(iy1, h);
+
+        Mat bottom_band(w, r1 - r0, channels, (void*)bottom_blob.row<const unsigned char>(r0), elemsize, elempack);
+        bottom_band.cstep = bottom_blob.cstep;
+
+        if (has_pad)
+        {
+            copy_make_border(bottom_band, bottom_band_bordered, r0 - iy0, iy1 - r1, _pad_left, _pad_right, BORDER_CONSTANT, pad_value, opt_b);
+            if (bottom_band_bordered.empty())
+                return -100;
+        }
+        else
+        {
+            bottom_band_bordered = bottom_band;
+        }
+
+        int ret = convolutiondepthwise->forward(bottom_band_bordered, depthwise_tile, opt_b);
+        if (ret != 0)
+            return ret;
+
+        Mat top_band(outw, band_h, top_blob.c, top_blob.row<unsigned char>(y0), out_elemsize, out_elempack, top_blob.allocator);
+        top_band.cstep = top_blob.cstep;
+
+        ret = convolution->forward(depthwise_tile, top_band, opt_pw);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -32,16 +32,16 @@
 
 namespace ncnn {
 
-#include "deformableconv2d_sgemm.h"
+#include "convolution_sgemm.h"
 
 #if __SSE2__
 #include "deformableconv2d_pack4.h"
 #include "deformableconv2d_pack1to4.h"
 #include "deformableconv2d_pack4to1.h"
 
-#include "deformableconv2d_sgemm_pack4.h"
-#include "deformableconv2d_sgemm_pack1to4.h"
-#include "deformableconv2d_sgemm_pack4to1.h"
+#include "convolution_sgemm_pack4.h"
+#include "convolution_sgemm_pack1to4.h"
+#include "convolution_sgemm_pack4to1.h"
 
 #if __AVX__
 #include "deformableconv2d_pack8.h"
@@ -50,11 +50,11 @@ namespace ncnn {
 #include "deformableconv2d_pack8to4.h"
 #include "deformableconv2d_pack8to1.h"
 
-#include "deformableconv2d_sgemm_pack8.h"
-#include "deformableconv2d_sgemm_pack4to8.h"
-#include "deformableconv2d_sgemm_pack1to8.h"
-#include "deformableconv2d_sgemm_pack8to4.h"
-#include "deformableconv2d_sgemm_pack8to1.h"
+#include "convolution_sgemm_pack8.h"
+#include "convolution_sgemm_pack4to8.h"
+#include "convolution_sgemm_pack1to8.h"
+#include "convolution_sgemm_pack8to4.h"
+#include "convolution_sgemm_pack8to1.h"
 
 #if __AVX512F__
 #include "deformableconv2d_pack16.h"
@@ -65,13 +65,13 @@ namespace ncnn {
 #include "deformableconv2d_pack16to4.h"
 #include "deformableconv2d_pack16to1.h"
 
-#include "deformableconv2d_sgemm_pack16.h"
-#include "deformableconv2d_sgemm_pack8to16.h"
-#include "deformableconv2d_sgemm_pack4to16.h"
-#include "deformableconv2d_sgemm_pack1to16.h"
-#include "deformableconv2d_sgemm_pack16to8.h"
-#include "deformableconv2d_sgemm_pack16to4.h"
-#include "deformableconv2d_sgemm_pack16to1.h"
+#include "convolution_sgemm_pack16.h"
+#include "convolution_sgemm_pack8to16.h"
+#include "convolution_sgemm_pack4to16.h"
+#include "convolution_sgemm_pack1to16.h"
+#include "convolution_sgemm_pack16to8.h"
+#include "convolution_sgemm_pack16to4.h"
+#include "convolution_sgemm_pack16to1.h"
 #endif // __AVX512F__
 #endif // __AVX__
 #endif // __SSE2__
@@ -123,6 +123,188 @@ static void deformableconv2d_transform_kernel_packed_sse(const Mat& weight_data,
     }
 }
 
+// bilinear sampling table of one band of output rows, shared by every input channel
+// for each kernel tap and output pixel, the four corner positions in the input plane
+// and their bilinear weights with the modulation mask folded in
+// corners outside the input get zero weight and point at pixel 0, so gathering needs no branch
+static void deformableconv2d_sampling_table(const std::vector<Mat>& bottom_blobs, Mat& sampling_pos, Mat& sampling_weights, int y0, int tile_h, int outw, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int pad_left, int pad_top, const Option& opt)
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+    const Mat& offset = bottom_blobs[1];
+    const bool has_mask = (bottom_blobs.size() == 3);
+
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const int size = outw * tile_h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int k = 0; k < kernel_w * kernel_h; k++)
+    {
+        const int i = k / kernel_w;
+        const int j = k % kernel_w;
+
+        const int y_c = k * 2;
+        const int x_c = k * 2 + 1;
+        const Mat offset_y = offset.channel(y_c / offset.elempack);
+        const Mat offset_x = offset.channel(x_c / offset.elempack);
+
+        int* pos = sampling_pos.row<int>(k);
+        float* weights = sampling_weights.row(k);
+
+        for (int t = 0; t < size; t++)
+        {
+            const int h_col = y0 + t / outw;
+            const int w_col = t % outw;
+
+            const float offset_h = offset_y.row(h_col)[w_col * offset.elempack + y_c % offset.elempack];
+            const float offset_w = offset_x.row(h_col)[w_col * offset.elempack + x_c % offset.elempack];
+
+            float mask_ = 1.f;
+            if (has_mask)
+            {
+                const Mat& mask = bottom_blobs[2];
+                mask_ = mask.channel(k / mask.elempack).row(h_col)[w_col * mask.elempack + k % mask.elempack];
+            }
+
+            const float h_im = h_col * stride_h - pad_top + i * dilation_h + offset_h;
+            const float w_im = w_col * stride_w - pad_left + j * dilation_w + offset_w;
+
+            pos[0] = 0;
+            pos[1] = 0;
+            pos[2] = 0;
+            pos[3] = 0;
+            weights[0] = 0.f;
+            weights[1] = 0.f;
+            weights[2] = 0.f;
+            weights[3] = 0.f;
+
+            // Bilinear
+            if (h_im > -1 && w_im > -1 && h_im < h && w_im < w)
+            {
+                int h_low = floor(h_im);
+                int w_low = floor(w_im);
+                int h_high = h_low + 1;
+                int w_high = w_low + 1;
+
+                float lh = h_im - h_low;
+                float lw = w_im - w_low;
+                float hh = 1 - lh;
+                float hw = 1 - lw;
+
+                if (h_low >= 0 && w_low >= 0)
+                {
+                    pos[0] = h_low * w + w_low;
+                    weights[0] = hh * hw * mask_;
+                }
+                if (h_low >= 0 && w_high <= w - 1)
+                {
+                    pos[1] = h_low * w + w_high;
+                    weights[1] = hh * lw * mask_;
+                }
+                if (h_high <= h - 1 && w_low >= 0)
+                {
+                    pos[2] = h_high * w + w_low;
+                    weights[2] = lh * hw * mask_;
+                }
+                if (h_high <= h - 1 && w_high <= w - 1)
+                {
+                    pos[3] = h_high * w + w_high;
+                    weights[3] = lh * lw * mask_;
+                }
+            }
+
+            pos += 4;
+            weights += 4;
+        }
+    }
+}
+
+// gather the sampled input into the layout expected by im2col_sgemm_*
+// bottom_im2col = (outw * tile_h, maxk, inch/elempack)
+static void deformableconv2d_im2col(const Mat& bottom_blob, const Mat& sampling_pos, const Mat& sampling_weights, Mat& bottom_im2col, const Option& opt)
+{
+    const int inch = bottom_blob.c;
+    const int elempack = bottom_blob.elempack;
+    const int size = bottom_im2col.w;
+    const int maxk = bottom_im2col.h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int ic = 0; ic < inch; ic++)
+    {
+        const float* data_im_ptr = bottom_blob.channel(ic);
+        float* ptr = bottom_im2col.channel(ic);
+
+        for (int k = 0; k < maxk; k++)
+        {
+            const int* pos = sampling_pos.row<int>(k);
+            const float* weights = sampling_weights.row(k);
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+            if (elempack == 16)
+            {
+                for (int t = 0; t < size; t++)
+                {
+                    __m512 _val = _mm512_mul_ps(_mm512_load_ps(data_im_ptr + pos[0] * 16), _mm512_set1_ps(weights[0]));
+                    _val = _mm512_fmadd_ps(_mm512_load_ps(data_im_ptr + pos[1] * 16), _mm512_set1_ps(weights[1]), _val);
+                    _val = _mm512_fmadd_ps(_mm512_load_ps(data_im_ptr + pos[2] * 16), _mm512_set1_ps(weights[2]), _val);
+                    _val = _mm512_fmadd_ps(_mm512_load_ps(data_im_ptr + pos[3] * 16), _mm512_set1_ps(weights[3]), _val);
+                    _mm512_store_ps(ptr, _val);
+
+                    pos += 4;
+                    weights += 4;
+                    ptr += 16;
+                }
+            }
+#endif // __AVX512F__
+            if (elempack == 8)
+            {
+                for (int t = 0; t < size; t++)
+                {
+                    __m256 _val = _mm256_mul_ps(_mm256_load_ps(data_im_ptr + pos[0] * 8), _mm256_set1_ps(weights[0]));
+                    _val = _mm256_comp_fmadd_ps(_mm256_load_ps(data_im_ptr + pos[1] * 8), _mm256_set1_ps(weights[1]), _val);
+                    _val = _mm256_comp_fmadd_ps(_mm256_load_ps(data_im_ptr + pos[2] * 8), _mm256_set1_ps(weights[2]), _val);
+                    _val = _mm256_comp_fmadd_ps(_mm256_load_ps(data_im_ptr + pos[3] * 8), _mm256_set1_ps(weights[3]), _val);
+                    _mm256_store_ps(ptr, _val);
+
+                    pos += 4;
+                    weights += 4;
+                    ptr += 8;
+                }
+            }
+#endif // __AVX__
+            if (elempack == 4)
+            {
+                for (int t = 0; t < size; t++)
+                {
+                    __m128 _val = _mm_mul_ps(_mm_load_ps(data_im_ptr + pos[0] * 4), _mm_set1_ps(weights[0]));
+                    _val = _mm_comp_fmadd_ps(_mm_load_ps(data_im_ptr + pos[1] * 4), _mm_set1_ps(weights[1]), _val);
+                    _val = _mm_comp_fmadd_ps(_mm_load_ps(data_im_ptr + pos[2] * 4), _mm_set1_ps(weights[2]), _val);
+                    _val = _mm_comp_fmadd_ps(_mm_load_ps(data_im_ptr + pos[3] * 4), _mm_set1_ps(weights[3]), _val);
+                    _mm_store_ps(ptr, _val);
+
+                    pos += 4;
+                    weights += 4;
+                    ptr += 4;
+                }
+            }
+#endif // __SSE2__
+            if (elempack == 1)
+            {
+                for (int t = 0; t < size; t++)
+                {
+                    ptr[0] = data_im_ptr[pos[0]] * weights[0] + data_im_ptr[pos[1]] * weights[1] + data_im_ptr[pos[2]] * weights[2] + data_im_ptr[pos[3]] * weights[3];
+
+                    pos += 4;
+                    weights += 4;
+                    ptr += 1;
+                }
+            }
+        }
+    }
+}
+
 int DeformableConv2D_x86::create_pipeline(const Option& opt)
 {
     activation = create_activation_layer(activation_type, activation_params, opt);
@@ -416,387 +598,282 @@ int DeformableConv2D_x86::forward(const std::vector<Mat>& bottom_blobs, std::vec
 
     const int num_input = channels * elempack;
 
-#if __SSE2__
-#if __AVX__
-#if __AVX512F__
-    if (elempack == 16 && out_elempack == 16)
+    if (opt.use_sgemm_convolution)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack16_avx512(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
+        const int maxk = kernel_w * kernel_h;
 
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
+        // process the output in bands of whole rows so that the sampling table,
+        // the im2col buffer and the sgemm repack stay within a fixed workspace budget
+        const size_t im2col_budget = 16 * 1024 * 1024;
+        const size_t im2col_row_bytes = (size_t)out_w * maxk * (num_input * 4u + 32u);
+        int tile_h = im2col_row_bytes >= im2col_budget ? 1 : (int)(im2col_budget / im2col_row_bytes);
+        tile_h = std::min(tile_h, out_h);
+
+        // every band of top_blob starts as aligned as its channels for the aligned simd store
+        while (tile_h < out_h && (size_t)tile_h * out_w * out_elemsize % 16 != 0)
         {
-            deformableconv2d_pack16_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
+            tile_h++;
         }
-    }
 
-    if (elempack == 8 && out_elempack == 16)
-    {
-        if (opt.use_sgemm_convolution)
+        for (int y0 = 0; y0 < out_h; y0 += tile_h)
         {
-            deformableconv2d_im2col_sgemm_pack8to16_avx512(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
+            const int tile_hh = std::min(tile_h, out_h - y0);
+            const int size = out_w * tile_hh;
 
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
+            Mat sampling_pos(size * 4, maxk, 4u, opt.workspace_allocator);
+            Mat sampling_weights(size * 4, maxk, 4u, opt.workspace_allocator);
+            if (sampling_pos.empty() || sampling_weights.empty())
+                return -100;
+
+            deformableconv2d_sampling_table(bottom_blobs, sampling_pos, sampling_weights, y0, tile_hh, out_w, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
+
+            Mat bottom_im2col(size, maxk, channels, elemsize, elempack, opt.workspace_allocator);
+            if (bottom_im2col.empty())
+                return -100;
+
+            deformableconv2d_im2col(bottom_blob, sampling_pos, sampling_weights, bottom_im2col, opt);
+
+            // view the output band as a 2d blob sharing the channel stride of top_blob
+            Mat top_tile(size, 1, top_blob.c, top_blob.channel(0).row(y0), out_elemsize, out_elempack);
+            top_tile.cstep = top_blob.cstep;
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+            if (elempack == 16 && out_elempack == 16)
+                im2col_sgemm_pack16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 8 && out_elempack == 16)
+                im2col_sgemm_pack8to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 4 && out_elempack == 16)
+                im2col_sgemm_pack4to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 1 && out_elempack == 16)
+                im2col_sgemm_pack1to16_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 16 && out_elempack == 8)
+                im2col_sgemm_pack16to8_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 16 && out_elempack == 4)
+                im2col_sgemm_pack16to4_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 16 && out_elempack == 1)
+                im2col_sgemm_pack16to1_avx512(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __AVX512F__
+            if (elempack == 8 && out_elempack == 8)
+                im2col_sgemm_pack8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 4 && out_elempack == 8)
+                im2col_sgemm_pack4to8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 1 && out_elempack == 8)
+                im2col_sgemm_pack1to8_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 8 && out_elempack == 4)
+                im2col_sgemm_pack8to4_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 8 && out_elempack == 1)
+                im2col_sgemm_pack8to1_avx(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __AVX__
+            if (elempack == 4 && out_elempack == 4)
+                im2col_sgemm_pack4_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 1 && out_elempack == 4)
+                im2col_sgemm_pack1to4_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+            if (elempack == 4 && out_elempack == 1)
+                im2col_sgemm_pack4to1_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
+#endif // __SSE2__
+            if (elempack == 1 && out_elempack == 1)
+                im2col_sgemm_sse(bottom_im2col, top_tile, weight_sgemm_data, bias_data, opt);
         }
-        else
+
+        if (activation)
         {
-            deformableconv2d_pack8to16_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
+            activation->forward_inplace(top_blob, opt);
         }
+
+        return 0;
     }
 
-    if (elempack == 16 && out_elempack == 8)
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16 && out_elempack == 16)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack16to8_avx512(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
+        deformableconv2d_pack16_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
+    }
 
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack16to8_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+    if (elempack == 8 && out_elempack == 16)
+    {
+        deformableconv2d_pack8to16_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
-    if (elempack == 4 && out_elempack == 16)
+    if (elempack == 16 && out_elempack == 8)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack4to16_avx512(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
+        deformableconv2d_pack16to8_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
+    }
 
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack4to16_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+    if (elempack == 4 && out_elempack == 16)
+    {
+        deformableconv2d_pack4to16_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 16 && out_elempack == 4)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack16to4_avx512(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack16to4_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack16to4_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 1 && out_elempack == 16)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack1to16_avx512(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack1to16_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack1to16_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 16 && out_elempack == 1)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack16to1_avx512(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack16to1_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack16to1_avx512(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
 #endif // __AVX512F__
 
     if (elempack == 8 && out_elempack == 8)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack8_avx(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack8_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack8_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 1 && out_elempack == 8)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack1to8_avx(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack1to8_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack1to8_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 4 && out_elempack == 8)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack4to8_avx(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack4to8_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack4to8_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 8 && out_elempack == 1)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack8to1_avx(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack8to1_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack8to1_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 8 && out_elempack == 4)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack8to4_avx(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack8to4_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack8to4_avx(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 #endif // __AVX__
 
     if (elempack == 4 && out_elempack == 4)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack4_sse(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack4_sse(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack4_sse(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 1 && out_elempack == 4)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack1to4_sse(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack1to4_sse(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack1to4_sse(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 
     if (elempack == 4 && out_elempack == 1)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_pack4to1_sse(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
-
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
-        {
-            deformableconv2d_pack4to1_sse(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
-        }
+        deformableconv2d_pack4to1_sse(bottom_blobs, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, activation_type, activation_params, opt);
     }
 #endif // __SSE2__
 
     if (elempack == 1 && out_elempack == 1)
     {
-        if (opt.use_sgemm_convolution)
-        {
-            deformableconv2d_im2col_sgemm_sse(bottom_blobs, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, pad_left, pad_top, opt);
+        const bool offset_not_pack = offset.elempack == 1;
+        const bool mask_not_pack = has_mask ? bottom_blobs[2].elempack == 1 : true;
+        const float* weight_ptr = weight_data_tm;
 
-            if (activation)
-            {
-                activation->forward_inplace(top_blob, opt);
-            }
-        }
-        else
+        // naive deformable conv
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int h_col = 0; h_col < out_h; h_col++)
         {
-            const bool offset_not_pack = offset.elempack == 1;
-            const bool mask_not_pack = has_mask ? bottom_blobs[2].elempack == 1 : true;
-            const float* weight_ptr = weight_data_tm;
-
-            // naive deformable conv
-            #pragma omp parallel for num_threads(opt.num_threads)
-            for (int h_col = 0; h_col < out_h; h_col++)
+            for (int w_col = 0; w_col < out_w; w_col++)
             {
-                for (int w_col = 0; w_col < out_w; w_col++)
+                int h_in = h_col * stride_h - pad_top;
+                int w_in = w_col * stride_w - pad_left;
+                for (int oc = 0; oc < num_output; oc++)
                 {
-                    int h_in = h_col * stride_h - pad_top;
-                    int w_in = w_col * stride_w - pad_left;
-                    for (int oc = 0; oc < num_output; oc++)
+                    float sum = 0.f;
+                    if (bias_term)
+                        sum = bias_data[oc];
+                    for (int i = 0; i < kernel_h; i++)
                     {
-                        float sum = 0.f;
-                        if (bias_term)
-                            sum = bias_data[oc];
-                        for (int i = 0; i < kernel_h; i++)
+                        for (int j = 0; j < kernel_w; j++)
                         {
-                            for (int j = 0; j < kernel_w; j++)
+                            float offset_h = 0.f;
+                            float offset_w = 0.f;
+                            float mask_ = 1.f;
+                            if (offset_not_pack)
+                            {
+                                offset_h = offset.channel((i * kernel_w + j) * 2).row(h_col)[w_col];
+                                offset_w = offset.channel((i * kernel_w + j) * 2 + 1).row(h_col)[w_col];
+                            }
+                            else
+                            {
+                                const int y_c = (i * kernel_w + j) * 2;
+                                const int x_c = (i * kernel_w + j) * 2 + 1;
+                                offset_h = offset.channel(y_c / offset.elempack).row(h_col)[w_col * offset.elempack + y_c % offset.elempack];
+                                offset_w = offset.channel(x_c / offset.elempack).row(h_col)[w_col * offset.elempack + x_c % offset.elempack];
+                            }
+                            if (has_mask)
                             {
-                                float offset_h = 0.f;
-                                float offset_w = 0.f;
-                                float mask_ = 1.f;
-                                if (offset_not_pack)
+                                const Mat& mask = bottom_blobs[2];
+                                if (mask_not_pack)
                                 {
-                                    offset_h = offset.channel((i * kernel_w + j) * 2).row(h_col)[w_col];
-                                    offset_w = offset.channel((i * kernel_w + j) * 2 + 1).row(h_col)[w_col];
+                                    mask_ = mask.channel(i * kernel_w + j).row(h_col)[w_col];
                                 }
                                 else
                                 {
-                                    const int y_c = (i * kernel_w + j) * 2;
-                                    const int x_c = (i * kernel_w + j) * 2 + 1;
-                                    offset_h = offset.channel(y_c / offset.elempack).row(h_col)[w_col * offset.elempack + y_c % offset.elempack];
-                                    offset_w = offset.channel(x_c / offset.elempack).row(h_col)[w_col * offset.elempack + x_c % offset.elempack];
-                                }
-                                if (has_mask)
-                                {
-                                    const Mat& mask = bottom_blobs[2];
-                                    if (mask_not_pack)
-                                    {
-                                        mask_ = mask.channel(i * kernel_w + j).row(h_col)[w_col];
-                                    }
-                                    else
-                                    {
-                                        const int m_c = i * kernel_w + j;
-                                        mask_ = mask.channel(m_c / mask.elempack).row(h_col)[w_col * mask.elempack + m_c % mask.elempack];
-                                    }
-                                }
-                                const float h_im = h_in + i * dilation_h + offset_h;
-                                const float w_im = w_in + j * dilation_w + offset_w;
-
-                                // Bilinear
-                                const bool cond = h_im > -1 && w_im > -1 && h_im < h && w_im < w;
-                                int h_low = 0;
-                                int w_low = 0;
-                                int h_high = 0;
-                                int w_high = 0;
-                                float w1 = 0.f;
-                                float w2 = 0.f;
-                                float w3 = 0.f;
-                                float w4 = 0.f;
-                                bool v1_cond = false;
-                                bool v2_cond = false;
-                                bool v3_cond = false;
-                                bool v4_cond = false;
-                                if (cond)
-                                {
-                                    h_low = floor(h_im);
-                                    w_low = floor(w_im);
-                                    h_high = h_low + 1;
-                                    w_high = w_low + 1;
-
-                                    float lh = h_im - h_low;
-                                    float lw = w_im - w_low;
-                                    float hh = 1 - lh;
-                                    float hw = 1 - lw;
-
-                                    v1_cond = (h_low >= 0 && w_low >= 0);
-                                    v2_cond = (h_low >= 0 && w_high <= w - 1);
-                                    v3_cond = (h_high <= h - 1 && w_low >= 0);
-                                    v4_cond = (h_high <= h - 1 && w_high <= w - 1);
-
-                                    w1 = hh * hw;
-                                    w2 = hh * lw;
-                                    w3 = lh * hw;
-                                    w4 = lh * lw;
+                                    const int m_c = i * kernel_w + j;
+                                    mask_ = mask.channel(m_c / mask.elempack).row(h_col)[w_col * mask.elempack + m_c % mask.elempack];
                                 }
+                            }
+                            const float h_im = h_in + i * dilation_h + offset_h;
+                            const float w_im = w_in + j * dilation_w + offset_w;
+
+                            // Bilinear
+                            const bool cond = h_im > -1 && w_im > -1 && h_im < h && w_im < w;
+                            int h_low = 0;
+                            int w_low = 0;
+                            int h_high = 0;
+                            int w_high = 0;
+                            float w1 = 0.f;
+                            float w2 = 0.f;
+                            float w3 = 0.f;
+                            float w4 = 0.f;
+                            bool v1_cond = false;
+                            bool v2_cond = false;
+                            bool v3_cond = false;
+                            bool v4_cond = false;
+                            if (cond)
+                            {
+                                h_low = floor(h_im);
+                                w_low = floor(w_im);
+                                h_high = h_low + 1;
+                                w_high = w_low + 1;
+
+                                float lh = h_im - h_low;
+                                float lw = w_im - w_low;
+                                float hh = 1 - lh;
+                                float hw = 1 - lw;
+
+                                v1_cond = (h_low >= 0 && w_low >= 0);
+                                v2_cond = (h_low >= 0 && w_high <= w - 1);
+                                v3_cond = (h_high <= h - 1 && w_low >= 0);
+                                v4_cond = (h_high <= h - 1 && w_high <= w - 1);
+
+                                w1 = hh * hw;
+                                w2 = hh * lw;
+                                w3 = lh * hw;
+                                w4 = lh * lw;
+                            }
 
-                                for (int ic = 0; ic < channels; ic++)
+                            for (int ic = 0; ic < channels; ic++)
+                            {
+                                float val = 0.f;
+                                if (cond)
                                 {
-                                    float val = 0.f;
-                                    if (cond)
-                                    {
-                                        float v1 = v1_cond ? bottom_blob.channel(ic).row(h_low)[w_low] : 0.f;
-                                        float v2 = v2_cond ? bottom_blob.channel(ic).row(h_low)[w_high] : 0.f;
-                                        float v3 = v3_cond ? bottom_blob.channel(ic).row(h_high)[w_low] : 0.f;
-                                        float v4 = v4_cond ? bottom_blob.channel(ic).row(h_high)[w_high] : 0.f;
-                                        val = w1 * v1 + w2 * v2 + w3 * v3 + w4 * v4;
-                                    }
-                                    sum += val * mask_ * weight_ptr[((oc * channels + ic) * kernel_h + i) * kernel_w + j];
+                                    float v1 = v1_cond ? bottom_blob.channel(ic).row(h_low)[w_low] : 0.f;
+                                    float v2 = v2_cond ? bottom_blob.channel(ic).row(h_low)[w_high] : 0.f;
+                                    float v3 = v3_cond ? bottom_blob.channel(ic).row(h_high)[w_low] : 0.f;
+                                    float v4 = v4_cond ? bottom_blob.channel(ic).row(h_high)[w_high] : 0.f;
+                                    val = w1 * v1 + w2 * v2 + w3 * v3 + w4 * v4;
                                 }
+                                sum += val * mask_ * weight_ptr[((oc * channels + ic) * kernel_h + i) * kernel_w + j];
                             }
                         }
-                        top_blob.channel(oc).row(h_col)[w_col] = activation_ss(sum, activation_type, activation_params);
                     }
+                    top_blob.channel(oc).row(h_col)[w_col] = activation_ss(sum, activation_type, activation_params);
                 }
             }
         }
@@ -0,0 +1,577 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "einsum_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_usability.h"
+
+#include <string.h>
+
+namespace ncnn {
+
+Einsum_x86::Einsum_x86()
+{
+    use_gemm = false;
+}
+
+int Einsum_x86::create_pipeline(const Option& /*opt*/)
+{
+    use_gemm = false;
+
+    if (lhs_tokens.size() != 2)
+        return 0;
+
+    const std::string& a_token = lhs_tokens[0];
+    const std::string& b_token = lhs_tokens[1];
+
+    // diagonal indexing is left to the reference implementation
+    const std::string* tokens[3] = {&a_token, &b_token, &rhs_token};
+    for (int t = 0; t < 3; t++)
+    {
+        const std::string& token = *tokens[t];
+        for (size_t i = 0; i < token.size(); i++)
+        {
+            if (token.find(token[i], i + 1) != std::string::npos)
+                return 0;
+        }
+    }
+
+    batch_token.clear();
+    m_token.clear();
+    n_token.clear();
+    k_token.clear();
+
+    // batch m n follow the output order so that the result lands in place
+    for (size_t i = 0; i < rhs_token.size(); i++)
+    {
+        const char x = rhs_token[i];
+        const bool in_a = a_token.find(x) != std::string::npos;
+        const bool in_b = b_token.find(x) != std::string::npos;
+
+        if (in_a && in_b) batch_token += x;
+        if (in_a && !in_b) m_token += x;
+        if (!in_a && in_b) n_token += x;
+        if (!in_a && !in_b)
+            return 0;
+    }
+
+    for (size_t i = 0; i < a_token.size(); i++)
+    {
+        const char x = a_token[i];
+        if (rhs_token.find(x) != std::string::npos)
+            continue;
+
+        // summing over an index of one operand only
+        if (b_token.find(x) == std::string::npos)
+            return 0;
+
+        k_token += x;
+    }
+
+    for (size_t i = 0; i < b_token.size(); i++)
+    {
+        const char x = b_token[i];
+        if (rhs_token.find(x) == std::string::npos && a_token.find(x) == std::string::npos)
+            return 0;
+    }
+
+    use_gemm = true;
+
+    return 0;
+}
+
+// element stride of every token position, outermost first
+static void get_token_strides(const Mat& m, int* strides)
+{
+    const int dims = m.dims;
+
+    if (dims == 1)
+    {
+        strides[0] = 1;
+    }
+    if (dims == 2)
+    {
+        strides[0] = m.w;
+        strides[1] = 1;
+    }
+    if (dims == 3)
+    {
+        strides[0] = (int)m.cstep;
+        strides[1] = m.w;
+        strides[2] = 1;
+    }
+    if (dims == 4)
+    {
+        strides[0] = (int)m.cstep;
+        strides[1] = m.w * m.h;
+        strides[2] = m.w;
+        strides[3] = 1;
+    }
+}
+
+// copy n-dimensional strided block, innermost axis last
+static void einsum_copy(const float* ptr, const int* strides, float* outptr, const int* out_strides, const int* sizes, int n)
+{
+    if (n == 0)
+    {
+        outptr[0] = ptr[0];
+        return;
+    }
+
+    int total = 1;
+    for (int t = 0; t < n - 1; t++)
+    {
+        total *= sizes[t];
+    }
+
+    const int size = sizes[n - 1];
+    const int stride = strides[n - 1];
+    const int out_stride = out_strides[n - 1];
+
+    int index[16] = {0};
+    for (int i = 0; i < total; i++)
+    {
+        const float* p0 = ptr;
+        float* outp0 = outptr;
+        for (int t = 0; t < n - 1; t++)
+        {
+            p0 += index[t] * strides[t];
+            outp0 += index[t] * out_strides[t];
+        }
+
+        if (stride == 1 && out_stride == 1)
+        {
+            memcpy(outp0, p0, size * sizeof(float));
+        }
+        else
+        {
+            for (int j = 0; j < size; j++)
+            {
+                outp0[j * out_stride] = p0[j * stride];
+            }
+        }
+
+        // odometer
+        for (int t = n - 2; t >= 0; t--)
+        {
+            index[t]++;
+            if (index[t] < sizes[t])
+                break;
+
+            index[t] = 0;
+        }
+    }
+}
+
+// resolve the size and the stride in m of each letter in order
+static void resolve_order(const Mat& m, const std::string& token, const std::string& order, const int* dim_sizes, int* sizes, int* strides)
+{
+    int token_strides[4];
+    get_token_strides(m, token_strides);
+
+    for (size_t t = 0; t < order.size(); t++)
+    {
+        sizes[t] = dim_sizes[order[t] - 'i'];
+        strides[t] = token_strides[token.find(order[t])];
+    }
+}
+
+static void contiguous_strides(const int* sizes, int n, int* strides)
+{
+    int stride = 1;
+    for (int t = n - 1; t >= 0; t--)
+    {
+        strides[t] = stride;
+        stride *= sizes[t];
+    }
+}
+
+// the operand can be read as [batch][rows][cols] in place,
+// where only the single batch axis may carry the channel step
+static bool is_gemm_layout(const Mat& m, const std::string& token, const std::string& batch_token, const std::string& order)
+{
+    if (token != order)
+        return false;
+
+    return m.dims <= 2 || batch_token.size() == 1;
+}
+
+static void einsum_gemm_row4(const float* A, int K, const float* B, int N, float* C)
+{
+    const float* A0 = A;
+    const float* A1 = A + K;
+    const float* A2 = A + K * 2;
+    const float* A3 = A + K * 3;
+    float* C0 = C;
+    float* C1 = C + N;
+    float* C2 = C + N * 2;
+    float* C3 = C + N * 3;
+
+    int j = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; j + 15 < N; j += 16)
+    {
+        __m512 _sum0 = _mm512_setzero_ps();
+        __m512 _sum1 = _mm512_setzero_ps();
+        __m512 _sum2 = _mm512_setzero_ps();
+        __m512 _sum3 = _mm512_setzero_ps();
+
+        const float* pB = B + j;
+        for (int k = 0; k < K; k++)
+        {
+            __m512 _b = _mm512_loadu_ps(pB);
+            _sum0 = _mm512_fmadd_ps(_mm512_set1_ps(A0[k]), _b, _sum0);
+            _sum1 = _mm512_fmadd_ps(_mm512_set1_ps(A1[k]), _b, _sum1);
+            _sum2 = _mm512_fmadd_ps(_mm512_set1_ps(A2[k]), _b, _sum2);
+            _sum3 = _mm512_fmadd_ps(_mm512_set1_ps(A3[k]), _b, _sum3);
+            pB += N;
+        }
+
+        _mm512_storeu_ps(C0 + j, _sum0);
+        _mm512_storeu_ps(C1 + j, _sum1);
+        _mm512_storeu_ps(C2 + j, _sum2);
+        _mm512_storeu_ps(C3 + j, _sum3);
+    }
+#endif // __AVX512F__
+    for (; j + 7 < N; j += 8)
+    {
+        __m256 _sum0 = _mm256_setzero_ps();
+        __m256 _sum1 = _mm256_setzero_ps();
+        __m256 _sum2 = _mm256_setzero_ps();
+        __m256 _sum3 = _mm256_setzero_ps();
+
+        const float* pB = B + j;
+        for (int k = 0; k < K; k++)
+        {
+            __m256 _b = _mm256_loadu_ps(pB);
+            _sum0 = _mm256_comp_fmadd_ps(_mm256_set1_ps(A0[k]), _b, _sum0);
+            _sum1 = _mm256_comp_fmadd_ps(_mm256_set1_ps(A1[k]), _b, _sum1);
+            _sum2 = _mm256_comp_fmadd_ps(_mm256_set1_ps(A2[k]), _b, _sum2);
+            _sum3 = _mm256_comp_fmadd_ps(_mm256_set1_ps(A3[k]), _b, _sum3);
+            pB += N;
+        }
+
+        _mm256_storeu_ps(C0 + j, _sum0);
+        _mm256_storeu_ps(C1 + j, _sum1);
+        _mm256_storeu_ps(C2 + j, _sum2);
+        _mm256_storeu_ps(C3 + j, _sum3);
+    }
+#endif // __AVX__
+    for (; j + 3 < N; j += 4)
+    {
+        __m128 _sum0 = _mm_setzero_ps();
+        __m128 _sum1 = _mm_setzero_ps();
+        __m128 _sum2 = _mm_setzero_ps();
+        __m128 _sum3 = _mm_setzero_ps();
+
+        const float* pB = B + j;
+        for (int k = 0; k < K; k++)
+        {
+            __m128 _b = _mm_loadu_ps(pB);
+            _sum0 = _mm_comp_fmadd_ps(_mm_set1_ps(A0[k]), _b, _sum0);
+            _sum1 = _mm_comp_fmadd_ps(_mm_set1_ps(A1[k]), _b, _sum1);
+            _sum2 = _mm_comp_fmadd_ps(_mm_set1_ps(A2[k]), _b, _sum2);
+            _sum3 = _mm_comp_fmadd_ps(_mm_set1_ps(A3[k]), _b, _sum3);
+            pB += N;
+        }
+
+        _mm_storeu_ps(C0 + j, _sum0);
+        _mm_storeu_ps(C1 + j, _sum1);
+        _mm_storeu_ps(C2 + j, _sum2);
+        _mm_storeu_ps(C3 + j, _sum3);
+    }
+#endif // __SSE2__
+    for (; j < N; j++)
+    {
+        float sum0 = 0.f;
+        float sum1 = 0.f;
+        float sum2 = 0.f;
+        float sum3 = 0.f;
+
+        const float* pB = B + j;
+        for (int k = 0; k < K; k++)
+        {
+            sum0 += A0[k] * pB[0];
+            sum1 += A1[k] * pB[0];
+            sum2 += A2[k] * pB[0];
+            sum3 += A3[k] * pB[0];
+            pB += N;
+        }
+
+        C0[j] = sum0;
+        C1[j] = sum1;
+        C2[j] = sum2;
+        C3[j] = sum3;
+    }
+}
+
+static void einsum_gemm_row1(const float* A, int K, const float* B, int N, float* C)
+{
+    int j = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; j + 15 < N; j += 16)
+    {
+        __m512 _sum = _mm512_setzero_ps();
+
+        const float* pB = B + j;
+        for (int k = 0; k < K; k++)
+        {
+            _sum = _mm512_fmadd_ps(_mm512_set1_ps(A[k]), _mm512_loadu_ps(pB), _sum);
+            pB += N;
+        }
+
+        _mm512_storeu_ps(C + j, _sum);
+    }
+#endif // __AVX512F__
+    for (; j + 7 < N; j += 8)
+    {
+        __m256 _sum = _mm256_setzero_ps();
+
+        const float* pB = B + j;
+        for (int k = 0; k < K; k++)
+        {
+            _sum = _mm256_comp_fmadd_ps(_mm256_set1_ps(A[k]), _mm256_loadu_ps(pB), _sum);
+            pB += N;
+        }
+
+        _mm256_storeu_ps(C + j, _sum);
+    }
+#endif // __AVX__
+    for (; j + 3 < N; j += 4)
+    {
+        __m128 _sum = _mm_setzero_ps();
+
+        const float* pB = B + j;
+        for (int k = 0; k < K; k++)
+        {
+            _sum = _mm_comp_fmadd_ps(_mm_set1_ps(A[k]), _mm_loadu_ps(pB), _sum);
+            pB += N;
+        }
+
+        _mm_storeu_ps(C + j, _sum);
+    }
+#endif // __SSE2__
+    for (; j < N; j++)
+    {
+        float sum = 0.f;
+
+        const float* pB = B + j;
+        for (int k = 0; k < K; k++)
+        {
+            sum += A[k] * pB[0];
+            pB += N;
+        }
+
+        C[j] = sum;
+    }
+}
+
+// C[b] = A[b] * B[b] with A[b] M x K, B[b] K x N and C[b] M x N row-major
+static void einsum_gemm(const float* A, size_t A_bstride, const float* B, size_t B_bstride, float* C, size_t C_bstride, int batch, int M, int N, int K, const Option& opt)
+{
+    const int nn_M = (M + 3) / 4;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int ii = 0; ii < batch * nn_M; ii++)
+    {
+        const int b = ii / nn_M;
+        const int i = ii % nn_M * 4;
+
+        const float* pA = A + A_bstride * b + i * K;
+        const float* pB = B + B_bstride * b;
+        float* pC = C + C_bstride * b + i * N;
+
+        if (i + 3 < M)
+        {
+            einsum_gemm_row4(pA, K, pB, N, pC);
+        }
+        else
+        {
+            for (int r = i; r < M; r++)
+            {
+                einsum_gemm_row1(pA, K, pB, N, pC);
+                pA += K;
+                pC += N;
+            }
+        }
+    }
+}
+
+int Einsum_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    if (!use_gemm)
+        return Einsum::forward(bottom_blobs, top_blobs, opt);
+
+    const Mat& A = bottom_blobs[0];
+    const Mat& B = bottom_blobs[1];
+    const std::string& a_token = lhs_tokens[0];
+    const std::string& b_token = lhs_tokens[1];
+
+    size_t elemsize = A.elemsize;
+
+    // resolve dimension sizes
+    int dim_sizes[16];
+    for (int i = 0; i < 16; i++)
+    {
+        dim_sizes[i] = 1;
+    }
+    for (int t = 0; t < 2; t++)
+    {
+        const Mat& m = bottom_blobs[t];
+        const std::string& token = lhs_tokens[t];
+        const int dims = m.dims;
+
+        int shape[4] = {m.w, 1, 1, 1};
+        if (dims == 2)
+        {
+            shape[0] = m.h;
+            shape[1] = m.w;
+        }
+        if (dims == 3)
+        {
+            shape[0] = m.c;
+            shape[1] = m.h;
+            shape[2] = m.w;
+        }
+        if (dims == 4)
+        {
+            shape[0] = m.c;
+            shape[1] = m.d;
+            shape[2] = m.h;
+            shape[3] = m.w;
+        }
+
+        for (int s = 0; s < dims; s++)
+        {
+            dim_sizes[token[s] - 'i'] = shape[s];
+        }
+    }
+
+    int batch = 1;
+    int M = 1;
+    int N = 1;
+    int K = 1;
+    for (size_t i = 0; i < batch_token.size(); i++) batch *= dim_sizes[batch_token[i] - 'i'];
+    for (size_t i = 0; i < m_token.size(); i++) M *= dim_sizes[m_token[i] - 'i'];
+    for (size_t i = 0; i < n_token.size(); i++) N *= dim_sizes[n_token[i] - 'i'];
+    for (size_t i = 0; i < k_token.size(); i++) K *= dim_sizes[k_token[i] - 'i'];
+
+    const int out_dims = (int)rhs_token.size();
+
+    Mat& top_blob = top_blobs[0];
+    {
+        int outshape[4];
+        for (int s = 0; s < out_dims; s++)
+        {
+            outshape[s] = dim_sizes[rhs_token[s] - 'i'];
+        }
+
+        if (out_dims == 1)
+            top_blob.create(outshape[0], elemsize, opt.blob_allocator);
+        if (out_dims == 2)
+            top_blob.create(outshape[1], outshape[0], elemsize, opt.blob_allocator);
+        if (out_dims == 3)
+            top_blob.create(outshape[2], outshape[1], outshape[0], elemsize, opt.blob_allocator);
+        if (out_dims == 4)
+            top_blob.create(outshape[3], outshape[2], outshape[1], outshape[0], elemsize, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+    }
+
+    int sizes[16];
+    int strides[16];
+    int out_strides[16];
+
+    // lay out A as [batch][m][k]
+    const std::string a_order = batch_token + m_token + k_token;
+    const float* pA = A;
+    size_t A_bstride = (size_t)M * K;
+    Mat A_gemm;
+    if (is_gemm_layout(A, a_token, batch_token, a_order))
+    {
+        if (A.dims >= 3) A_bstride = A.cstep;
+    }
+    else
+    {
+        A_gemm.create(M * K * batch, 4u, opt.workspace_allocator);
+        if (A_gemm.empty())
+            return -100;
+
+        const int n = (int)a_order.size();
+        resolve_order(A, a_token, a_order, dim_sizes, sizes, strides);
+        contiguous_strides(sizes, n, out_strides);
+        einsum_copy(A, strides, A_gemm, out_strides, sizes, n);
+        pA = A_gemm;
+    }
+
+    // lay out B as [batch][k][n]
+    const std::string b_order = batch_token + k_token + n_token;
+    const float* pB = B;
+    size_t B_bstride = (size_t)K * N;
+    Mat B_gemm;
+    if (is_gemm_layout(B, b_token, batch_token, b_order))
+    {
+        if (B.dims >= 3) B_bstride = B.cstep;
+    }
+    else
+    {
+        B_gemm.create(K * N * batch, 4u, opt.workspace_allocator);
+        if (B_gemm.empty())
+            return -100;
+
+        const int n = (int)b_order.size();
+        resolve_order(B, b_token, b_order, dim_sizes, sizes, strides);
+        contiguous_strides(sizes, n, out_strides);
+        einsum_copy(B, strides, B_gemm, out_strides, sizes, n);
+        pB = B_gemm;
+    }
+
+    // write C straight into top_blob when the output is [batch][m][n] already
+    const std::string c_order = batch_token + m_token + n_token;
+    if (is_gemm_layout(top_blob, rhs_token, batch_token, c_order))
+    {
+        const size_t C_bstride = top_blob.dims >= 3 ? top_blob.cstep : (size_t)M * N;
+        einsum_gemm(pA, A_bstride, pB, B_bstride, top_blob, C_bstride, batch, M, N, K, opt);
+        return 0;
+    }
+
+    Mat C_gemm(M * N * batch, 4u, opt.workspace_allocator);
+    if (C_gemm.empty())
+        return -100;
+
+    einsum_gemm(pA, A_bstride, pB, B_bstride, C_gemm, (size_t)M * N, batch, M, N, K, opt);
+
+    // scatter C to the output order
+    {
+        const int n = (int)c_order.size();
+        resolve_order(top_blob, rhs_token, c_order, dim_sizes, sizes, out_strides);
+        contiguous_strides(sizes, n, strides);
+        einsum_copy(C_gemm, strides, top_blob, out_strides, sizes, n);
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
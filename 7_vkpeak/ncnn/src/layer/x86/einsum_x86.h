@@ -0,0 +1,42 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef LAYER_EINSUM_X86_H
+#define LAYER_EINSUM_X86_H
+
+#include "einsum.h"
+
+namespace ncnn {
+
+class Einsum_x86 : virtual public Einsum
+{
+public:
+    Einsum_x86();
+
+    virtual int create_pipeline(const Option& opt);
+
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
+public:
+    // two operand contraction lowered to C[batch][m][n] = A[batch][m][k] * B[batch][k][n]
+    bool use_gemm;
+    std::string batch_token;
+    std::string m_token;
+    std::string n_token;
+    std::string k_token;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_EINSUM_X86_H
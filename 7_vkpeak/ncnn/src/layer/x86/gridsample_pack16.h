@@ -0,0 +1,160 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+static NCNN_FORCEINLINE __m512 gridsample_load_pack16(const float* ptr, int offset)
+{
+    return offset >= 0 ? _mm512_loadu_ps(ptr + offset * 16) : _mm512_setzero_ps();
+}
+
+static void gridsample_bilinear_pack16(const Mat& bottom_blob, Mat& top_blob, const Mat& offset_blob, const Mat& value_blob, int taps, const Option& opt)
+{
+    const int channels = bottom_blob.c;
+    const int size = top_blob.w * top_blob.h * top_blob.d;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const float* ptr = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        const int* offsetptr = offset_blob;
+        const float* valueptr = value_blob;
+
+        // 2 interpolation weights for 2d, 3 for 3d
+        const int ncoord = taps == 4 ? 2 : 3;
+
+        for (int i = 0; i < size; i++)
+        {
+            if (i + 1 < size)
+            {
+                _mm_prefetch((const char*)(ptr + std::max(offsetptr[taps], 0) * 16), _MM_HINT_T0);
+                _mm_prefetch((const char*)(ptr + std::max(offsetptr[taps + 2], 0) * 16), _MM_HINT_T0);
+            }
+
+            __m512 _alpha = _mm512_set1_ps(valueptr[0]);
+            __m512 _beta = _mm512_set1_ps(valueptr[1]);
+            __m512 _alpha0 = _mm512_set1_ps(1.f - valueptr[0]);
+            __m512 _beta0 = _mm512_set1_ps(1.f - valueptr[1]);
+
+            __m512 _v00 = gridsample_load_pack16(ptr, offsetptr[0]);
+            __m512 _v01 = gridsample_load_pack16(ptr, offsetptr[1]);
+            __m512 _v10 = gridsample_load_pack16(ptr, offsetptr[2]);
+            __m512 _v11 = gridsample_load_pack16(ptr, offsetptr[3]);
+
+            __m512 _v0 = _mm512_fmadd_ps(_v01, _alpha, _mm512_mul_ps(_v00, _alpha0));
+            __m512 _v1 = _mm512_fmadd_ps(_v11, _alpha, _mm512_mul_ps(_v10, _alpha0));
+            __m512 _v = _mm512_fmadd_ps(_v1, _beta, _mm512_mul_ps(_v0, _beta0));
+
+            if (ncoord == 3)
+            {
+                __m512 _gamma = _mm512_set1_ps(valueptr[2]);
+                __m512 _gamma0 = _mm512_set1_ps(1.f - valueptr[2]);
+
+                __m512 _v100 = gridsample_load_pack16(ptr, offsetptr[4]);
+                __m512 _v101 = gridsample_load_pack16(ptr, offsetptr[5]);
+                __m512 _v110 = gridsample_load_pack16(ptr, offsetptr[6]);
+                __m512 _v111 = gridsample_load_pack16(ptr, offsetptr[7]);
+
+                __m512 _v10_ = _mm512_fmadd_ps(_v101, _alpha, _mm512_mul_ps(_v100, _alpha0));
+                __m512 _v11_ = _mm512_fmadd_ps(_v111, _alpha, _mm512_mul_ps(_v110, _alpha0));
+                __m512 _v1_ = _mm512_fmadd_ps(_v11_, _beta, _mm512_mul_ps(_v10_, _beta0));
+
+                _v = _mm512_fmadd_ps(_v1_, _gamma, _mm512_mul_ps(_v, _gamma0));
+            }
+
+            _mm512_storeu_ps(outptr, _v);
+
+            outptr += 16;
+            offsetptr += taps;
+            valueptr += ncoord;
+        }
+    }
+}
+
+static void gridsample_nearest_pack16(const Mat& bottom_blob, Mat& top_blob, const Mat& offset_blob, const Option& opt)
+{
+    const int channels = bottom_blob.c;
+    const int size = top_blob.w * top_blob.h * top_blob.d;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const float* ptr = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        const int* offsetptr = offset_blob;
+
+        for (int i = 0; i < size; i++)
+        {
+            _mm512_storeu_ps(outptr, gridsample_load_pack16(ptr, offsetptr[0]));
+
+            outptr += 16;
+            offsetptr += 1;
+        }
+    }
+}
+
+static void gridsample_bicubic_pack16(const Mat& bottom_blob, Mat& top_blob, const Mat& offset_blob, const Mat& value_blob, const Option& opt)
+{
+    const int channels = bottom_blob.c;
+    const int size = top_blob.w * top_blob.h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const float* ptr = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        const int* offsetptr = offset_blob;
+        const float* valueptr = value_blob;
+
+        for (int i = 0; i < size; i++)
+        {
+            if (i + 1 < size)
+            {
+                _mm_prefetch((const char*)(ptr + std::max(offsetptr[16], 0) * 16), _MM_HINT_T0);
+                _mm_prefetch((const char*)(ptr + std::max(offsetptr[20], 0) * 16), _MM_HINT_T0);
+                _mm_prefetch((const char*)(ptr + std::max(offsetptr[24], 0) * 16), _MM_HINT_T0);
+                _mm_prefetch((const char*)(ptr + std::max(offsetptr[28], 0) * 16), _MM_HINT_T0);
+            }
+
+            __m512 _x_coeff0 = _mm512_set1_ps(valueptr[0]);
+            __m512 _x_coeff1 = _mm512_set1_ps(valueptr[1]);
+            __m512 _x_coeff2 = _mm512_set1_ps(valueptr[2]);
+            __m512 _x_coeff3 = _mm512_set1_ps(valueptr[3]);
+
+            __m512 _v = _mm512_setzero_ps();
+            for (int k = 0; k < 4; k++)
+            {
+                __m512 _v0 = gridsample_load_pack16(ptr, offsetptr[k * 4 + 0]);
+                __m512 _v1 = gridsample_load_pack16(ptr, offsetptr[k * 4 + 1]);
+                __m512 _v2 = gridsample_load_pack16(ptr, offsetptr[k * 4 + 2]);
+                __m512 _v3 = gridsample_load_pack16(ptr, offsetptr[k * 4 + 3]);
+
+                __m512 _row = _mm512_mul_ps(_v0, _x_coeff0);
+                _row = _mm512_fmadd_ps(_v1, _x_coeff1, _row);
+                _row = _mm512_fmadd_ps(_v2, _x_coeff2, _row);
+                _row = _mm512_fmadd_ps(_v3, _x_coeff3, _row);
+
+                _v = _mm512_fmadd_ps(_row, _mm512_set1_ps(valueptr[4 + k]), _v);
+            }
+
+            _mm512_storeu_ps(outptr, _v);
+
+            outptr += 16;
+            offsetptr += 16;
+            valueptr += 8;
+        }
+    }
+}
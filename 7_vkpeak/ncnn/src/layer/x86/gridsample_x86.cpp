@@ -0,0 +1,506 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "gridsample_x86.h"
+
+#include <math.h>
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#if __SSE2__
+#include "gridsample_pack4.h"
+#if __AVX__
+#include "gridsample_pack8.h"
+#if __AVX512F__
+#include "gridsample_pack16.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+
+GridSample_x86::GridSample_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+static float grid_sample_unormalize(int w, float coordx, int align_corner)
+{
+    return align_corner ? (coordx + 1) / 2.f * (w - 1) : ((coordx + 1) * w - 1) / 2.f;
+}
+
+static float border_coord(int x, int border)
+{
+    return std::min(border, std::max(x, 0));
+}
+
+static float reflect_coord(float x, int high)
+{
+    x = abs(x);
+    x = high - abs(x - high);
+    return x;
+}
+
+static int compute_coord(int sx, int w, int padding_mode, int align_corner)
+{
+    if (padding_mode == 2) // border
+    {
+        sx = border_coord(sx, w - 1);
+    }
+    else if (padding_mode == 3) // reflection
+    {
+        if (align_corner)
+        {
+            sx = reflect_coord(sx, w - 1);
+        }
+        else
+        {
+            sx = static_cast<int>(reflect_coord(sx + 0.5, w) - 0.5);
+            sx = border_coord(sx, w - 1);
+        }
+    }
+
+    return sx;
+}
+
+// element offset of the padded sample location, -1 for zero padding
+static int compute_offset(int x, int y, int w, int h, int padding_mode, int align_corner)
+{
+    x = compute_coord(x, w, padding_mode, align_corner);
+    y = compute_coord(y, h, padding_mode, align_corner);
+
+    if (x < 0 || y < 0 || x >= w || y >= h)
+        return -1;
+
+    return y * w + x;
+}
+
+static int compute_offset(int x, int y, int z, int w, int h, int d, int padding_mode, int align_corner)
+{
+    x = compute_coord(x, w, padding_mode, align_corner);
+    y = compute_coord(y, h, padding_mode, align_corner);
+    z = compute_coord(z, d, padding_mode, align_corner);
+
+    if (x < 0 || y < 0 || z < 0 || x >= w || y >= h || z >= d)
+        return -1;
+
+    return (z * h + y) * w + x;
+}
+
+static inline void interpolate_cubic(float fx, float* coeffs)
+{
+    const float A = -0.75f;
+
+    float fx0 = fx + 1;
+    float fx1 = fx;
+    float fx2 = 1 - fx;
+    // float fx3 = 2 - fx;
+
+    coeffs[0] = A * fx0 * fx0 * fx0 - 5 * A * fx0 * fx0 + 8 * A * fx0 - 4 * A;
+    coeffs[1] = (A + 2) * fx1 * fx1 * fx1 - (A + 3) * fx1 * fx1 + 1;
+    coeffs[2] = (A + 2) * fx2 * fx2 * fx2 - (A + 3) * fx2 * fx2 + 1;
+    coeffs[3] = 1.f - coeffs[0] - coeffs[1] - coeffs[2];
+}
+
+// the sampling offsets and interpolation weights only depend on the grid,
+// resolve them once per output location and share them across all channels
+static void gridsample_2d_compute_blob(const Mat& grid, Mat& offset_blob, Mat& value_blob, int w, int h, int sample_type, int padding_mode, int align_corner, const Option& opt)
+{
+    const int outw = grid.h;
+    const int outh = grid.c;
+
+    const int taps = sample_type == 1 ? 4 : sample_type == 2 ? 1 : 16;
+    const int nvalue = sample_type == 1 ? 2 : sample_type == 2 ? 0 : 8;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int y = 0; y < outh; y++)
+    {
+        const float* gridptr = grid.channel(y);
+        int* offsetptr = (int*)offset_blob + y * outw * taps;
+        float* valueptr = (float*)value_blob + y * outw * nvalue;
+
+        for (int x = 0; x < outw; x++)
+        {
+            float sample_x = grid_sample_unormalize(w, gridptr[0], align_corner);
+            float sample_y = grid_sample_unormalize(h, gridptr[1], align_corner);
+
+            if (sample_type == 1) // bilinear
+            {
+                int x0 = (int)floor(sample_x);
+                int y0 = (int)floor(sample_y);
+                int x1 = x0 + 1;
+                int y1 = y0 + 1;
+
+                offsetptr[0] = compute_offset(x0, y0, w, h, padding_mode, align_corner);
+                offsetptr[1] = compute_offset(x1, y0, w, h, padding_mode, align_corner);
+                offsetptr[2] = compute_offset(x0, y1, w, h, padding_mode, align_corner);
+                offsetptr[3] = compute_offset(x1, y1, w, h, padding_mode, align_corner);
+
+                valueptr[0] = sample_x - x0;
+                valueptr[1] = sample_y - y0;
+            }
+            else if (sample_type == 2) // nearest
+            {
+                int x0 = static_cast<int>(round(sample_x));
+                int y0 = static_cast<int>(round(sample_y));
+
+                offsetptr[0] = compute_offset(x0, y0, w, h, padding_mode, align_corner);
+            }
+            else // if (sample_type == 3) // bicubic
+            {
+                int x1 = floor(sample_x);
+                int y1 = floor(sample_y);
+
+                for (int i = 0; i < 4; i++)
+                {
+                    for (int j = 0; j < 4; j++)
+                    {
+                        offsetptr[i * 4 + j] = compute_offset(x1 - 1 + j, y1 - 1 + i, w, h, padding_mode, align_corner);
+                    }
+                }
+
+                interpolate_cubic(sample_x - x1, valueptr);
+                interpolate_cubic(sample_y - y1, valueptr + 4);
+            }
+
+            gridptr += 2;
+            offsetptr += taps;
+            valueptr += nvalue;
+        }
+    }
+}
+
+static void gridsample_3d_compute_blob(const Mat& grid, Mat& offset_blob, Mat& value_blob, int w, int h, int d, int sample_type, int padding_mode, int align_corner, const Option& opt)
+{
+    const int outw = grid.h;
+    const int outh = grid.d;
+    const int outd = grid.c;
+
+    const int taps = sample_type == 1 ? 8 : 1;
+    const int nvalue = sample_type == 1 ? 3 : 0;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int z = 0; z < outd; z++)
+    {
+        const float* gridptr = grid.channel(z);
+        int* offsetptr = (int*)offset_blob + z * outh * outw * taps;
+        float* valueptr = (float*)value_blob + z * outh * outw * nvalue;
+
+        for (int i = 0; i < outh * outw; i++)
+        {
+            float sample_x = grid_sample_unormalize(w, gridptr[0], align_corner);
+            float sample_y = grid_sample_unormalize(h, gridptr[1], align_corner);
+            float sample_z = grid_sample_unormalize(d, gridptr[2], align_corner);
+
+            if (sample_type == 1) // bilinear
+            {
+                int x0 = (int)floor(sample_x);
+                int y0 = (int)floor(sample_y);
+                int z0 = (int)floor(sample_z);
+                int x1 = x0 + 1;
+                int y1 = y0 + 1;
+                int z1 = z0 + 1;
+
+                offsetptr[0] = compute_offset(x0, y0, z0, w, h, d, padding_mode, align_corner);
+                offsetptr[1] = compute_offset(x1, y0, z0, w, h, d, padding_mode, align_corner);
+                offsetptr[2] = compute_offset(x0, y1, z0, w, h, d, padding_mode, align_corner);
+                offsetptr[3] = compute_offset(x1, y1, z0, w, h, d, padding_mode, align_corner);
+                offsetptr[4] = compute_offset(x0, y0, z1, w, h, d, padding_mode, align_corner);
+                offsetptr[5] = compute_offset(x1, y0, z1, w, h, d, padding_mode, align_corner);
+                offsetptr[6] = compute_offset(x0, y1, z1, w, h, d, padding_mode, align_corner);
+                offsetptr[7] = compute_offset(x1, y1, z1, w, h, d, padding_mode, align_corner);
+
+                valueptr[0] = sample_x - x0;
+                valueptr[1] = sample_y - y0;
+                valueptr[2] = sample_z - z0;
+            }
+            else // if (sample_type == 2) // nearest
+            {
+                int x0 = static_cast<int>(round(sample_x));
+                int y0 = static_cast<int>(round(sample_y));
+                int z0 = static_cast<int>(round(sample_z));
+
+                offsetptr[0] = compute_offset(x0, y0, z0, w, h, d, padding_mode, align_corner);
+            }
+
+            gridptr += 3;
+            offsetptr += taps;
+            valueptr += nvalue;
+        }
+    }
+}
+
+static inline float gridsample_load(const float* ptr, int offset)
+{
+    return offset >= 0 ? ptr[offset] : 0.f;
+}
+
+static void gridsample_bilinear(const Mat& bottom_blob, Mat& top_blob, const Mat& offset_blob, const Mat& value_blob, int taps, const Option& opt)
+{
+    const int channels = bottom_blob.c;
+    const int size = top_blob.w * top_blob.h * top_blob.d;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const float* ptr = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        const int* offsetptr = offset_blob;
+        const float* valueptr = value_blob;
+
+        // 2 interpolation weights for 2d, 3 for 3d
+        const int ncoord = taps == 4 ? 2 : 3;
+
+        for (int i = 0; i < size; i++)
+        {
+            float alpha = valueptr[0];
+            float beta = valueptr[1];
+
+            float v00 = gridsample_load(ptr, offsetptr[0]);
+            float v01 = gridsample_load(ptr, offsetptr[1]);
+            float v10 = gridsample_load(ptr, offsetptr[2]);
+            float v11 = gridsample_load(ptr, offsetptr[3]);
+
+            float v0 = v00 * (1 - alpha) + v01 * alpha;
+            float v1 = v10 * (1 - alpha) + v11 * alpha;
+            float v = v0 * (1 - beta) + v1 * beta;
+
+            if (ncoord == 3)
+            {
+                float gamma = valueptr[2];
+
+                float v100 = gridsample_load(ptr, offsetptr[4]);
+                float v101 = gridsample_load(ptr, offsetptr[5]);
+                float v110 = gridsample_load(ptr, offsetptr[6]);
+                float v111 = gridsample_load(ptr, offsetptr[7]);
+
+                float v10_ = v100 * (1 - alpha) + v101 * alpha;
+                float v11_ = v110 * (1 - alpha) + v111 * alpha;
+                float v1_ = v10_ * (1 - beta) + v11_ * beta;
+
+                v = v * (1 - gamma) + v1_ * gamma;
+            }
+
+            outptr[0] = v;
+
+            outptr += 1;
+            offsetptr += taps;
+            valueptr += ncoord;
+        }
+    }
+}
+
+static void gridsample_nearest(const Mat& bottom_blob, Mat& top_blob, const Mat& offset_blob, const Option& opt)
+{
+    const int channels = bottom_blob.c;
+    const int size = top_blob.w * top_blob.h * top_blob.d;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const float* ptr = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        const int* offsetptr = offset_blob;
+
+        for (int i = 0; i < size; i++)
+        {
+            outptr[i] = gridsample_load(ptr, offsetptr[i]);
+        }
+    }
+}
+
+static void gridsample_bicubic(const Mat& bottom_blob, Mat& top_blob, const Mat& offset_blob, const Mat& value_blob, const Option& opt)
+{
+    const int channels = bottom_blob.c;
+    const int size = top_blob.w * top_blob.h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const float* ptr = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        const int* offsetptr = offset_blob;
+        const float* valueptr = value_blob;
+
+        for (int i = 0; i < size; i++)
+        {
+            const float* x_coeffs = valueptr;
+            const float* y_coeffs = valueptr + 4;
+
+            float v = 0.f;
+            for (int k = 0; k < 4; k++)
+            {
+                float v0 = gridsample_load(ptr, offsetptr[k * 4 + 0]);
+                float v1 = gridsample_load(ptr, offsetptr[k * 4 + 1]);
+                float v2 = gridsample_load(ptr, offsetptr[k * 4 + 2]);
+                float v3 = gridsample_load(ptr, offsetptr[k * 4 + 3]);
+
+                v += (v0 * x_coeffs[0] + v1 * x_coeffs[1] + v2 * x_coeffs[2] + v3 * x_coeffs[3]) * y_coeffs[k];
+            }
+
+            outptr[0] = v;
+
+            outptr += 1;
+            offsetptr += 16;
+            valueptr += 8;
+        }
+    }
+}
+
+int GridSample_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+    const Mat& grid = bottom_blobs[1];
+    Mat& top_blob = top_blobs[0];
+
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int d = bottom_blob.d;
+    int channels = bottom_blob.c;
+    int dims = bottom_blob.dims;
+    size_t elemsize = bottom_blob.elemsize;
+    int elempack = bottom_blob.elempack;
+
+    if (dims == 4 && sample_type == 3)
+    {
+        NCNN_LOGE("unsupported bicubic when dims == 4");
+        return -1;
+    }
+
+    // grid is addressed per output location, keep it unpacked
+    Mat grid_unpacked = grid;
+    if (grid.elempack != 1)
+    {
+        Option opt_p = opt;
+        opt_p.blob_allocator = opt.workspace_allocator;
+        convert_packing(grid, grid_unpacked, 1, opt_p);
+        if (grid_unpacked.empty())
+            return -100;
+    }
+
+    int taps = 0;
+    int nvalue = 0;
+    int outsize = 0;
+
+    if (dims == 3)
+    {
+        int outw = grid_unpacked.h;
+        int outh = grid_unpacked.c;
+
+        top_blob.create(outw, outh, channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        taps = sample_type == 1 ? 4 : sample_type == 2 ? 1 : 16;
+        nvalue = sample_type == 1 ? 2 : sample_type == 2 ? 0 : 8;
+        outsize = outw * outh;
+    }
+    else // if (dims == 4)
+    {
+        int outw = grid_unpacked.h;
+        int outh = grid_unpacked.d;
+        int outd = grid_unpacked.c;
+
+        top_blob.create(outw, outh, outd, channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        taps = sample_type == 1 ? 8 : 1;
+        nvalue = sample_type == 1 ? 3 : 0;
+        outsize = outw * outh * outd;
+    }
+
+    Mat offset_blob(outsize * taps, (size_t)4u, opt.workspace_allocator);
+    if (offset_blob.empty())
+        return -100;
+
+    Mat value_blob;
+    if (nvalue > 0)
+    {
+        value_blob.create(outsize * nvalue, (size_t)4u, opt.workspace_allocator);
+        if (value_blob.empty())
+            return -100;
+    }
+
+    if (dims == 3)
+    {
+        gridsample_2d_compute_blob(grid_unpacked, offset_blob, value_blob, w, h, sample_type, padding_mode, align_corner, opt);
+    }
+    else
+    {
+        gridsample_3d_compute_blob(grid_unpacked, offset_blob, value_blob, w, h, d, sample_type, padding_mode, align_corner, opt);
+    }
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        if (sample_type == 1)
+            gridsample_bilinear_pack16(bottom_blob, top_blob, offset_blob, value_blob, taps, opt);
+        else if (sample_type == 2)
+            gridsample_nearest_pack16(bottom_blob, top_blob, offset_blob, opt);
+        else
+            gridsample_bicubic_pack16(bottom_blob, top_blob, offset_blob, value_blob, opt);
+    }
+#endif // __AVX512F__
+
+    if (elempack == 8)
+    {
+        if (sample_type == 1)
+            gridsample_bilinear_pack8(bottom_blob, top_blob, offset_blob, value_blob, taps, opt);
+        else if (sample_type == 2)
+            gridsample_nearest_pack8(bottom_blob, top_blob, offset_blob, opt);
+        else
+            gridsample_bicubic_pack8(bottom_blob, top_blob, offset_blob, value_blob, opt);
+    }
+#endif // __AVX__
+
+    if (elempack == 4)
+    {
+        if (sample_type == 1)
+            gridsample_bilinear_pack4(bottom_blob, top_blob, offset_blob, value_blob, taps, opt);
+        else if (sample_type == 2)
+            gridsample_nearest_pack4(bottom_blob, top_blob, offset_blob, opt);
+        else
+            gridsample_bicubic_pack4(bottom_blob, top_blob, offset_blob, value_blob, opt);
+    }
+#endif // __SSE2__
+
+    if (elempack == 1)
+    {
+        if (sample_type == 1)
+            gridsample_bilinear(bottom_blob, top_blob, offset_blob, value_blob, taps, opt);
+        else if (sample_type == 2)
+            gridsample_nearest(bottom_blob, top_blob, offset_blob, opt);
+        else
+            gridsample_bicubic(bottom_blob, top_blob, offset_blob, value_blob, opt);
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
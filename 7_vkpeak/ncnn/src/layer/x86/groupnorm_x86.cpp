@@ -0,0 +1,165 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "groupnorm_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+#include "x86_usability.h"
+#include "welford.h"
+
+#include <math.h>
+
+namespace ncnn {
+
+GroupNorm_x86::GroupNorm_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+int GroupNorm_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    const int dims = bottom_top_blob.dims;
+    const int elempack = bottom_top_blob.elempack;
+    const int channels_g = channels / group;
+
+    if (dims == 1)
+    {
+        // 1d group norm treats every element as one channel, which is layout agnostic
+        float* ptr = bottom_top_blob;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int g = 0; g < group; g++)
+        {
+            float* ptr_g = ptr + g * channels_g;
+
+            float n = 0.f;
+            float mean = 0.f;
+            float m2 = 0.f;
+            welford_accumulate(ptr_g, channels_g, 1, &n, &mean, &m2);
+
+            const float var = m2 / channels_g;
+            const float rstd = static_cast<float>(1.f / sqrt(var + eps));
+
+            for (int q = 0; q < channels_g; q++)
+            {
+                float a = rstd;
+                float b = -mean * a;
+                if (affine)
+                {
+                    a = gamma_data[g * channels_g + q] * rstd;
+                    b = -mean * a + beta_data[g * channels_g + q];
+                }
+
+                ptr_g[q] = ptr_g[q] * a + b;
+            }
+        }
+
+        return 0;
+    }
+
+    // the channels of one group must not straddle a pack
+    int g_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        g_elempack = channels_g % 16 == 0 ? 16 : channels_g % 8 == 0 ? 8 : channels_g % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        g_elempack = channels_g % 8 == 0 ? 8 : channels_g % 4 == 0 ? 4 : 1;
+#else
+        g_elempack = channels_g % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+
+    Mat bottom_top_blob_unpacked = bottom_top_blob;
+    if (elempack > g_elempack)
+    {
+        Option opt_p = opt;
+        opt_p.blob_allocator = opt.workspace_allocator;
+        convert_packing(bottom_top_blob, bottom_top_blob_unpacked, g_elempack, opt_p);
+        if (bottom_top_blob_unpacked.empty())
+            return -100;
+    }
+
+    const int out_elempack = bottom_top_blob_unpacked.elempack;
+    const int w = bottom_top_blob_unpacked.w;
+    const int h = bottom_top_blob_unpacked.h;
+    const int d = bottom_top_blob_unpacked.d;
+
+    // rows of a 2d blob are channels
+    const int size = dims == 2 ? w * out_elempack : w * h * d * out_elempack;
+    const size_t cstep = dims == 2 ? (size_t)w * out_elempack : bottom_top_blob_unpacked.cstep * out_elempack;
+    const int channels_g_packed = channels_g / out_elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g = 0; g < group; g++)
+    {
+        float* ptr_g = (float*)bottom_top_blob_unpacked.data + cstep * g * channels_g_packed;
+
+        float n[16] = {0.f};
+        float mean[16] = {0.f};
+        float m2[16] = {0.f};
+        for (int q = 0; q < channels_g_packed; q++)
+        {
+            welford_accumulate(ptr_g + cstep * q, size, out_elempack, n, mean, m2);
+        }
+
+        // all lanes belong to the same group
+        for (int l = 1; l < out_elempack; l++)
+        {
+            welford_merge(n[0], mean[0], m2[0], n[l], mean[l], m2[l]);
+        }
+
+        const float var = m2[0] / (channels_g * (size / out_elempack));
+        const float rstd = static_cast<float>(1.f / sqrt(var + eps));
+
+        for (int q = 0; q < channels_g_packed; q++)
+        {
+            float a[16];
+            float b[16];
+            for (int l = 0; l < out_elempack; l++)
+            {
+                a[l] = rstd;
+                b[l] = -mean[0] * rstd;
+                if (affine)
+                {
+                    const int ch = g * channels_g + q * out_elempack + l;
+                    a[l] = gamma_data[ch] * rstd;
+                    b[l] = -mean[0] * a[l] + beta_data[ch];
+                }
+            }
+
+            scale_bias(ptr_g + cstep * q, size, out_elempack, a, b);
+        }
+    }
+
+    if (elempack > g_elempack)
+    {
+        convert_packing(bottom_top_blob_unpacked, bottom_top_blob, elempack, opt);
+        if (bottom_top_blob.empty())
+            return -100;
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
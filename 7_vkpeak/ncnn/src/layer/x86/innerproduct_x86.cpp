@@ -25,6 +25,7 @@
 #include "x86_usability.h"
 
 #include "layer_type.h"
+#include "weightcache.h"
 
 #include "cpu.h"
 
@@ -80,6 +81,11 @@ int InnerProduct_x86::create_pipeline(const Option& opt)
 
     innerproduct_transform_kernel_sse(weight_data, weight_data_tm, num_input, num_output, opt);
 
+    if (opt.weight_cache)
+    {
+        weight_data_tm = opt.weight_cache->share(weight_data_tm);
+    }
+
     if (opt.lightmode)
     {
         weight_data.release();
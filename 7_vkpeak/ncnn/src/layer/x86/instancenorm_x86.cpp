@@ -0,0 +1,82 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "instancenorm_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+#include "x86_usability.h"
+#include "welford.h"
+
+#include <math.h>
+
+namespace ncnn {
+
+InstanceNorm_x86::InstanceNorm_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+int InstanceNorm_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    // x = (x - mean) / (sqrt(var + eps)) * gamma + beta
+
+    int w = bottom_top_blob.w;
+    int h = bottom_top_blob.h;
+    int c = bottom_top_blob.c;
+    int elempack = bottom_top_blob.elempack;
+    int size = w * h * elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < c; q++)
+    {
+        float* ptr = bottom_top_blob.channel(q);
+
+        // every lane of a pack is a separate channel
+        float n[16] = {0.f};
+        float mean[16] = {0.f};
+        float m2[16] = {0.f};
+        welford_accumulate(ptr, size, elempack, n, mean, m2);
+
+        float a[16];
+        float b[16];
+        for (int l = 0; l < elempack; l++)
+        {
+            float var = m2[l] / (w * h);
+
+            a[l] = static_cast<float>(1.f / (sqrt(var + eps)));
+            b[l] = -mean[l] * a[l];
+            if (affine)
+            {
+                float gamma = gamma_data[q * elempack + l];
+                float beta = beta_data[q * elempack + l];
+
+                a[l] = static_cast<float>(gamma / (sqrt(var + eps)));
+                b[l] = -mean[l] * a[l] + beta;
+            }
+        }
+
+        scale_bias(ptr, size, elempack, a, b);
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,439 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "permute_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_usability.h"
+
+#include <string.h>
+
+namespace ncnn {
+
+// output axis w h d c <- input axis, 0 = w 1 = h 2 = d 3 = c
+static const int permute_order_2d[2][4] = {
+    {0, 1, 2, 3},
+    {1, 0, 2, 3},
+};
+
+static const int permute_order_3d[6][4] = {
+    {0, 1, 2, 3},
+    {1, 0, 2, 3},
+    {0, 3, 2, 1},
+    {3, 0, 2, 1},
+    {1, 3, 2, 0},
+    {3, 1, 2, 0},
+};
+
+static const int permute_order_4d[24][4] = {
+    {0, 1, 2, 3},
+    {1, 0, 2, 3},
+    {0, 2, 1, 3},
+    {2, 0, 1, 3},
+    {1, 2, 0, 3},
+    {2, 1, 0, 3},
+    {0, 1, 3, 2},
+    {1, 0, 3, 2},
+    {0, 3, 1, 2},
+    {3, 0, 1, 2},
+    {1, 3, 0, 2},
+    {3, 1, 0, 2},
+    {0, 2, 3, 1},
+    {2, 0, 3, 1},
+    {0, 3, 2, 1},
+    {3, 0, 2, 1},
+    {2, 3, 0, 1},
+    {3, 2, 0, 1},
+    {1, 2, 3, 0},
+    {2, 1, 3, 0},
+    {1, 3, 2, 0},
+    {3, 1, 2, 0},
+    {2, 3, 1, 0},
+    {3, 2, 1, 0},
+};
+
+Permute_x86::Permute_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+// outptr[i * out_stride + j] = ptr[j * stride + i]
+// walk the columns in blocks so that the source rows of one block stay in cache
+static void transpose_block(const float* ptr, int stride, float* outptr, int out_stride, int rows, int cols)
+{
+    const int block_cols = 64;
+
+    for (int jj = 0; jj < cols; jj += block_cols)
+    {
+        const int max_jj = std::min(jj + block_cols, cols);
+
+        int i = 0;
+#if __SSE2__
+#if __AVX__
+        for (; i + 7 < rows; i += 8)
+        {
+            int j = jj;
+            for (; j + 7 < max_jj; j += 8)
+            {
+                const float* p0 = ptr + j * stride + i;
+
+                __m256 _r0 = _mm256_loadu_ps(p0);
+                __m256 _r1 = _mm256_loadu_ps(p0 + stride);
+                __m256 _r2 = _mm256_loadu_ps(p0 + stride * 2);
+                __m256 _r3 = _mm256_loadu_ps(p0 + stride * 3);
+                __m256 _r4 = _mm256_loadu_ps(p0 + stride * 4);
+                __m256 _r5 = _mm256_loadu_ps(p0 + stride * 5);
+                __m256 _r6 = _mm256_loadu_ps(p0 + stride * 6);
+                __m256 _r7 = _mm256_loadu_ps(p0 + stride * 7);
+
+                transpose8x8_ps(_r0, _r1, _r2, _r3, _r4, _r5, _r6, _r7);
+
+                float* outp0 = outptr + i * out_stride + j;
+
+                _mm256_storeu_ps(outp0, _r0);
+                _mm256_storeu_ps(outp0 + out_stride, _r1);
+                _mm256_storeu_ps(outp0 + out_stride * 2, _r2);
+                _mm256_storeu_ps(outp0 + out_stride * 3, _r3);
+                _mm256_storeu_ps(outp0 + out_stride * 4, _r4);
+                _mm256_storeu_ps(outp0 + out_stride * 5, _r5);
+                _mm256_storeu_ps(outp0 + out_stride * 6, _r6);
+                _mm256_storeu_ps(outp0 + out_stride * 7, _r7);
+            }
+            for (; j < max_jj; j++)
+            {
+                const float* p0 = ptr + j * stride + i;
+                float* outp0 = outptr + i * out_stride + j;
+
+                for (int k = 0; k < 8; k++)
+                {
+                    outp0[k * out_stride] = p0[k];
+                }
+            }
+        }
+#endif // __AVX__
+        for (; i + 3 < rows; i += 4)
+        {
+            int j = jj;
+            for (; j + 3 < max_jj; j += 4)
+            {
+                const float* p0 = ptr + j * stride + i;
+
+                __m128 _r0 = _mm_loadu_ps(p0);
+                __m128 _r1 = _mm_loadu_ps(p0 + stride);
+                __m128 _r2 = _mm_loadu_ps(p0 + stride * 2);
+                __m128 _r3 = _mm_loadu_ps(p0 + stride * 3);
+
+                _MM_TRANSPOSE4_PS(_r0, _r1, _r2, _r3);
+
+                float* outp0 = outptr + i * out_stride + j;
+
+                _mm_storeu_ps(outp0, _r0);
+                _mm_storeu_ps(outp0 + out_stride, _r1);
+                _mm_storeu_ps(outp0 + out_stride * 2, _r2);
+                _mm_storeu_ps(outp0 + out_stride * 3, _r3);
+            }
+            for (; j < max_jj; j++)
+            {
+                const float* p0 = ptr + j * stride + i;
+                float* outp0 = outptr + i * out_stride + j;
+
+                for (int k = 0; k < 4; k++)
+                {
+                    outp0[k * out_stride] = p0[k];
+                }
+            }
+        }
+#endif // __SSE2__
+        for (; i < rows; i++)
+        {
+            const float* p0 = ptr + i;
+            float* outp0 = outptr + i * out_stride;
+
+            for (int j = jj; j < max_jj; j++)
+            {
+                outp0[j] = p0[j * stride];
+            }
+        }
+    }
+}
+
+// gather packs of elempack floats, outptr[j] = ptr[j * stride]
+static void gather_packs(const float* ptr, int stride, float* outptr, int cols, int elempack)
+{
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            _mm512_storeu_ps(outptr, _mm512_loadu_ps(ptr));
+            ptr += stride;
+            outptr += 16;
+        }
+        return;
+    }
+#endif // __AVX512F__
+    if (elempack == 8)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            _mm256_storeu_ps(outptr, _mm256_loadu_ps(ptr));
+            ptr += stride;
+            outptr += 8;
+        }
+        return;
+    }
+#endif // __AVX__
+    if (elempack == 4)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            _mm_storeu_ps(outptr, _mm_loadu_ps(ptr));
+            ptr += stride;
+            outptr += 4;
+        }
+        return;
+    }
+#endif // __SSE2__
+    for (int j = 0; j < cols; j++)
+    {
+        for (int k = 0; k < elempack; k++)
+        {
+            outptr[k] = ptr[k];
+        }
+        ptr += stride;
+        outptr += elempack;
+    }
+}
+
+// permute channels that stay outermost, every element is a pack of elempack floats
+static void permute_packed(const Mat& bottom_blob, Mat& top_blob, const int* order, const Option& opt)
+{
+    const int elempack = bottom_blob.elempack;
+    const int channels = bottom_blob.c;
+
+    const int shape[3] = {bottom_blob.w, bottom_blob.h, bottom_blob.d};
+    const int stride[3] = {elempack, bottom_blob.w * elempack, bottom_blob.w * bottom_blob.h * elempack};
+
+    const int outw = shape[order[0]];
+    const int outh = shape[order[1]];
+    const int outd = shape[order[2]];
+    const int stride_x = stride[order[0]];
+    const int stride_y = stride[order[1]];
+    const int stride_z = stride[order[2]];
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const float* ptr = bottom_blob.channel(q);
+        float* outptr = top_blob.channel(q);
+
+        for (int z = 0; z < outd; z++)
+        {
+            for (int y = 0; y < outh; y++)
+            {
+                const float* p0 = ptr + z * stride_z + y * stride_y;
+
+                if (stride_x == elempack)
+                {
+                    memcpy(outptr, p0, outw * elempack * sizeof(float));
+                }
+                else
+                {
+                    gather_packs(p0, stride_x, outptr, outw, elempack);
+                }
+
+                outptr += outw * elempack;
+            }
+        }
+    }
+}
+
+// generic permute on unpacked blob
+static void permute_unpacked(const Mat& bottom_blob, Mat& top_blob, const int* order, const Option& opt)
+{
+    const int dims = bottom_blob.dims;
+
+    const int shape[4] = {bottom_blob.w, bottom_blob.h, bottom_blob.d, bottom_blob.c};
+    const int stride[4] = {1, bottom_blob.w, bottom_blob.w * bottom_blob.h, (int)bottom_blob.cstep};
+
+    int outshape[4];
+    int instride[4];
+    for (int k = 0; k < 4; k++)
+    {
+        outshape[k] = shape[order[k]];
+        instride[k] = stride[order[k]];
+    }
+
+    const int outstride[4] = {1, outshape[0], outshape[0] * outshape[1], dims >= 3 ? (int)top_blob.cstep : outshape[0] * outshape[1] * outshape[2]};
+
+    const float* ptr = bottom_blob;
+    float* outptr = top_blob;
+
+    // the output axis that walks the contiguous input w
+    int p = 0;
+    for (int k = 0; k < 4; k++)
+    {
+        if (order[k] == 0)
+            p = k;
+    }
+
+    if (p == 0)
+    {
+        // plain row copies
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < outshape[3]; q++)
+        {
+            for (int z = 0; z < outshape[2]; z++)
+            {
+                for (int y = 0; y < outshape[1]; y++)
+                {
+                    const float* p0 = ptr + q * instride[3] + z * instride[2] + y * instride[1];
+                    float* outp0 = outptr + q * outstride[3] + z * outstride[2] + y * outstride[1];
+
+                    memcpy(outp0, p0, outshape[0] * sizeof(float));
+                }
+            }
+        }
+
+        return;
+    }
+
+    // transpose tiles on the plane of output axis p and output w,
+    // parallel over the remaining two axes
+    int r0 = 3;
+    int r1 = 2;
+    if (p == 3) r0 = 2;
+    if (p >= 2) r1 = 1;
+
+    const int nn_outer = outshape[r0] * outshape[r1];
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int ii = 0; ii < nn_outer; ii++)
+    {
+        const int i0 = ii / outshape[r1];
+        const int i1 = ii % outshape[r1];
+
+        const float* p0 = ptr + i0 * instride[r0] + i1 * instride[r1];
+        float* outp0 = outptr + i0 * outstride[r0] + i1 * outstride[r1];
+
+        transpose_block(p0, instride[0], outp0, outstride[p], outshape[p], outshape[0]);
+    }
+}
+
+int Permute_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int dims = bottom_blob.dims;
+    const int elempack = bottom_blob.elempack;
+
+    if (dims == 1 || order_type == 0)
+    {
+        top_blob = bottom_blob;
+        return 0;
+    }
+
+    const int* order = dims == 2 ? permute_order_2d[order_type] : dims == 3 ? permute_order_3d[order_type] : permute_order_4d[order_type];
+
+    if (elempack != 1 && dims >= 3 && order[3] == 3)
+    {
+        // channels stay outermost, move whole packs around
+        const int shape[3] = {bottom_blob.w, bottom_blob.h, bottom_blob.d};
+
+        if (dims == 3)
+            top_blob.create(shape[order[0]], shape[order[1]], bottom_blob.c, bottom_blob.elemsize, elempack, opt.blob_allocator);
+        else
+            top_blob.create(shape[order[0]], shape[order[1]], shape[order[2]], bottom_blob.c, bottom_blob.elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        permute_packed(bottom_blob, top_blob, order, opt);
+
+        return 0;
+    }
+
+    Mat bottom_blob_unpacked = bottom_blob;
+    if (elempack != 1)
+    {
+        Option opt_pack = opt;
+        opt_pack.blob_allocator = opt.workspace_allocator;
+
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+    }
+
+    const size_t elemsize = bottom_blob_unpacked.elemsize;
+    const int shape[4] = {bottom_blob_unpacked.w, bottom_blob_unpacked.h, bottom_blob_unpacked.d, bottom_blob_unpacked.c};
+
+    const int outw = shape[order[0]];
+    const int outh = shape[order[1]];
+    const int outd = shape[order[2]];
+    const int outc = shape[order[3]];
+
+    int out_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+        const int out_outer = dims == 2 ? outh : outc;
+#if __AVX512F__
+        out_elempack = out_outer % 16 == 0 ? 16 : out_outer % 8 == 0 ? 8 : out_outer % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        out_elempack = out_outer % 8 == 0 ? 8 : out_outer % 4 == 0 ? 4 : 1;
+#else
+        out_elempack = out_outer % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+
+    Option opt_permute = opt;
+    if (out_elempack != 1)
+    {
+        opt_permute.blob_allocator = opt.workspace_allocator;
+    }
+
+    Mat top_blob_unpacked;
+    if (dims == 2)
+        top_blob_unpacked.create(outw, outh, elemsize, opt_permute.blob_allocator);
+    if (dims == 3)
+        top_blob_unpacked.create(outw, outh, outc, elemsize, opt_permute.blob_allocator);
+    if (dims == 4)
+        top_blob_unpacked.create(outw, outh, outd, outc, elemsize, opt_permute.blob_allocator);
+    if (top_blob_unpacked.empty())
+        return -100;
+
+    permute_unpacked(bottom_blob_unpacked, top_blob_unpacked, order, opt);
+
+    if (out_elempack == 1)
+    {
+        top_blob = top_blob_unpacked;
+        return 0;
+    }
+
+    convert_packing(top_blob_unpacked, top_blob, out_elempack, opt);
+    if (top_blob.empty())
+        return -100;
+
+    return 0;
+}
+
+} // namespace ncnn
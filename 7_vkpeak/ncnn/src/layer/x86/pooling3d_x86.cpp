@@ -0,0 +1,606 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "pooling3d_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif
+#endif // __SSE2__
+
+namespace ncnn {
+
+Pooling3D_x86::Pooling3D_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+int Pooling3D_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int elempack = bottom_blob.elempack;
+
+    if (elempack == 1)
+    {
+        return Pooling3D::forward(bottom_blob, top_blob, opt);
+    }
+
+    if (adaptive_pooling)
+    {
+        Mat bottom_blob_unpacked;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt);
+
+        return Pooling3D::forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int d = bottom_blob.d;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+
+#if __SSE2__
+    if (global_pooling)
+    {
+        top_blob.create(channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        const int size = w * h * d;
+
+#if __AVX__
+#if __AVX512F__
+        if (elempack == 16)
+        {
+            if (pooling_type == PoolMethod_MAX)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m512 _max = _mm512_load_ps(ptr);
+                    for (int i = 0; i < size; i++)
+                    {
+                        _max = _mm512_max_ps(_max, _mm512_load_ps(ptr));
+                        ptr += 16;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm512_store_ps(outptr + q * 16, _max);
+                }
+            }
+            else if (pooling_type == PoolMethod_AVE)
+            {
+                const __m512 _inv_size = _mm512_set1_ps(1.f / size);
+
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m512 _sum = _mm512_setzero_ps();
+                    for (int i = 0; i < size; i++)
+                    {
+                        _sum = _mm512_add_ps(_sum, _mm512_load_ps(ptr));
+                        ptr += 16;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm512_store_ps(outptr + q * 16, _mm512_mul_ps(_sum, _inv_size));
+                }
+            }
+
+            return 0;
+        }
+#endif // __AVX512F__
+        if (elempack == 8)
+        {
+            if (pooling_type == PoolMethod_MAX)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m256 _max = _mm256_load_ps(ptr);
+                    for (int i = 0; i < size; i++)
+                    {
+                        _max = _mm256_max_ps(_max, _mm256_load_ps(ptr));
+                        ptr += 8;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm256_store_ps(outptr + q * 8, _max);
+                }
+            }
+            else if (pooling_type == PoolMethod_AVE)
+            {
+                const __m256 _inv_size = _mm256_set1_ps(1.f / size);
+
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m256 _sum = _mm256_setzero_ps();
+                    for (int i = 0; i < size; i++)
+                    {
+                        _sum = _mm256_add_ps(_sum, _mm256_load_ps(ptr));
+                        ptr += 8;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm256_store_ps(outptr + q * 8, _mm256_mul_ps(_sum, _inv_size));
+                }
+            }
+
+            return 0;
+        }
+#endif // __AVX__
+        if (elempack == 4)
+        {
+            if (pooling_type == PoolMethod_MAX)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m128 _max = _mm_load_ps(ptr);
+                    for (int i = 0; i < size; i++)
+                    {
+                        _max = _mm_max_ps(_max, _mm_load_ps(ptr));
+                        ptr += 4;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm_store_ps(outptr + q * 4, _max);
+                }
+            }
+            else if (pooling_type == PoolMethod_AVE)
+            {
+                const __m128 _inv_size = _mm_set1_ps(1.f / size);
+
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m128 _sum = _mm_setzero_ps();
+                    for (int i = 0; i < size; i++)
+                    {
+                        _sum = _mm_add_ps(_sum, _mm_load_ps(ptr));
+                        ptr += 4;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm_store_ps(outptr + q * 4, _mm_mul_ps(_sum, _inv_size));
+                }
+            }
+
+            return 0;
+        }
+    }
+
+    Mat bottom_blob_bordered;
+    make_padding(bottom_blob, bottom_blob_bordered, opt);
+    if (bottom_blob_bordered.empty())
+        return -100;
+
+    int wtailpad = 0;
+    int htailpad = 0;
+    int dtailpad = 0;
+
+    if (pad_mode == 0) // full padding
+    {
+        wtailpad = bottom_blob_bordered.w - bottom_blob.w - pad_left - pad_right;
+        htailpad = bottom_blob_bordered.h - bottom_blob.h - pad_top - pad_bottom;
+        dtailpad = bottom_blob_bordered.d - bottom_blob.d - pad_front - pad_behind;
+    }
+
+    w = bottom_blob_bordered.w;
+    h = bottom_blob_bordered.h;
+    d = bottom_blob_bordered.d;
+
+    const int outw = (w - kernel_w) / stride_w + 1;
+    const int outh = (h - kernel_h) / stride_h + 1;
+    const int outd = (d - kernel_d) / stride_d + 1;
+
+    top_blob.create(outw, outh, outd, channels, elemsize, elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const int maxk = kernel_w * kernel_h * kernel_d;
+
+    // kernel offsets, in floats of the packed layout
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap0 = w - kernel_w;
+        int gap1 = h * w - w * kernel_h;
+        for (int z = 0; z < kernel_d; z++)
+        {
+            for (int i = 0; i < kernel_h; i++)
+            {
+                for (int j = 0; j < kernel_w; j++)
+                {
+                    space_ofs[p1] = p2 * elempack;
+                    p1++;
+                    p2 += 1;
+                }
+                p2 += gap0;
+            }
+            p2 += gap1;
+        }
+    }
+
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        if (pooling_type == PoolMethod_MAX)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 16;
+
+                            __m512 _max = _mm512_load_ps(sptr);
+                            for (int l = 0; l < maxk; l++)
+                            {
+                                _max = _mm512_max_ps(_max, _mm512_load_ps(sptr + space_ofs[l]));
+                            }
+
+                            _mm512_store_ps(outptr, _max);
+                            outptr += 16;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE && avgpool_count_include_pad == 0)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    const int sz0 = z * stride_d;
+                    const int kd0 = std::max(pad_front - sz0, 0);
+                    const int kd1 = std::min(d - pad_behind - dtailpad - sz0, kernel_d);
+
+                    for (int i = 0; i < outh; i++)
+                    {
+                        const int sy0 = i * stride_h;
+                        const int ki0 = std::max(pad_top - sy0, 0);
+                        const int ki1 = std::min(h - pad_bottom - htailpad - sy0, kernel_h);
+
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const int sx0 = j * stride_w;
+                            const int kj0 = std::max(pad_left - sx0, 0);
+                            const int kj1 = std::min(w - pad_right - wtailpad - sx0, kernel_w);
+
+                            __m512 _sum = _mm512_setzero_ps();
+                            for (int kd = kd0; kd < kd1; kd++)
+                            {
+                                for (int ki = ki0; ki < ki1; ki++)
+                                {
+                                    const float* sptr = m.depth(sz0 + kd).row(sy0 + ki) + (sx0 + kj0) * 16;
+                                    for (int kj = kj0; kj < kj1; kj++)
+                                    {
+                                        _sum = _mm512_add_ps(_sum, _mm512_load_ps(sptr));
+                                        sptr += 16;
+                                    }
+                                }
+                            }
+
+                            const int area = (kd1 - kd0) * (ki1 - ki0) * (kj1 - kj0);
+                            _mm512_store_ps(outptr, _mm512_mul_ps(_sum, _mm512_set1_ps(1.f / area)));
+                            outptr += 16;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE)
+        {
+            const __m512 _inv_maxk = _mm512_set1_ps(1.f / maxk);
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 16;
+
+                            __m512 _sum = _mm512_setzero_ps();
+                            for (int l = 0; l < maxk; l++)
+                            {
+                                _sum = _mm512_add_ps(_sum, _mm512_load_ps(sptr + space_ofs[l]));
+                            }
+
+                            _mm512_store_ps(outptr, _mm512_mul_ps(_sum, _inv_maxk));
+                            outptr += 16;
+                        }
+                    }
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX512F__
+    if (elempack == 8)
+    {
+        if (pooling_type == PoolMethod_MAX)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 8;
+
+                            __m256 _max = _mm256_load_ps(sptr);
+                            for (int l = 0; l < maxk; l++)
+                            {
+                                _max = _mm256_max_ps(_max, _mm256_load_ps(sptr + space_ofs[l]));
+                            }
+
+                            _mm256_store_ps(outptr, _max);
+                            outptr += 8;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE && avgpool_count_include_pad == 0)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    const int sz0 = z * stride_d;
+                    const int kd0 = std::max(pad_front - sz0, 0);
+                    const int kd1 = std::min(d - pad_behind - dtailpad - sz0, kernel_d);
+
+                    for (int i = 0; i < outh; i++)
+                    {
+                        const int sy0 = i * stride_h;
+                        const int ki0 = std::max(pad_top - sy0, 0);
+                        const int ki1 = std::min(h - pad_bottom - htailpad - sy0, kernel_h);
+
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const int sx0 = j * stride_w;
+                            const int kj0 = std::max(pad_left - sx0, 0);
+                            const int kj1 = std::min(w - pad_right - wtailpad - sx0, kernel_w);
+
+                            __m256 _sum = _mm256_setzero_ps();
+                            for (int kd = kd0; kd < kd1; kd++)
+                            {
+                                for (int ki = ki0; ki < ki1; ki++)
+                                {
+                                    const float* sptr = m.depth(sz0 + kd).row(sy0 + ki) + (sx0 + kj0) * 8;
+                                    for (int kj = kj0; kj < kj1; kj++)
+                                    {
+                                        _sum = _mm256_add_ps(_sum, _mm256_load_ps(sptr));
+                                        sptr += 8;
+                                    }
+                                }
+                            }
+
+                            const int area = (kd1 - kd0) * (ki1 - ki0) * (kj1 - kj0);
+                            _mm256_store_ps(outptr, _mm256_mul_ps(_sum, _mm256_set1_ps(1.f / area)));
+                            outptr += 8;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE)
+        {
+            const __m256 _inv_maxk = _mm256_set1_ps(1.f / maxk);
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 8;
+
+                            __m256 _sum = _mm256_setzero_ps();
+                            for (int l = 0; l < maxk; l++)
+                            {
+                                _sum = _mm256_add_ps(_sum, _mm256_load_ps(sptr + space_ofs[l]));
+                            }
+
+                            _mm256_store_ps(outptr, _mm256_mul_ps(_sum, _inv_maxk));
+                            outptr += 8;
+                        }
+                    }
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+    if (elempack == 4)
+    {
+        if (pooling_type == PoolMethod_MAX)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 4;
+
+                            __m128 _max = _mm_load_ps(sptr);
+                            for (int l = 0; l < maxk; l++)
+                            {
+                                _max = _mm_max_ps(_max, _mm_load_ps(sptr + space_ofs[l]));
+                            }
+
+                            _mm_store_ps(outptr, _max);
+                            outptr += 4;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE && avgpool_count_include_pad == 0)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    const int sz0 = z * stride_d;
+                    const int kd0 = std::max(pad_front - sz0, 0);
+                    const int kd1 = std::min(d - pad_behind - dtailpad - sz0, kernel_d);
+
+                    for (int i = 0; i < outh; i++)
+                    {
+                        const int sy0 = i * stride_h;
+                        const int ki0 = std::max(pad_top - sy0, 0);
+                        const int ki1 = std::min(h - pad_bottom - htailpad - sy0, kernel_h);
+
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const int sx0 = j * stride_w;
+                            const int kj0 = std::max(pad_left - sx0, 0);
+                            const int kj1 = std::min(w - pad_right - wtailpad - sx0, kernel_w);
+
+                            __m128 _sum = _mm_setzero_ps();
+                            for (int kd = kd0; kd < kd1; kd++)
+                            {
+                                for (int ki = ki0; ki < ki1; ki++)
+                                {
+                                    const float* sptr = m.depth(sz0 + kd).row(sy0 + ki) + (sx0 + kj0) * 4;
+                                    for (int kj = kj0; kj < kj1; kj++)
+                                    {
+                                        _sum = _mm_add_ps(_sum, _mm_load_ps(sptr));
+                                        sptr += 4;
+                                    }
+                                }
+                            }
+
+                            const int area = (kd1 - kd0) * (ki1 - ki0) * (kj1 - kj0);
+                            _mm_store_ps(outptr, _mm_mul_ps(_sum, _mm_set1_ps(1.f / area)));
+                            outptr += 4;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE)
+        {
+            const __m128 _inv_maxk = _mm_set1_ps(1.f / maxk);
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 4;
+
+                            __m128 _sum = _mm_setzero_ps();
+                            for (int l = 0; l < maxk; l++)
+                            {
+                                _sum = _mm_add_ps(_sum, _mm_load_ps(sptr + space_ofs[l]));
+                            }
+
+                            _mm_store_ps(outptr, _mm_mul_ps(_sum, _inv_maxk));
+                            outptr += 4;
+                        }
+                    }
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __SSE2__
+
+    // no vectorized path for this elempack
+    Mat bottom_blob_unpacked;
+    convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt);
+
+    return Pooling3D::forward(bottom_blob_unpacked, top_blob, opt);
+}
+
+} // namespace ncnn
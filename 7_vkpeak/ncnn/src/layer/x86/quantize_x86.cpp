@@ -39,6 +39,13 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
     int dims = bottom_blob.dims;
     int elempack = bottom_blob.elempack;
 
+#if __SSE2__
+    __m128 _zero_point = _mm_set1_ps((float)zero_point);
+#if __AVX__
+    __m256 _zero_point_avx = _mm256_set1_ps((float)zero_point);
+#endif // __AVX__
+#endif // __SSE2__
+
 #if __SSE2__
 #if __AVX__
 #if __AVX512F__
@@ -74,7 +81,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     signed char* outptr = (signed char*)top_blob + i * 8;
 
                     __m256 _v = _mm256_loadu_ps(ptr);
-                    _v = _mm256_mul_ps(_v, _scale);
+                    _v = _mm256_comp_fmadd_ps(_v, _scale, _zero_point_avx);
                     *(int64_t*)outptr = float2int8_avx(_v);
                 }
             }
@@ -88,7 +95,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
                     __m256 _v = _mm256_loadu_ps(ptr);
                     __m256 _scale = _mm256_loadu_ps((const float*)scale_data + i * 8);
-                    _v = _mm256_mul_ps(_v, _scale);
+                    _v = _mm256_comp_fmadd_ps(_v, _scale, _zero_point_avx);
                     *(int64_t*)outptr = float2int8_avx(_v);
                 }
             }
@@ -118,8 +125,8 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     {
                         __m256 _v0 = _mm256_loadu_ps(ptr);
                         __m256 _v1 = _mm256_loadu_ps(ptr + 8);
-                        _v0 = _mm256_mul_ps(_v0, _scale);
-                        _v1 = _mm256_mul_ps(_v1, _scale);
+                        _v0 = _mm256_comp_fmadd_ps(_v0, _scale, _zero_point_avx);
+                        _v1 = _mm256_comp_fmadd_ps(_v1, _scale, _zero_point_avx);
                         __m128i _v = float2int8_avx(_v0, _v1);
                         _mm_storeu_si128((__m128i*)outptr, _v);
 
@@ -129,7 +136,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     for (; j < w; j++)
                     {
                         __m256 _v = _mm256_loadu_ps(ptr);
-                        _v = _mm256_mul_ps(_v, _scale);
+                        _v = _mm256_comp_fmadd_ps(_v, _scale, _zero_point_avx);
                         *(int64_t*)outptr = float2int8_avx(_v);
 
                         ptr += 8;
@@ -152,8 +159,8 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     {
                         __m256 _v0 = _mm256_loadu_ps(ptr);
                         __m256 _v1 = _mm256_loadu_ps(ptr + 8);
-                        _v0 = _mm256_mul_ps(_v0, _scale);
-                        _v1 = _mm256_mul_ps(_v1, _scale);
+                        _v0 = _mm256_comp_fmadd_ps(_v0, _scale, _zero_point_avx);
+                        _v1 = _mm256_comp_fmadd_ps(_v1, _scale, _zero_point_avx);
                         __m128i _v = float2int8_avx(_v0, _v1);
                         _mm_storeu_si128((__m128i*)outptr, _v);
 
@@ -163,7 +170,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     for (; j < w; j++)
                     {
                         __m256 _v = _mm256_loadu_ps(ptr);
-                        _v = _mm256_mul_ps(_v, _scale);
+                        _v = _mm256_comp_fmadd_ps(_v, _scale, _zero_point_avx);
                         *(int64_t*)outptr = float2int8_avx(_v);
 
                         ptr += 8;
@@ -199,8 +206,8 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     {
                         __m256 _v0 = _mm256_loadu_ps(ptr);
                         __m256 _v1 = _mm256_loadu_ps(ptr + 8);
-                        _v0 = _mm256_mul_ps(_v0, _scale);
-                        _v1 = _mm256_mul_ps(_v1, _scale);
+                        _v0 = _mm256_comp_fmadd_ps(_v0, _scale, _zero_point_avx);
+                        _v1 = _mm256_comp_fmadd_ps(_v1, _scale, _zero_point_avx);
                         __m128i _v = float2int8_avx(_v0, _v1);
                         _mm_storeu_si128((__m128i*)outptr, _v);
 
@@ -210,7 +217,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     for (; i < size; i++)
                     {
                         __m256 _v = _mm256_loadu_ps(ptr);
-                        _v = _mm256_mul_ps(_v, _scale);
+                        _v = _mm256_comp_fmadd_ps(_v, _scale, _zero_point_avx);
                         *(int64_t*)outptr = float2int8_avx(_v);
 
                         ptr += 8;
@@ -233,8 +240,8 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     {
                         __m256 _v0 = _mm256_loadu_ps(ptr);
                         __m256 _v1 = _mm256_loadu_ps(ptr + 8);
-                        _v0 = _mm256_mul_ps(_v0, _scale);
-                        _v1 = _mm256_mul_ps(_v1, _scale);
+                        _v0 = _mm256_comp_fmadd_ps(_v0, _scale, _zero_point_avx);
+                        _v1 = _mm256_comp_fmadd_ps(_v1, _scale, _zero_point_avx);
                         __m128i _v = float2int8_avx(_v0, _v1);
                         _mm_storeu_si128((__m128i*)outptr, _v);
 
@@ -244,7 +251,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     for (; i < size; i++)
                     {
                         __m256 _v = _mm256_loadu_ps(ptr);
-                        _v = _mm256_mul_ps(_v, _scale);
+                        _v = _mm256_comp_fmadd_ps(_v, _scale, _zero_point_avx);
                         *(int64_t*)outptr = float2int8_avx(_v);
 
                         ptr += 8;
@@ -280,10 +287,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     const float* ptr0 = (const float*)bottom_blob + i * 4;
                     signed char* outptr = (signed char*)top_blob + i * 4;
 
-                    outptr[0] = float2int8(ptr0[0] * scale);
-                    outptr[1] = float2int8(ptr0[1] * scale);
-                    outptr[2] = float2int8(ptr0[2] * scale);
-                    outptr[3] = float2int8(ptr0[3] * scale);
+                    outptr[0] = float2int8(ptr0[0] * scale + zero_point);
+                    outptr[1] = float2int8(ptr0[1] * scale + zero_point);
+                    outptr[2] = float2int8(ptr0[2] * scale + zero_point);
+                    outptr[3] = float2int8(ptr0[3] * scale + zero_point);
                 }
             }
             else
@@ -294,10 +301,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                     const float* ptr0 = (const float*)bottom_blob + i * 4;
                     signed char* outptr = (signed char*)top_blob + i * 4;
 
-                    outptr[0] = float2int8(ptr0[0] * scale_data[i * 4]);
-                    outptr[1] = float2int8(ptr0[1] * scale_data[i * 4 + 1]);
-                    outptr[2] = float2int8(ptr0[2] * scale_data[i * 4 + 2]);
-                    outptr[3] = float2int8(ptr0[3] * scale_data[i * 4 + 3]);
+                    outptr[0] = float2int8(ptr0[0] * scale_data[i * 4] + zero_point);
+                    outptr[1] = float2int8(ptr0[1] * scale_data[i * 4 + 1] + zero_point);
+                    outptr[2] = float2int8(ptr0[2] * scale_data[i * 4 + 2] + zero_point);
+                    outptr[3] = float2int8(ptr0[3] * scale_data[i * 4 + 3] + zero_point);
                 }
             }
         }
@@ -333,10 +340,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                             __m128 _v1 = _mm_loadu_ps(ptr1);
                             __m128 _v2 = _mm_loadu_ps(ptr0 + 4);
                             __m128 _v3 = _mm_loadu_ps(ptr1 + 4);
-                            _v0 = _mm_mul_ps(_v0, _scale);
-                            _v1 = _mm_mul_ps(_v1, _scale);
-                            _v2 = _mm_mul_ps(_v2, _scale);
-                            _v3 = _mm_mul_ps(_v3, _scale);
+                            _v0 = _mm_comp_fmadd_ps(_v0, _scale, _zero_point);
+                            _v1 = _mm_comp_fmadd_ps(_v1, _scale, _zero_point);
+                            _v2 = _mm_comp_fmadd_ps(_v2, _scale, _zero_point);
+                            _v3 = _mm_comp_fmadd_ps(_v3, _scale, _zero_point);
                             __m128i _v = float2int8_sse(_v0, _v1, _v2, _v3);
                             _mm_storeu_si128((__m128i*)outptr, _v);
 
@@ -348,8 +355,8 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                         {
                             __m128 _vlow = _mm_loadu_ps(ptr0);
                             __m128 _vhigh = _mm_loadu_ps(ptr1);
-                            _vlow = _mm_mul_ps(_vlow, _scale);
-                            _vhigh = _mm_mul_ps(_vhigh, _scale);
+                            _vlow = _mm_comp_fmadd_ps(_vlow, _scale, _zero_point);
+                            _vhigh = _mm_comp_fmadd_ps(_vhigh, _scale, _zero_point);
                             *(int64_t*)outptr = float2int8_sse(_vlow, _vhigh);
 
                             ptr0 += 4;
@@ -377,10 +384,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                             __m128 _v1 = _mm_loadu_ps(ptr1);
                             __m128 _v2 = _mm_loadu_ps(ptr0 + 4);
                             __m128 _v3 = _mm_loadu_ps(ptr1 + 4);
-                            _v0 = _mm_mul_ps(_v0, _scale0);
-                            _v1 = _mm_mul_ps(_v1, _scale1);
-                            _v2 = _mm_mul_ps(_v2, _scale0);
-                            _v3 = _mm_mul_ps(_v3, _scale1);
+                            _v0 = _mm_comp_fmadd_ps(_v0, _scale0, _zero_point);
+                            _v1 = _mm_comp_fmadd_ps(_v1, _scale1, _zero_point);
+                            _v2 = _mm_comp_fmadd_ps(_v2, _scale0, _zero_point);
+                            _v3 = _mm_comp_fmadd_ps(_v3, _scale1, _zero_point);
                             __m128i _v = float2int8_sse(_v0, _v1, _v2, _v3);
                             _mm_storeu_si128((__m128i*)outptr, _v);
 
@@ -392,8 +399,8 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                         {
                             __m128 _vlow = _mm_loadu_ps(ptr0);
                             __m128 _vhigh = _mm_loadu_ps(ptr1);
-                            _vlow = _mm_mul_ps(_vlow, _scale0);
-                            _vhigh = _mm_mul_ps(_vhigh, _scale1);
+                            _vlow = _mm_comp_fmadd_ps(_vlow, _scale0, _zero_point);
+                            _vhigh = _mm_comp_fmadd_ps(_vhigh, _scale1, _zero_point);
                             *(int64_t*)outptr = float2int8_sse(_vlow, _vhigh);
 
                             ptr0 += 4;
@@ -420,10 +427,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
                         for (int j = 0; j < w; j++)
                         {
-                            outptr0[0] = float2int8(ptr0[0] * scale);
-                            outptr1[0] = float2int8(ptr0[1] * scale);
-                            outptr2[0] = float2int8(ptr0[2] * scale);
-                            outptr3[0] = float2int8(ptr0[3] * scale);
+                            outptr0[0] = float2int8(ptr0[0] * scale + zero_point);
+                            outptr1[0] = float2int8(ptr0[1] * scale + zero_point);
+                            outptr2[0] = float2int8(ptr0[2] * scale + zero_point);
+                            outptr3[0] = float2int8(ptr0[3] * scale + zero_point);
 
                             ptr0 += 4;
                             outptr0 += 1;
@@ -451,10 +458,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
                         for (int j = 0; j < w; j++)
                         {
-                            outptr0[0] = float2int8(ptr0[0] * s0);
-                            outptr1[0] = float2int8(ptr0[1] * s1);
-                            outptr2[0] = float2int8(ptr0[2] * s2);
-                            outptr3[0] = float2int8(ptr0[3] * s3);
+                            outptr0[0] = float2int8(ptr0[0] * s0 + zero_point);
+                            outptr1[0] = float2int8(ptr0[1] * s1 + zero_point);
+                            outptr2[0] = float2int8(ptr0[2] * s2 + zero_point);
+                            outptr3[0] = float2int8(ptr0[3] * s3 + zero_point);
 
                             ptr0 += 4;
                             outptr0 += 1;
@@ -500,10 +507,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                             __m128 _v1 = _mm_loadu_ps(ptr1);
                             __m128 _v2 = _mm_loadu_ps(ptr0 + 4);
                             __m128 _v3 = _mm_loadu_ps(ptr1 + 4);
-                            _v0 = _mm_mul_ps(_v0, _scale);
-                            _v1 = _mm_mul_ps(_v1, _scale);
-                            _v2 = _mm_mul_ps(_v2, _scale);
-                            _v3 = _mm_mul_ps(_v3, _scale);
+                            _v0 = _mm_comp_fmadd_ps(_v0, _scale, _zero_point);
+                            _v1 = _mm_comp_fmadd_ps(_v1, _scale, _zero_point);
+                            _v2 = _mm_comp_fmadd_ps(_v2, _scale, _zero_point);
+                            _v3 = _mm_comp_fmadd_ps(_v3, _scale, _zero_point);
                             __m128i _v = float2int8_sse(_v0, _v1, _v2, _v3);
                             _mm_storeu_si128((__m128i*)outptr, _v);
 
@@ -515,8 +522,8 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                         {
                             __m128 _vlow = _mm_loadu_ps(ptr0);
                             __m128 _vhigh = _mm_loadu_ps(ptr1);
-                            _vlow = _mm_mul_ps(_vlow, _scale);
-                            _vhigh = _mm_mul_ps(_vhigh, _scale);
+                            _vlow = _mm_comp_fmadd_ps(_vlow, _scale, _zero_point);
+                            _vhigh = _mm_comp_fmadd_ps(_vhigh, _scale, _zero_point);
                             *(int64_t*)outptr = float2int8_sse(_vlow, _vhigh);
 
                             ptr0 += 4;
@@ -544,10 +551,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                             __m128 _v1 = _mm_loadu_ps(ptr1);
                             __m128 _v2 = _mm_loadu_ps(ptr0 + 4);
                             __m128 _v3 = _mm_loadu_ps(ptr1 + 4);
-                            _v0 = _mm_mul_ps(_v0, _scale0);
-                            _v1 = _mm_mul_ps(_v1, _scale1);
-                            _v2 = _mm_mul_ps(_v2, _scale0);
-                            _v3 = _mm_mul_ps(_v3, _scale1);
+                            _v0 = _mm_comp_fmadd_ps(_v0, _scale0, _zero_point);
+                            _v1 = _mm_comp_fmadd_ps(_v1, _scale1, _zero_point);
+                            _v2 = _mm_comp_fmadd_ps(_v2, _scale0, _zero_point);
+                            _v3 = _mm_comp_fmadd_ps(_v3, _scale1, _zero_point);
                             __m128i _v = float2int8_sse(_v0, _v1, _v2, _v3);
                             _mm_storeu_si128((__m128i*)outptr, _v);
 
@@ -559,8 +566,8 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                         {
                             __m128 _vlow = _mm_loadu_ps(ptr0);
                             __m128 _vhigh = _mm_loadu_ps(ptr1);
-                            _vlow = _mm_mul_ps(_vlow, _scale0);
-                            _vhigh = _mm_mul_ps(_vhigh, _scale1);
+                            _vlow = _mm_comp_fmadd_ps(_vlow, _scale0, _zero_point);
+                            _vhigh = _mm_comp_fmadd_ps(_vhigh, _scale1, _zero_point);
                             *(int64_t*)outptr = float2int8_sse(_vlow, _vhigh);
 
                             ptr0 += 4;
@@ -587,10 +594,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
                         for (int i = 0; i < size; i++)
                         {
-                            outptr0[0] = float2int8(ptr0[0] * scale);
-                            outptr1[0] = float2int8(ptr0[1] * scale);
-                            outptr2[0] = float2int8(ptr0[2] * scale);
-                            outptr3[0] = float2int8(ptr0[3] * scale);
+                            outptr0[0] = float2int8(ptr0[0] * scale + zero_point);
+                            outptr1[0] = float2int8(ptr0[1] * scale + zero_point);
+                            outptr2[0] = float2int8(ptr0[2] * scale + zero_point);
+                            outptr3[0] = float2int8(ptr0[3] * scale + zero_point);
 
                             ptr0 += 4;
                             outptr0 += 1;
@@ -618,10 +625,10 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
                         for (int i = 0; i < size; i++)
                         {
-                            outptr0[0] = float2int8(ptr0[0] * s0);
-                            outptr1[0] = float2int8(ptr0[1] * s1);
-                            outptr2[0] = float2int8(ptr0[2] * s2);
-                            outptr3[0] = float2int8(ptr0[3] * s3);
+                            outptr0[0] = float2int8(ptr0[0] * s0 + zero_point);
+                            outptr1[0] = float2int8(ptr0[1] * s1 + zero_point);
+                            outptr2[0] = float2int8(ptr0[2] * s2 + zero_point);
+                            outptr3[0] = float2int8(ptr0[3] * s3 + zero_point);
 
                             ptr0 += 4;
                             outptr0 += 1;
@@ -656,7 +663,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
             #pragma omp parallel for num_threads(opt.num_threads)
             for (int i = 0; i < w; i++)
             {
-                outptr[i] = float2int8(ptr[i] * scale);
+                outptr[i] = float2int8(ptr[i] * scale + zero_point);
             }
         }
         else
@@ -664,7 +671,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
             #pragma omp parallel for num_threads(opt.num_threads)
             for (int i = 0; i < w; i++)
             {
-                outptr[i] = float2int8(ptr[i] * scale_data[i]);
+                outptr[i] = float2int8(ptr[i] * scale_data[i] + zero_point);
             }
         }
     }
@@ -688,7 +695,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
             for (int j = 0; j < w; j++)
             {
-                *outptr0++ = float2int8(*ptr0++ * scale);
+                *outptr0++ = float2int8(*ptr0++ * scale + zero_point);
             }
         }
     }
@@ -714,7 +721,7 @@ int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
             for (int i = 0; i < size; i++)
             {
-                *outptr++ = float2int8(*ptr++ * scale);
+                *outptr++ = float2int8(*ptr++ * scale + zero_point);
             }
         }
     }
@@ -0,0 +1,830 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "reduction_x86.h"
+
+#include <float.h>
+#include <math.h>
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#if __AVX512F__
+#include "avx512_mathfun.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+#include "x86_usability.h"
+
+namespace ncnn {
+
+Reduction_x86::Reduction_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+// ptr[i] = op(ptr[i], ptr1[i]) over size floats, lane agnostic
+template<typename Op>
+static void reduction_vertical(float* ptr, const float* ptr1, int size)
+{
+    Op op;
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512 _p = _mm512_loadu_ps(ptr + i);
+        __m512 _p1 = _mm512_loadu_ps(ptr1 + i);
+        _mm512_storeu_ps(ptr + i, op.func_pack16(_p, _p1));
+    }
+#endif // __AVX512F__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _p = _mm256_loadu_ps(ptr + i);
+        __m256 _p1 = _mm256_loadu_ps(ptr1 + i);
+        _mm256_storeu_ps(ptr + i, op.func_pack8(_p, _p1));
+    }
+#endif // __AVX__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128 _p = _mm_loadu_ps(ptr + i);
+        __m128 _p1 = _mm_loadu_ps(ptr1 + i);
+        _mm_storeu_ps(ptr + i, op.func_pack4(_p, _p1));
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        ptr[i] = op.func(ptr[i], ptr1[i]);
+    }
+}
+
+// reduce w packs of elempack lanes into elempack lanes
+// outptr[l] = op2(outptr[l], op(...op(v0, ptr[l]), ptr[elempack + l]...))
+template<typename Op, typename Op2>
+static void reduction_horizontal(const float* ptr, float* outptr, int w, int elempack, float v0)
+{
+    Op op;
+    Op2 op2;
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        __m512 _sum = _mm512_set1_ps(v0);
+        for (int i = 0; i < w; i++)
+        {
+            _sum = op.func_pack16(_sum, _mm512_loadu_ps(ptr));
+            ptr += 16;
+        }
+        _mm512_storeu_ps(outptr, op2.func_pack16(_mm512_loadu_ps(outptr), _sum));
+        return;
+    }
+#endif // __AVX512F__
+
+    if (elempack == 8)
+    {
+        __m256 _sum = _mm256_set1_ps(v0);
+        for (int i = 0; i < w; i++)
+        {
+            _sum = op.func_pack8(_sum, _mm256_loadu_ps(ptr));
+            ptr += 8;
+        }
+        _mm256_storeu_ps(outptr, op2.func_pack8(_mm256_loadu_ps(outptr), _sum));
+        return;
+    }
+#endif // __AVX__
+
+    if (elempack == 4)
+    {
+        __m128 _sum = _mm_set1_ps(v0);
+        for (int i = 0; i < w; i++)
+        {
+            _sum = op.func_pack4(_sum, _mm_loadu_ps(ptr));
+            ptr += 4;
+        }
+        _mm_storeu_ps(outptr, op2.func_pack4(_mm_loadu_ps(outptr), _sum));
+        return;
+    }
+#endif // __SSE2__
+
+    // elempack == 1, accumulate simd lanes and fold them with op2
+    float sum = v0;
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    {
+        __m512 _sum = _mm512_set1_ps(v0);
+        for (; i + 15 < w; i += 16)
+        {
+            _sum = op.func_pack16(_sum, _mm512_loadu_ps(ptr + i));
+        }
+        float tmp[16];
+        _mm512_storeu_ps(tmp, _sum);
+        for (int k = 0; k < 16; k++)
+            sum = op2.func(sum, tmp[k]);
+    }
+#endif // __AVX512F__
+    {
+        __m256 _sum = _mm256_set1_ps(v0);
+        for (; i + 7 < w; i += 8)
+        {
+            _sum = op.func_pack8(_sum, _mm256_loadu_ps(ptr + i));
+        }
+        float tmp[8];
+        _mm256_storeu_ps(tmp, _sum);
+        for (int k = 0; k < 8; k++)
+            sum = op2.func(sum, tmp[k]);
+    }
+#endif // __AVX__
+    {
+        __m128 _sum = _mm_set1_ps(v0);
+        for (; i + 3 < w; i += 4)
+        {
+            _sum = op.func_pack4(_sum, _mm_loadu_ps(ptr + i));
+        }
+        float tmp[4];
+        _mm_storeu_ps(tmp, _sum);
+        for (int k = 0; k < 4; k++)
+            sum = op2.func(sum, tmp[k]);
+    }
+#endif // __SSE2__
+    {
+        float sum1 = v0;
+        for (; i < w; i++)
+        {
+            sum1 = op.func(sum1, ptr[i]);
+        }
+        sum = op2.func(sum, sum1);
+    }
+
+    outptr[0] = op2.func(outptr[0], sum);
+}
+
+// reduce one channel of w h d packs into outptr laid out as the kept axes of w h d
+template<typename Op, typename Op2>
+static void reduction_channel(const float* ptr, float* outptr, int w, int h, int d, int elempack, bool reduce_w, bool reduce_h, bool reduce_d, float v0)
+{
+    const int outw = reduce_w ? 1 : w;
+    const int outh = reduce_h ? 1 : h;
+
+    for (int z = 0; z < d; z++)
+    {
+        for (int y = 0; y < h; y++)
+        {
+            const int oz = reduce_d ? 0 : z;
+            const int oy = reduce_h ? 0 : y;
+            float* outrow = outptr + (oz * outh + oy) * outw * elempack;
+
+            if (reduce_w)
+            {
+                reduction_horizontal<Op, Op2>(ptr, outrow, w, elempack, v0);
+            }
+            else
+            {
+                reduction_vertical<Op>(outrow, ptr, w * elempack);
+            }
+
+            ptr += w * elempack;
+        }
+    }
+}
+
+template<typename Op, typename Op2>
+static int reduction_op(const Mat& a, Mat& b, float v0, bool reduce_w, bool reduce_h, bool reduce_d, bool reduce_c, int keepdims, const Option& opt)
+{
+    Op2 op2;
+
+    const int dims = a.dims;
+    int elempack = a.elempack;
+
+    // view the blob as channels of w h d packs, the packed axis is always the outermost one
+    int w = a.w;
+    int h = a.h;
+    int d = a.d;
+    int channels = a.c;
+    size_t cstep = a.cstep;
+    if (dims == 1)
+    {
+        // treat as plain floats
+        w = a.w * elempack;
+        elempack = 1;
+        cstep = w;
+    }
+    if (dims == 2)
+    {
+        channels = a.h;
+        h = 1;
+        cstep = (size_t)a.w;
+    }
+
+    const int outw = reduce_w ? 1 : w;
+    const int outh = reduce_h ? 1 : h;
+    const int outd = reduce_d ? 1 : d;
+    const int outsize = outw * outh * outd;
+    const int out_elempack = reduce_c ? 1 : elempack;
+
+    // output shape follows the reference, reduced axes are dropped or kept as 1
+    {
+        int outshape[4];
+        int outdims = 0;
+        if (dims == 1)
+        {
+            outshape[outdims++] = 1;
+        }
+        if (dims == 2)
+        {
+            if (keepdims || !reduce_w) outshape[outdims++] = reduce_w ? 1 : a.w;
+            if (keepdims || !reduce_c) outshape[outdims++] = reduce_c ? 1 : a.h;
+        }
+        if (dims == 3)
+        {
+            if (keepdims || !reduce_w) outshape[outdims++] = reduce_w ? 1 : a.w;
+            if (keepdims || !reduce_h) outshape[outdims++] = reduce_h ? 1 : a.h;
+            if (keepdims || !reduce_c) outshape[outdims++] = reduce_c ? 1 : a.c;
+        }
+        if (dims == 4)
+        {
+            if (keepdims || !reduce_w) outshape[outdims++] = reduce_w ? 1 : a.w;
+            if (keepdims || !reduce_h) outshape[outdims++] = reduce_h ? 1 : a.h;
+            if (keepdims || !reduce_d) outshape[outdims++] = reduce_d ? 1 : a.d;
+            if (keepdims || !reduce_c) outshape[outdims++] = reduce_c ? 1 : a.c;
+        }
+        if (outdims == 0)
+        {
+            outshape[outdims++] = 1;
+        }
+
+        // the packed count stays on the outermost axis when channels are kept
+        const size_t out_elemsize = 4u * out_elempack;
+        if (outdims == 1)
+            b.create(outshape[0], out_elemsize, out_elempack, opt.blob_allocator);
+        if (outdims == 2)
+            b.create(outshape[0], outshape[1], out_elemsize, out_elempack, opt.blob_allocator);
+        if (outdims == 3)
+            b.create(outshape[0], outshape[1], outshape[2], out_elemsize, out_elempack, opt.blob_allocator);
+        if (outdims == 4)
+            b.create(outshape[0], outshape[1], outshape[2], outshape[3], out_elemsize, out_elempack, opt.blob_allocator);
+        if (b.empty())
+            return -100;
+    }
+
+    if (!reduce_c)
+    {
+        const size_t out_cstep = b.dims >= 3 ? b.cstep : (size_t)outsize;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            const float* ptr = (const float*)a.data + cstep * q * elempack;
+            float* outptr = (float*)b.data + out_cstep * q * out_elempack;
+
+            for (int i = 0; i < outsize * out_elempack; i++)
+            {
+                outptr[i] = v0;
+            }
+
+            reduction_channel<Op, Op2>(ptr, outptr, w, h, d, elempack, reduce_w, reduce_h, reduce_d, v0);
+        }
+
+        return 0;
+    }
+
+    // per channel partial results, then fold channels and the packed lanes with op2
+    Mat sums(outsize * elempack, channels, (size_t)4u, opt.workspace_allocator);
+    if (sums.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const float* ptr = (const float*)a.data + cstep * q * elempack;
+        float* sumsptr = sums.row(q);
+
+        for (int i = 0; i < outsize * elempack; i++)
+        {
+            sumsptr[i] = v0;
+        }
+
+        reduction_channel<Op, Op2>(ptr, sumsptr, w, h, d, elempack, reduce_w, reduce_h, reduce_d, v0);
+    }
+
+    for (int q = 1; q < channels; q++)
+    {
+        reduction_vertical<Op2>(sums.row(0), sums.row(q), outsize * elempack);
+    }
+
+    // d becomes the channel axis when only the channels of a 4d blob are dropped
+    const int out_planesize = b.dims == 3 ? b.w * b.h : outsize;
+    const size_t out_cstep = b.dims == 3 ? b.cstep : (size_t)outsize;
+
+    const float* sumsptr = sums.row(0);
+    float* outptr = b;
+    for (int i = 0; i < outsize; i++)
+    {
+        float sum = v0;
+        for (int l = 0; l < elempack; l++)
+        {
+            sum = op2.func(sum, sumsptr[l]);
+        }
+        outptr[i / out_planesize * out_cstep + i % out_planesize] = sum;
+        sumsptr += elempack;
+    }
+
+    return 0;
+}
+
+template<typename MathOp>
+static int reduction_post_process(Mat& a, float coeff, const Option& opt)
+{
+    MathOp mathop;
+
+    const int dims = a.dims;
+    const int channels = dims >= 3 ? a.c : 1;
+    const int size = dims >= 3 ? a.w * a.h * a.d * a.elempack : (int)a.total() * a.elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        float* ptr = dims >= 3 ? a.channel(q) : a;
+
+        int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+        __m512 _coeff_avx512 = _mm512_set1_ps(coeff);
+        for (; i + 15 < size; i += 16)
+        {
+            __m512 _p = _mm512_loadu_ps(ptr);
+            _p = _mm512_mul_ps(mathop.func_pack16(_p), _coeff_avx512);
+            _mm512_storeu_ps(ptr, _p);
+            ptr += 16;
+        }
+#endif // __AVX512F__
+        __m256 _coeff_avx = _mm256_set1_ps(coeff);
+        for (; i + 7 < size; i += 8)
+        {
+            __m256 _p = _mm256_loadu_ps(ptr);
+            _p = _mm256_mul_ps(mathop.func_pack8(_p), _coeff_avx);
+            _mm256_storeu_ps(ptr, _p);
+            ptr += 8;
+        }
+#endif // __AVX__
+        __m128 _coeff = _mm_set1_ps(coeff);
+        for (; i + 3 < size; i += 4)
+        {
+            __m128 _p = _mm_loadu_ps(ptr);
+            _p = _mm_mul_ps(mathop.func_pack4(_p), _coeff);
+            _mm_storeu_ps(ptr, _p);
+            ptr += 4;
+        }
+#endif // __SSE2__
+        for (; i < size; i++)
+        {
+            *ptr = mathop.func(*ptr) * coeff;
+            ptr++;
+        }
+    }
+
+    return 0;
+}
+
+template<typename Op, typename Op2, typename Op3>
+static int reduction(const Mat& a, Mat& b, float v0, bool reduce_w, bool reduce_h, bool reduce_d, bool reduce_c, bool post_process, float coeff, int keepdims, const Option& opt)
+{
+    int ret = reduction_op<Op, Op2>(a, b, v0, reduce_w, reduce_h, reduce_d, reduce_c, keepdims, opt);
+    if (ret != 0)
+        return -100;
+
+    if (post_process || fabs(coeff - 1.f) > FLT_EPSILON)
+    {
+        ret = reduction_post_process<Op3>(b, coeff, opt);
+        if (ret != 0)
+            return -100;
+    }
+
+    return 0;
+}
+
+namespace Reduction_x86_functor {
+
+struct post_process_identity
+{
+    float func(const float& x) const
+    {
+        return x;
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x) const
+    {
+        return x;
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x) const
+    {
+        return x;
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x) const
+    {
+        return x;
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct post_process_sqrt
+{
+    float func(const float& x) const
+    {
+        return (float)sqrt(x);
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x) const
+    {
+        return _mm_sqrt_ps(x);
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x) const
+    {
+        return _mm256_sqrt_ps(x);
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x) const
+    {
+        return _mm512_sqrt_ps(x);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct post_process_log
+{
+    float func(const float& x) const
+    {
+        return (float)log(x);
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x) const
+    {
+        return log_ps(x);
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x) const
+    {
+        return log256_ps(x);
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x) const
+    {
+        return log512_ps(x);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_add
+{
+    float func(const float& x, const float& y) const
+    {
+        return x + y;
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_add_ps(x, y);
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_add_ps(x, y);
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_add_ps(x, y);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_mul
+{
+    float func(const float& x, const float& y) const
+    {
+        return x * y;
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_mul_ps(x, y);
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_mul_ps(x, y);
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_mul_ps(x, y);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_asum
+{
+    float func(const float& x, const float& y) const
+    {
+        return (float)(x + fabs(y));
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_add_ps(x, _mm_andnot_ps(_mm_set1_ps(-0.f), y));
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_add_ps(x, _mm256_andnot_ps(_mm256_set1_ps(-0.f), y));
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_add_ps(x, _mm512_abs_ps(y));
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_sumsq
+{
+    float func(const float& x, const float& y) const
+    {
+        return x + y * y;
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_comp_fmadd_ps(y, y, x);
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_comp_fmadd_ps(y, y, x);
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_fmadd_ps(y, y, x);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_sumsexp
+{
+    float func(const float& x, const float& y) const
+    {
+        return (float)(x + exp(y));
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_add_ps(x, exp_ps(y));
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_add_ps(x, exp256_ps(y));
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_add_ps(x, exp512_ps(y));
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_max
+{
+    float func(const float& x, const float& y) const
+    {
+        return std::max(x, y);
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_max_ps(x, y);
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_max_ps(x, y);
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_max_ps(x, y);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_min
+{
+    float func(const float& x, const float& y) const
+    {
+        return std::min(x, y);
+    }
+#if __SSE2__
+    __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_min_ps(x, y);
+    }
+#if __AVX__
+    __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_min_ps(x, y);
+    }
+#if __AVX512F__
+    __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_min_ps(x, y);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+} // namespace Reduction_x86_functor
+
+int Reduction_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    using namespace Reduction_x86_functor;
+
+    int dims = bottom_blob.dims;
+    int elempack = bottom_blob.elempack;
+    int axes_flag[4] = {0};
+    bool reduce_w = false;
+    bool reduce_h = false;
+    bool reduce_d = false;
+    bool reduce_c = false;
+
+    if (reduce_all)
+    {
+        reduce_w = true;
+        reduce_h = true;
+        reduce_d = true;
+        reduce_c = true;
+    }
+    else
+    {
+        const int* axes_ptr = axes;
+        int reduced_axes_num = axes.w;
+
+        for (int i = 0; i < reduced_axes_num; i++)
+        {
+            int axis = axes_ptr[i];
+            // handle negative axis
+            if (axis < 0)
+                axis += dims;
+            axes_flag[axis] = 1;
+        }
+
+        if (dims == 1)
+        {
+            reduce_w = true;
+        }
+        else if (dims == 2)
+        {
+            if (axes_flag[0] == 1) reduce_h = true;
+            if (axes_flag[1] == 1) reduce_w = true;
+        }
+        else if (dims == 3)
+        {
+            if (axes_flag[0] == 1) reduce_c = true;
+            if (axes_flag[1] == 1) reduce_h = true;
+            if (axes_flag[2] == 1) reduce_w = true;
+        }
+        else if (dims == 4)
+        {
+            if (axes_flag[0] == 1) reduce_c = true;
+            if (axes_flag[1] == 1) reduce_d = true;
+            if (axes_flag[2] == 1) reduce_h = true;
+            if (axes_flag[3] == 1) reduce_w = true;
+        }
+    }
+
+    // the rows of a 2d blob act as channels
+    if (dims == 2)
+    {
+        reduce_c = reduce_h;
+        reduce_h = false;
+    }
+
+    if (dims > 1 && !reduce_w && !reduce_h && !reduce_d && !reduce_c)
+    {
+        // nothing to reduce, leave it to the reference implementation
+        Mat bottom_blob_unpacked = bottom_blob;
+        if (elempack != 1)
+        {
+            Option opt_p = opt;
+            opt_p.blob_allocator = opt.workspace_allocator;
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_p);
+            if (bottom_blob_unpacked.empty())
+                return -100;
+        }
+
+        return Reduction::forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
+    if (operation == ReductionOp_SUM)
+        return reduction<reduction_op_add, reduction_op_add, post_process_identity>(bottom_blob, top_blob, 0.f, reduce_w, reduce_h, reduce_d, reduce_c, false, coeff, keepdims, opt);
+
+    if (operation == ReductionOp_ASUM)
+        return reduction<reduction_op_asum, reduction_op_add, post_process_identity>(bottom_blob, top_blob, 0.f, reduce_w, reduce_h, reduce_d, reduce_c, false, coeff, keepdims, opt);
+
+    if (operation == ReductionOp_SUMSQ)
+        return reduction<reduction_op_sumsq, reduction_op_add, post_process_identity>(bottom_blob, top_blob, 0.f, reduce_w, reduce_h, reduce_d, reduce_c, false, coeff, keepdims, opt);
+
+    if (operation == ReductionOp_MEAN)
+    {
+        // count unpacked elements
+        int scale = 1;
+        if (dims == 1)
+        {
+            scale = bottom_blob.w * elempack;
+        }
+        else if (dims == 2)
+        {
+            if (reduce_w) scale *= bottom_blob.w;
+            if (reduce_c) scale *= bottom_blob.h * elempack;
+        }
+        else
+        {
+            if (reduce_w) scale *= bottom_blob.w;
+            if (reduce_h) scale *= bottom_blob.h;
+            if (reduce_d) scale *= bottom_blob.d;
+            if (reduce_c) scale *= bottom_blob.c * elempack;
+        }
+
+        float coeff_mean = coeff / scale;
+        return reduction<reduction_op_add, reduction_op_add, post_process_identity>(bottom_blob, top_blob, 0.f, reduce_w, reduce_h, reduce_d, reduce_c, true, coeff_mean, keepdims, opt);
+    }
+
+    if (operation == ReductionOp_MAX)
+        return reduction<reduction_op_max, reduction_op_max, post_process_identity>(bottom_blob, top_blob, -FLT_MAX, reduce_w, reduce_h, reduce_d, reduce_c, false, coeff, keepdims, opt);
+
+    if (operation == ReductionOp_MIN)
+        return reduction<reduction_op_min, reduction_op_min, post_process_identity>(bottom_blob, top_blob, FLT_MAX, reduce_w, reduce_h, reduce_d, reduce_c, false, coeff, keepdims, opt);
+
+    if (operation == ReductionOp_PROD)
+        return reduction<reduction_op_mul, reduction_op_mul, post_process_identity>(bottom_blob, top_blob, 1.f, reduce_w, reduce_h, reduce_d, reduce_c, false, coeff, keepdims, opt);
+
+    if (operation == ReductionOp_L1)
+        return reduction<reduction_op_asum, reduction_op_add, post_process_identity>(bottom_blob, top_blob, 0.f, reduce_w, reduce_h, reduce_d, reduce_c, false, 1.f, keepdims, opt);
+
+    if (operation == ReductionOp_L2)
+        return reduction<reduction_op_sumsq, reduction_op_add, post_process_sqrt>(bottom_blob, top_blob, 0.f, reduce_w, reduce_h, reduce_d, reduce_c, true, 1.f, keepdims, opt);
+
+    if (operation == ReductionOp_LogSum)
+        return reduction<reduction_op_add, reduction_op_add, post_process_log>(bottom_blob, top_blob, 0.f, reduce_w, reduce_h, reduce_d, reduce_c, true, 1.f, keepdims, opt);
+
+    if (operation == ReductionOp_LogSumExp)
+        return reduction<reduction_op_sumsexp, reduction_op_add, post_process_log>(bottom_blob, top_blob, 0.f, reduce_w, reduce_h, reduce_d, reduce_c, true, 1.f, keepdims, opt);
+
+    return 0;
+}
+
+} // namespace ncnn
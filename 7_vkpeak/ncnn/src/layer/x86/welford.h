@@ -0,0 +1,193 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef X86_WELFORD_H
+#define X86_WELFORD_H
+
+// shared by groupnorm and instancenorm, include after the intrinsic headers and x86_usability.h
+
+// chan's parallel formula, merge (n1, mean1, m21) into (n, mean, m2)
+static NCNN_FORCEINLINE void welford_merge(float& n, float& mean, float& m2, float n1, float mean1, float m21)
+{
+    if (n1 == 0.f)
+        return;
+
+    const float n01 = n + n1;
+    const float delta = mean1 - mean;
+    mean += delta * n1 / n01;
+    m2 += m21 + delta * delta * n * n1 / n01;
+    n = n01;
+}
+
+// single pass welford statistics over size floats laid out with elempack
+// every simd lane keeps its own running mean and m2, lane l folds into n/mean/m2[l % elempack]
+static inline void welford_accumulate(const float* ptr, int size, int elempack, float* n, float* mean, float* m2)
+{
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    {
+        __m512 _mean = _mm512_setzero_ps();
+        __m512 _m2 = _mm512_setzero_ps();
+        int count = 0;
+        for (; i + 15 < size; i += 16)
+        {
+            count++;
+            __m512 _p = _mm512_loadu_ps(ptr + i);
+            __m512 _delta = _mm512_sub_ps(_p, _mean);
+            _mean = _mm512_fmadd_ps(_delta, _mm512_set1_ps(1.f / count), _mean);
+            _m2 = _mm512_fmadd_ps(_delta, _mm512_sub_ps(_p, _mean), _m2);
+        }
+        if (count > 0)
+        {
+            float tmp_mean[16];
+            float tmp_m2[16];
+            _mm512_storeu_ps(tmp_mean, _mean);
+            _mm512_storeu_ps(tmp_m2, _m2);
+            for (int l = 0; l < 16; l++)
+            {
+                const int k = l % elempack;
+                welford_merge(n[k], mean[k], m2[k], (float)count, tmp_mean[l], tmp_m2[l]);
+            }
+        }
+    }
+#endif // __AVX512F__
+    {
+        __m256 _mean = _mm256_setzero_ps();
+        __m256 _m2 = _mm256_setzero_ps();
+        int count = 0;
+        for (; i + 7 < size; i += 8)
+        {
+            count++;
+            __m256 _p = _mm256_loadu_ps(ptr + i);
+            __m256 _delta = _mm256_sub_ps(_p, _mean);
+            _mean = _mm256_comp_fmadd_ps(_delta, _mm256_set1_ps(1.f / count), _mean);
+            _m2 = _mm256_comp_fmadd_ps(_delta, _mm256_sub_ps(_p, _mean), _m2);
+        }
+        if (count > 0)
+        {
+            float tmp_mean[8];
+            float tmp_m2[8];
+            _mm256_storeu_ps(tmp_mean, _mean);
+            _mm256_storeu_ps(tmp_m2, _m2);
+            for (int l = 0; l < 8; l++)
+            {
+                const int k = l % elempack;
+                welford_merge(n[k], mean[k], m2[k], (float)count, tmp_mean[l], tmp_m2[l]);
+            }
+        }
+    }
+#endif // __AVX__
+    {
+        __m128 _mean = _mm_setzero_ps();
+        __m128 _m2 = _mm_setzero_ps();
+        int count = 0;
+        for (; i + 3 < size; i += 4)
+        {
+            count++;
+            __m128 _p = _mm_loadu_ps(ptr + i);
+            __m128 _delta = _mm_sub_ps(_p, _mean);
+            _mean = _mm_comp_fmadd_ps(_delta, _mm_set1_ps(1.f / count), _mean);
+            _m2 = _mm_comp_fmadd_ps(_delta, _mm_sub_ps(_p, _mean), _m2);
+        }
+        if (count > 0)
+        {
+            float tmp_mean[4];
+            float tmp_m2[4];
+            _mm_storeu_ps(tmp_mean, _mean);
+            _mm_storeu_ps(tmp_m2, _m2);
+            for (int l = 0; l < 4; l++)
+            {
+                const int k = l % elempack;
+                welford_merge(n[k], mean[k], m2[k], (float)count, tmp_mean[l], tmp_m2[l]);
+            }
+        }
+    }
+#endif // __SSE2__
+    {
+        // elempack == 1 remainder
+        float _mean = 0.f;
+        float _m2 = 0.f;
+        int count = 0;
+        for (; i < size; i++)
+        {
+            count++;
+            float delta = ptr[i] - _mean;
+            _mean += delta / count;
+            _m2 += delta * (ptr[i] - _mean);
+        }
+        if (count > 0)
+        {
+            welford_merge(n[0], mean[0], m2[0], (float)count, _mean, _m2);
+        }
+    }
+}
+
+// ptr = ptr * a + b, a and b hold elempack lanes
+static inline void scale_bias(float* ptr, int size, int elempack, const float* a, const float* b)
+{
+    // replicate the elempack lanes so that any vector width loads the right pattern
+    float a16[16];
+    float b16[16];
+    for (int l = 0; l < 16; l++)
+    {
+        a16[l] = a[l % elempack];
+        b16[l] = b[l % elempack];
+    }
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    {
+        __m512 _a = _mm512_loadu_ps(a16);
+        __m512 _b = _mm512_loadu_ps(b16);
+        for (; i + 15 < size; i += 16)
+        {
+            __m512 _p = _mm512_loadu_ps(ptr + i);
+            _p = _mm512_fmadd_ps(_p, _a, _b);
+            _mm512_storeu_ps(ptr + i, _p);
+        }
+    }
+#endif // __AVX512F__
+    {
+        __m256 _a = _mm256_loadu_ps(a16);
+        __m256 _b = _mm256_loadu_ps(b16);
+        for (; i + 7 < size; i += 8)
+        {
+            __m256 _p = _mm256_loadu_ps(ptr + i);
+            _p = _mm256_comp_fmadd_ps(_p, _a, _b);
+            _mm256_storeu_ps(ptr + i, _p);
+        }
+    }
+#endif // __AVX__
+    {
+        __m128 _a = _mm_loadu_ps(a16);
+        __m128 _b = _mm_loadu_ps(b16);
+        for (; i + 3 < size; i += 4)
+        {
+            __m128 _p = _mm_loadu_ps(ptr + i);
+            _p = _mm_comp_fmadd_ps(_p, _a, _b);
+            _mm_storeu_ps(ptr + i, _p);
+        }
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        ptr[i] = ptr[i] * a16[0] + b16[0];
+    }
+}
+
+#endif // X86_WELFORD_H
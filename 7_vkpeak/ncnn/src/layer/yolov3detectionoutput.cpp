@@ -14,6 +14,7 @@
 
 #include "yolov3detectionoutput.h"
 
+#include "detection_postprocess.h"
 #include "layer_type.h"
 
 #include <float.h>
@@ -52,49 +53,25 @@ int Yolov3DetectionOutput::load_param(const ParamDict& pd)
     return 0;
 }
 
-static inline float intersection_area(const Yolov3DetectionOutput::BBoxRect& a, const Yolov3DetectionOutput::BBoxRect& b)
-{
-    if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin)
-    {
-        // no intersection
-        return 0.f;
-    }
-
-    float inter_width = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-    float inter_height = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-
-    return inter_width * inter_height;
-}
-
 void Yolov3DetectionOutput::qsort_descent_inplace(std::vector<BBoxRect>& datas, int left, int right) const
 {
-    int i = left;
-    int j = right;
-    float p = datas[(left + right) / 2].score;
+    if (left >= right)
+        return;
 
-    while (i <= j)
+    std::vector<BBoxRect> range_datas(right - left + 1);
+    std::vector<float> range_scores(right - left + 1);
+    for (int i = left; i <= right; i++)
     {
-        while (datas[i].score > p)
-            i++;
-
-        while (datas[j].score < p)
-            j--;
-
-        if (i <= j)
-        {
-            // swap
-            std::swap(datas[i], datas[j]);
-
-            i++;
-            j--;
-        }
+        range_datas[i - left] = datas[i];
+        range_scores[i - left] = datas[i].score;
     }
 
-    if (left < j)
-        qsort_descent_inplace(datas, left, j);
+    sort_descent_inplace(range_datas, range_scores);
 
-    if (i < right)
-        qsort_descent_inplace(datas, i, right);
+    for (int i = left; i <= right; i++)
+    {
+        datas[i] = range_datas[i - left];
+    }
 }
 
 void Yolov3DetectionOutput::qsort_descent_inplace(std::vector<BBoxRect>& datas) const
@@ -107,33 +84,7 @@ void Yolov3DetectionOutput::qsort_descent_inplace(std::vector<BBoxRect>& datas)
 
 void Yolov3DetectionOutput::nms_sorted_bboxes(std::vector<BBoxRect>& bboxes, std::vector<size_t>& picked, float nms_threshold) const
 {
-    picked.clear();
-
-    const size_t n = bboxes.size();
-
-    for (size_t i = 0; i < n; i++)
-    {
-        const BBoxRect& a = bboxes[i];
-
-        int keep = 1;
-        for (int j = 0; j < (int)picked.size(); j++)
-        {
-            const BBoxRect& b = bboxes[picked[j]];
-
-            // intersection over union
-            float inter_area = intersection_area(a, b);
-            float union_area = a.area + b.area - inter_area;
-            // float IoU = inter_area / union_area
-            if (inter_area > nms_threshold * union_area)
-            {
-                keep = 0;
-                break;
-            }
-        }
-
-        if (keep)
-            picked.push_back(i);
-    }
+    ncnn::nms_sorted_bboxes(bboxes, picked, nms_threshold);
 }
 
 static inline float sigmoid(float x)
@@ -1687,11 +1687,17 @@ void cast_bfloat16_to_float32(const Mat& src, Mat& dst, const Option& opt)
 }
 
 void quantize_to_int8(const Mat& src, Mat& dst, const Mat& scale_data, const Option& opt)
+{
+    quantize_to_int8(src, dst, scale_data, 0, opt);
+}
+
+void quantize_to_int8(const Mat& src, Mat& dst, const Mat& scale_data, int zero_point, const Option& opt)
 {
     Layer* quantize = create_layer(LayerType::Quantize);
 
     ParamDict pd;
     pd.set(0, scale_data.w);
+    pd.set(1, zero_point);
 
     quantize->load_param(pd);
 
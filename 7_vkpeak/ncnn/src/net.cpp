@@ -19,6 +19,7 @@
 #include "layer_type.h"
 #include "modelbin.h"
 #include "paramdict.h"
+#include "weightcache.h"
 
 #include <stdarg.h>
 #include <stdint.h>
@@ -33,8 +34,52 @@
 #include "pipelinecache.h"
 #endif // NCNN_VULKAN
 
+#if NCNN_STDIO
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif // NCNN_STDIO
+
 namespace ncnn {
 
+// ncnnpack container header, all fields little-endian
+// the binary param section follows the header
+// the weight section starts at a 64-byte aligned offset
+struct ncnnpack_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t param_offset;
+    uint64_t param_size;
+    uint64_t model_offset;
+    uint64_t model_size;
+    uint64_t hash;
+    uint32_t reserved[4];
+};
+
+static const uint32_t NCNNPACK_MAGIC = 0x4b50434e; // NCPK
+static const uint32_t NCNNPACK_VERSION = 1;
+
+// the header hash is fnv-1a over the param section and then the model section
+static uint64_t ncnnpack_hash(const unsigned char* p, uint64_t size, uint64_t hash)
+{
+    for (uint64_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
 class NetPrivate
 {
 public:
@@ -57,6 +102,7 @@ public:
 #endif // NCNN_VULKAN
 
     int convert_layout(Mat& bottom_blob, const Layer* layer, const Option& opt) const;
+    void add_convert_layout_bytes(const Mat& m) const;
 
     int do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats, const Option& opt) const;
 #if NCNN_VULKAN
@@ -84,6 +130,22 @@ public:
     PoolAllocator* local_blob_allocator;
     PoolAllocator* local_workspace_allocator;
 
+    // bytes produced by convert_layout, shared by concurrent extractors
+    mutable size_t convert_layout_bytes;
+    mutable Mutex convert_layout_bytes_lock;
+
+    // weight bytes read by each layer in load_model
+    std::vector<size_t> layer_weight_bytes;
+
+#if NCNN_STDIO
+    // file mapping retained by load_pack
+    int map_pack(const char* packpath);
+    void unmap_pack();
+
+    const unsigned char* pack_data;
+    size_t pack_size;
+#endif // NCNN_STDIO
+
 #if NCNN_VULKAN
     const VulkanDevice* vkdev;
 
@@ -100,6 +162,13 @@ NetPrivate::NetPrivate(Option& _opt)
     local_blob_allocator = 0;
     local_workspace_allocator = 0;
 
+    convert_layout_bytes = 0;
+
+#if NCNN_STDIO
+    pack_data = 0;
+    pack_size = 0;
+#endif // NCNN_STDIO
+
 #if NCNN_VULKAN
     vkdev = 0;
     weight_vkallocator = 0;
@@ -108,6 +177,91 @@ NetPrivate::NetPrivate(Option& _opt)
 #endif // NCNN_VULKAN
 }
 
+#if NCNN_STDIO
+int NetPrivate::map_pack(const char* packpath)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(packpath, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        NCNN_LOGE("open %s failed", packpath);
+        return -1;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+        NCNN_LOGE("stat %s failed", packpath);
+        CloseHandle(file);
+        return -1;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        NCNN_LOGE("mmap %s failed", packpath);
+        return -1;
+    }
+
+    // the view keeps the mapping object alive
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data)
+    {
+        NCNN_LOGE("mmap %s failed", packpath);
+        return -1;
+    }
+
+    pack_data = (const unsigned char*)data;
+    pack_size = (size_t)file_size.QuadPart;
+#else
+    int fd = open(packpath, O_RDONLY);
+    if (fd < 0)
+    {
+        NCNN_LOGE("open %s failed", packpath);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        NCNN_LOGE("stat %s failed", packpath);
+        close(fd);
+        return -1;
+    }
+
+    void* data = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        NCNN_LOGE("mmap %s failed", packpath);
+        return -1;
+    }
+
+    pack_data = (const unsigned char*)data;
+    pack_size = (size_t)st.st_size;
+#endif
+
+    return 0;
+}
+
+void NetPrivate::unmap_pack()
+{
+    if (!pack_data)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(pack_data);
+#else
+    munmap((void*)pack_data, pack_size);
+#endif
+
+    pack_data = 0;
+    pack_size = 0;
+}
+#endif // NCNN_STDIO
+
 static Option get_masked_option(const Option& opt, int featmask)
 {
     // mask option usage as layer specific featmask
@@ -801,12 +955,14 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
             Mat bottom_blob_fp16;
             cast_float32_to_float16(bottom_blob, bottom_blob_fp16, opt);
             bottom_blob = bottom_blob_fp16;
+            add_convert_layout_bytes(bottom_blob);
         }
         if (bottom_blob.elembits() == 16 && !layer->support_fp16_storage)
         {
             Mat bottom_blob_fp32;
             cast_float16_to_float32(bottom_blob, bottom_blob_fp32, opt);
             bottom_blob = bottom_blob_fp32;
+            add_convert_layout_bytes(bottom_blob);
         }
     }
     else
@@ -819,12 +975,14 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
             Mat bottom_blob_fp16;
             cast_float32_to_float16(bottom_blob, bottom_blob_fp16, opt);
             bottom_blob = bottom_blob_fp16;
+            add_convert_layout_bytes(bottom_blob);
         }
         if (bottom_blob.elembits() == 16 && !layer->support_fp16_storage)
         {
             Mat bottom_blob_fp32;
             cast_float16_to_float32(bottom_blob, bottom_blob_fp32, opt);
             bottom_blob = bottom_blob_fp32;
+            add_convert_layout_bytes(bottom_blob);
         }
     }
     else
@@ -837,12 +995,14 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
             Mat bottom_blob_bf16;
             cast_float32_to_bfloat16(bottom_blob, bottom_blob_bf16, opt);
             bottom_blob = bottom_blob_bf16;
+            add_convert_layout_bytes(bottom_blob);
         }
         if (bottom_blob.elembits() == 16 && !layer->support_bf16_storage)
         {
             Mat bottom_blob_fp32;
             cast_bfloat16_to_float32(bottom_blob, bottom_blob_fp32, opt);
             bottom_blob = bottom_blob_fp32;
+            add_convert_layout_bytes(bottom_blob);
         }
     }
     else
@@ -925,11 +1085,18 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
         Mat bottom_blob_packed;
         convert_packing(bottom_blob, bottom_blob_packed, dst_elempack, opt);
         bottom_blob = bottom_blob_packed;
+        add_convert_layout_bytes(bottom_blob);
     }
 
     return 0;
 }
 
+void NetPrivate::add_convert_layout_bytes(const Mat& m) const
+{
+    MutexLockGuard lock(convert_layout_bytes_lock);
+    convert_layout_bytes += m.total() * m.elemsize;
+}
+
 int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats, const Option& opt) const
 {
     if (layer->one_blob_only)
@@ -1863,6 +2030,48 @@ int Net::load_param_bin(const DataReader& dr)
     return 0;
 }
 
+// route every loaded weight through the shared weight cache
+class ModelBinFromWeightCache : public ModelBin
+{
+public:
+    ModelBinFromWeightCache(const ModelBin& _mb, WeightCache* _weight_cache)
+        : mb(_mb), weight_cache(_weight_cache)
+    {
+    }
+
+    virtual Mat load(int w, int type) const
+    {
+        return weight_cache->share(mb.load(w, type));
+    }
+
+private:
+    const ModelBin& mb;
+    WeightCache* weight_cache;
+};
+
+// count the bytes of every loaded weight
+class ModelBinWithBookkeeping : public ModelBin
+{
+public:
+    ModelBinWithBookkeeping(const ModelBin& _mb)
+        : mb(_mb), bytes(0)
+    {
+    }
+
+    virtual Mat load(int w, int type) const
+    {
+        Mat m = mb.load(w, type);
+        bytes += m.total() * m.elemsize;
+        return m;
+    }
+
+private:
+    const ModelBin& mb;
+
+public:
+    mutable size_t bytes;
+};
+
 int Net::load_model(const DataReader& dr)
 {
     if (d->layers.empty())
@@ -1876,7 +2085,10 @@ int Net::load_model(const DataReader& dr)
     // load file
     int ret = 0;
 
-    ModelBinFromDataReader mb(dr);
+    ModelBinFromDataReader mb0(dr);
+    ModelBinFromWeightCache mb1(mb0, opt.weight_cache);
+    ModelBinWithBookkeeping mb(opt.weight_cache ? (const ModelBin&)mb1 : (const ModelBin&)mb0);
+    d->layer_weight_bytes.resize(layer_count, 0);
     for (int i = 0; i < layer_count; i++)
     {
         Layer* layer = d->layers[i];
@@ -1889,7 +2101,9 @@ int Net::load_model(const DataReader& dr)
             break;
         }
 
+        mb.bytes = 0;
         int lret = layer->load_model(mb);
+        d->layer_weight_bytes[i] = mb.bytes;
         if (lret != 0)
         {
 #if NCNN_STRING
@@ -2049,6 +2263,43 @@ int Net::load_model(const char* modelpath)
     fclose(fp);
     return ret;
 }
+
+int Net::load_pack(const char* packpath)
+{
+    if (d->pack_data)
+    {
+        // the previous net references the previous mapping
+        clear();
+    }
+
+    if (d->map_pack(packpath) != 0)
+        return -1;
+
+    if (d->pack_size < sizeof(ncnnpack_header))
+    {
+        NCNN_LOGE("%s is too small for ncnnpack", packpath);
+        d->unmap_pack();
+        return -1;
+    }
+
+    ncnnpack_header header;
+    memcpy(&header, d->pack_data, sizeof(header));
+    if (header.param_offset + header.param_size > d->pack_size || header.model_offset + header.model_size > d->pack_size)
+    {
+        NCNN_LOGE("%s is truncated", packpath);
+        d->unmap_pack();
+        return -1;
+    }
+
+    size_t consumed = load_pack(d->pack_data);
+    if (consumed == 0)
+    {
+        clear();
+        return -1;
+    }
+
+    return 0;
+}
 #endif // NCNN_STDIO
 
 int Net::load_param(const unsigned char* _mem)
@@ -2067,6 +2318,47 @@ int Net::load_model(const unsigned char* _mem)
     return static_cast<int>(mem - _mem);
 }
 
+size_t Net::load_pack(const unsigned char* mem)
+{
+    ncnnpack_header header;
+    memcpy(&header, mem, sizeof(header));
+    if (header.magic != NCNNPACK_MAGIC)
+    {
+        NCNN_LOGE("invalid ncnnpack magic %x", header.magic);
+        return 0;
+    }
+    if (header.version != NCNNPACK_VERSION)
+    {
+        NCNN_LOGE("unsupported ncnnpack version %u", header.version);
+        return 0;
+    }
+
+    const unsigned char* param_mem = mem + header.param_offset;
+    const unsigned char* model_mem = mem + header.model_offset;
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = ncnnpack_hash(param_mem, header.param_size, hash);
+    hash = ncnnpack_hash(model_mem, header.model_size, hash);
+    if (hash != header.hash)
+    {
+        NCNN_LOGE("ncnnpack hash mismatch %016llx, expect %016llx", (unsigned long long)hash, (unsigned long long)header.hash);
+        return 0;
+    }
+
+    DataReaderFromMemory param_dr(param_mem);
+    int ret = load_param_bin(param_dr);
+    if (ret != 0)
+        return 0;
+
+    // weight data is referenced in place, no copy
+    DataReaderFromMemory model_dr(model_mem);
+    ret = load_model(model_dr);
+    if (ret != 0)
+        return 0;
+
+    return static_cast<size_t>(header.model_offset + header.model_size);
+}
+
 #if NCNN_PLATFORM_API
 #if __ANDROID_API__ >= 9
 #if NCNN_STRING
@@ -2136,6 +2428,7 @@ int Net::load_model(AAssetManager* mgr, const char* assetpath)
 void Net::clear()
 {
     d->blobs.clear();
+    d->layer_weight_bytes.clear();
     for (size_t i = 0; i < d->layers.size(); i++)
     {
         Layer* layer = d->layers[i];
@@ -2185,6 +2478,11 @@ void Net::clear()
         d->local_workspace_allocator = 0;
     }
 
+#if NCNN_STDIO
+    // layers referencing the mapping are gone now
+    d->unmap_pack();
+#endif // NCNN_STDIO
+
 #if NCNN_VULKAN
     if (d->weight_vkallocator)
     {
@@ -2205,6 +2503,185 @@ void Net::clear()
 #endif // NCNN_VULKAN
 }
 
+MemoryFootprint::MemoryFootprint()
+{
+    blob_bytes = 0;
+    workspace_bytes = 0;
+    peak_bytes = 0;
+    weight_bytes = 0;
+}
+
+// track live bytes, the overall peak and the peak since the last mark
+class MemoryFootprintAllocator : public Allocator
+{
+public:
+    MemoryFootprintAllocator(size_t& _total_current, size_t& _total_peak)
+        : current(0), peak(0), layer_peak(0), total_current(_total_current), total_peak(_total_peak)
+    {
+    }
+
+    virtual void* fastMalloc(size_t size)
+    {
+        MutexLockGuard g(lock);
+
+        void* ptr = ncnn::fastMalloc(size);
+        bookkeeper.push_back(std::make_pair(ptr, size));
+
+        current += size;
+        peak = std::max(peak, current);
+        layer_peak = std::max(layer_peak, current);
+
+        total_current += size;
+        total_peak = std::max(total_peak, total_current);
+
+        return ptr;
+    }
+
+    virtual void fastFree(void* ptr)
+    {
+        MutexLockGuard g(lock);
+
+        for (size_t i = 0; i < bookkeeper.size(); i++)
+        {
+            if (bookkeeper[i].first != ptr)
+                continue;
+
+            current -= bookkeeper[i].second;
+            total_current -= bookkeeper[i].second;
+            bookkeeper[i] = bookkeeper[bookkeeper.size() - 1];
+            bookkeeper.resize(bookkeeper.size() - 1);
+            break;
+        }
+
+        ncnn::fastFree(ptr);
+    }
+
+    void mark_layer()
+    {
+        MutexLockGuard g(lock);
+        layer_peak = current;
+    }
+
+public:
+    size_t current;
+    size_t peak;
+    size_t layer_peak;
+
+private:
+    size_t& total_current;
+    size_t& total_peak;
+    Mutex lock;
+    std::vector<std::pair<void*, size_t> > bookkeeper;
+};
+
+static int estimate_forward_layer(const NetPrivate* d, int layer_index, std::vector<Mat>& blob_mats, const Option& opt, MemoryFootprintAllocator& blob_allocator, MemoryFootprintAllocator& workspace_allocator, MemoryFootprint& footprint)
+{
+    // resolve bottoms in the same order as forward_layer
+    const Layer* layer = d->layers[layer_index];
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        int bottom_blob_index = layer->bottoms[i];
+        if (blob_mats[bottom_blob_index].dims != 0)
+            continue;
+
+        int ret = estimate_forward_layer(d, d->blobs[bottom_blob_index].producer, blob_mats, opt, blob_allocator, workspace_allocator, footprint);
+        if (ret != 0)
+            return ret;
+    }
+
+    blob_allocator.mark_layer();
+    workspace_allocator.mark_layer();
+
+    int ret = d->forward_layer(layer_index, blob_mats, opt);
+
+    footprint.layer_blob_bytes[layer_index] = blob_allocator.layer_peak;
+    footprint.layer_workspace_bytes[layer_index] = workspace_allocator.layer_peak;
+
+    return ret;
+}
+
+int Net::estimate_memory_footprint(const std::vector<Mat>& input_shapes, const Option& _opt, MemoryFootprint& footprint) const
+{
+    if (input_shapes.size() != d->input_blob_indexes.size())
+    {
+        NCNN_LOGE("expect %d input shapes but got %d", (int)d->input_blob_indexes.size(), (int)input_shapes.size());
+        return -1;
+    }
+
+    const size_t layer_count = d->layers.size();
+
+    size_t total_current = 0;
+    size_t total_peak = 0;
+    MemoryFootprintAllocator blob_allocator(total_current, total_peak);
+    MemoryFootprintAllocator workspace_allocator(total_current, total_peak);
+
+    Option opt1 = _opt;
+    opt1.blob_allocator = &blob_allocator;
+    opt1.workspace_allocator = &workspace_allocator;
+    opt1.use_vulkan_compute = false;
+
+    footprint.layer_blob_bytes.clear();
+    footprint.layer_blob_bytes.resize(layer_count, 0);
+    footprint.layer_workspace_bytes.clear();
+    footprint.layer_workspace_bytes.resize(layer_count, 0);
+    footprint.layer_weight_bytes = d->layer_weight_bytes;
+    footprint.layer_weight_bytes.resize(layer_count, 0);
+
+    footprint.weight_bytes = 0;
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        footprint.weight_bytes += footprint.layer_weight_bytes[i];
+    }
+
+    int ret = 0;
+
+    {
+        std::vector<Mat> blob_mats(d->blobs.size());
+
+        // the caller keeps its inputs alive until extract returns
+        std::vector<Mat> input_mats(input_shapes.size());
+
+        for (size_t i = 0; i < input_shapes.size(); i++)
+        {
+            const Mat& shape = input_shapes[i];
+
+            Mat m;
+            if (shape.dims == 1) m.create(shape.w, 4u, &blob_allocator);
+            if (shape.dims == 2) m.create(shape.w, shape.h, 4u, &blob_allocator);
+            if (shape.dims == 3) m.create(shape.w, shape.h, shape.c, 4u, &blob_allocator);
+            if (shape.dims == 4) m.create(shape.w, shape.h, shape.d, shape.c, 4u, &blob_allocator);
+            if (m.empty())
+            {
+                NCNN_LOGE("invalid input shape %d", (int)i);
+                return -1;
+            }
+
+            m.fill(0.f);
+
+            input_mats[i] = m;
+            blob_mats[d->input_blob_indexes[i]] = m;
+        }
+
+        // keep every output alive as the caller of extract would
+        for (size_t i = 0; i < d->output_blob_indexes.size(); i++)
+        {
+            int blob_index = d->output_blob_indexes[i];
+            if (blob_mats[blob_index].dims != 0)
+                continue;
+
+            ret = estimate_forward_layer(d, d->blobs[blob_index].producer, blob_mats, opt1, blob_allocator, workspace_allocator, footprint);
+            if (ret != 0)
+                break;
+        }
+    }
+
+    footprint.blob_bytes = blob_allocator.peak;
+    footprint.workspace_bytes = workspace_allocator.peak;
+    footprint.peak_bytes = total_peak;
+
+    return ret;
+}
+
 Extractor Net::create_extractor() const
 {
     return Extractor(this, d->blobs.size());
@@ -2252,6 +2729,18 @@ std::vector<Layer*>& Net::mutable_layers()
     return d->layers;
 }
 
+size_t Net::convert_layout_bytes() const
+{
+    MutexLockGuard lock(d->convert_layout_bytes_lock);
+    return d->convert_layout_bytes;
+}
+
+void Net::reset_convert_layout_bytes()
+{
+    MutexLockGuard lock(d->convert_layout_bytes_lock);
+    d->convert_layout_bytes = 0;
+}
+
 #if NCNN_VULKAN
 void Net::set_vulkan_device(int device_index)
 {
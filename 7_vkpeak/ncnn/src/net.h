@@ -34,6 +34,29 @@ class VkCompute;
 #endif // NCNN_VULKAN
 class DataReader;
 class Extractor;
+
+// memory footprint of one inference pass
+class NCNN_EXPORT MemoryFootprint
+{
+public:
+    MemoryFootprint();
+
+    // peak bytes of live blobs, of workspace, and of both at the same time
+    size_t blob_bytes;
+    size_t workspace_bytes;
+    size_t peak_bytes;
+
+    // weight bytes read by load_model
+    size_t weight_bytes;
+
+    // indexed by layer
+    // peak of live blobs and workspace while the layer runs
+    std::vector<size_t> layer_blob_bytes;
+    std::vector<size_t> layer_workspace_bytes;
+    // weight bytes the layer read by load_model
+    std::vector<size_t> layer_weight_bytes;
+};
+
 class NetPrivate;
 class NCNN_EXPORT Net
 {
@@ -92,6 +115,13 @@ public:
     // return 0 if success
     int load_model(FILE* fp);
     int load_model(const char* modelpath);
+
+    // load network structure and weight data from ncnnpack container
+    // the file is mapped and weight data is referenced from the mapping
+    // the mapping is released in clear()
+    // the content hash in the header is verified first
+    // return 0 if success
+    int load_pack(const char* packpath);
 #endif // NCNN_STDIO
 
     // load network structure from external memory
@@ -106,6 +136,14 @@ public:
     // return bytes consumed
     int load_model(const unsigned char* mem);
 
+    // load network structure and reference weight data
+    // from ncnnpack container in external memory
+    // the content hash in the header is verified first
+    // external memory should be retained when used
+    // memory pointer must be 64-byte aligned for aligned weight section
+    // return bytes consumed, 0 if failed
+    size_t load_pack(const unsigned char* mem);
+
 #if NCNN_PLATFORM_API
 #if __ANDROID_API__ >= 9
 #if NCNN_STRING
@@ -129,6 +167,14 @@ public:
     // construct an Extractor from network
     Extractor create_extractor() const;
 
+    // measure the memory footprint of one cpu inference pass
+    // all output blobs are extracted from zero filled inputs with bookkeeping allocators
+    // the inputs stay alive for the whole pass as they do in the caller of extract
+    // input_shapes follow input_indexes(), only the shape of each mat is used
+    // opt is used for the pass, its allocators are replaced
+    // return 0 if success
+    int estimate_memory_footprint(const std::vector<Mat>& input_shapes, const Option& opt, MemoryFootprint& footprint) const;
+
     // get input/output indexes/names
     const std::vector<int>& input_indexes() const;
     const std::vector<int>& output_indexes() const;
@@ -143,6 +189,12 @@ public:
     std::vector<Blob>& mutable_blobs();
     std::vector<Layer*>& mutable_layers();
 
+    // bytes of blobs repacked or cast between adjacent layers
+    // that disagree on elempack or storage type
+    // accumulated by all extractors, safe to call concurrently
+    size_t convert_layout_bytes() const;
+    void reset_convert_layout_bytes();
+
 protected:
     friend class Extractor;
 #if NCNN_STRING
@@ -72,6 +72,9 @@ Option::Option()
     use_winograd23_convolution = true;
     use_winograd43_convolution = true;
     use_winograd63_convolution = true;
+
+    weight_cache = 0;
+    algorithm_cache = 0;
 }
 
 } // namespace ncnn
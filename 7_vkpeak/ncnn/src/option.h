@@ -25,6 +25,8 @@ class PipelineCache;
 #endif // NCNN_VULKAN
 
 class Allocator;
+class AlgorithmCache;
+class WeightCache;
 class NCNN_EXPORT Option
 {
 public:
@@ -146,6 +148,17 @@ public:
     bool use_reserved_9;
     bool use_reserved_10;
     bool use_reserved_11;
+
+    // weight cache shared by nets
+    // identical weights and packed weights are kept once across nets
+    // changes should be applied before loading network structure and weight
+    // appended last to keep the offsets of the fields above
+    WeightCache* weight_cache;
+
+    // per layer kernel choices timed on this machine
+    // layers with input shape hints time their candidate kernels once and reuse the choice
+    // changes should be applied before loading network structure and weight
+    AlgorithmCache* algorithm_cache;
 };
 
 } // namespace ncnn
@@ -243,6 +243,31 @@ static float vstr_to_float(const char vstr[16])
     return sign ? (float)v : (float)-v;
 }
 
+static int vstr_to_int(const char vstr[16], int* v)
+{
+    const char* p = vstr;
+
+    // sign
+    bool sign = *p != '-';
+    if (*p == '+' || *p == '-')
+    {
+        p++;
+    }
+
+    if (!isdigit(*p))
+        return 0;
+
+    unsigned int v1 = 0;
+    while (isdigit(*p))
+    {
+        v1 = v1 * 10 + (*p - '0');
+        p++;
+    }
+
+    *v = sign ? (int)v1 : (int)(0u - v1);
+    return 1;
+}
+
 int ParamDict::load_param(const DataReader& dr)
 {
     clear();
@@ -297,7 +322,7 @@ int ParamDict::load_param(const DataReader& dr)
                 else
                 {
                     int* ptr = d->params[id].v;
-                    nscan = sscanf(vstr, "%d", &ptr[j]);
+                    nscan = vstr_to_int(vstr, &ptr[j]);
                     if (nscan != 1)
                     {
                         NCNN_LOGE("ParamDict parse array element failed");
@@ -326,7 +351,7 @@ int ParamDict::load_param(const DataReader& dr)
             }
             else
             {
-                nscan = sscanf(vstr, "%d", &d->params[id].i);
+                nscan = vstr_to_int(vstr, &d->params[id].i);
                 if (nscan != 1)
                 {
                     NCNN_LOGE("ParamDict parse value failed");
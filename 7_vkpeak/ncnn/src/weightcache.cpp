@@ -0,0 +1,246 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "weightcache.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace ncnn {
+
+class WeightCachePrivate
+{
+public:
+    struct weight_cache_entry
+    {
+        uint64_t hash;
+        Mat m;
+    };
+
+    // entries chained in buckets indexed by the low bits of their content hash
+    std::vector<weight_cache_entry>& bucket(uint64_t hash)
+    {
+        return buckets[hash & (buckets.size() - 1)];
+    }
+
+    void rehash(size_t bucket_count);
+
+    mutable Mutex lock;
+    std::vector<std::vector<weight_cache_entry> > buckets;
+    size_t entry_count;
+    size_t cached_bytes;
+    size_t shared_bytes;
+};
+
+void WeightCachePrivate::rehash(size_t bucket_count)
+{
+    std::vector<std::vector<weight_cache_entry> > old_buckets = buckets;
+
+    buckets.clear();
+    buckets.resize(bucket_count);
+
+    for (size_t i = 0; i < old_buckets.size(); i++)
+    {
+        const std::vector<weight_cache_entry>& old_bucket = old_buckets[i];
+        for (size_t j = 0; j < old_bucket.size(); j++)
+        {
+            bucket(old_bucket[j].hash).push_back(old_bucket[j]);
+        }
+    }
+}
+
+static uint64_t hash_bytes(const unsigned char* p, size_t size, uint64_t hash)
+{
+    // fnv-1a over 64-bit words, then the tail bytes
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        hash ^= v;
+        hash *= 0x100000001b3ULL;
+    }
+    for (; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+static uint64_t hash_mat(const Mat& m)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    const int shape[7] = {m.dims, m.w, m.h, m.d, m.c, (int)m.elemsize, m.elempack};
+    hash = hash_bytes((const unsigned char*)shape, sizeof(shape), hash);
+
+    // skip the uninitialized gap between channels
+    const size_t channel_bytes = (size_t)m.w * m.h * m.d * m.elemsize;
+    for (int q = 0; q < m.c; q++)
+    {
+        hash = hash_bytes((const unsigned char*)m.channel(q).data, channel_bytes, hash);
+    }
+
+    return hash;
+}
+
+static bool mat_equal(const Mat& a, const Mat& b)
+{
+    if (a.dims != b.dims || a.w != b.w || a.h != b.h || a.d != b.d || a.c != b.c || a.elemsize != b.elemsize || a.elempack != b.elempack)
+        return false;
+
+    const size_t channel_bytes = (size_t)a.w * a.h * a.d * a.elemsize;
+    for (int q = 0; q < a.c; q++)
+    {
+        if (memcmp(a.channel(q).data, b.channel(q).data, channel_bytes) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+static size_t mat_bytes(const Mat& m)
+{
+    return m.cstep * m.c * m.elemsize;
+}
+
+WeightCache::WeightCache()
+    : d(new WeightCachePrivate)
+{
+    d->buckets.resize(64);
+    d->entry_count = 0;
+    d->cached_bytes = 0;
+    d->shared_bytes = 0;
+}
+
+WeightCache::~WeightCache()
+{
+    clear();
+
+    delete d;
+}
+
+WeightCache::WeightCache(const WeightCache&)
+    : d(0)
+{
+}
+
+WeightCache& WeightCache::operator=(const WeightCache&)
+{
+    return *this;
+}
+
+void WeightCache::clear()
+{
+    MutexLockGuard lock(d->lock);
+
+    d->buckets.clear();
+    d->buckets.resize(64);
+    d->entry_count = 0;
+    d->cached_bytes = 0;
+    d->shared_bytes = 0;
+}
+
+size_t WeightCache::trim()
+{
+    MutexLockGuard lock(d->lock);
+
+    size_t released_bytes = 0;
+    for (size_t i = 0; i < d->buckets.size(); i++)
+    {
+        std::vector<WeightCachePrivate::weight_cache_entry>& bucket = d->buckets[i];
+
+        size_t j = 0;
+        while (j < bucket.size())
+        {
+            // only the cache holds it, and share() cannot hand it out meanwhile with the lock held
+            if (NCNN_XADD(bucket[j].m.refcount, 0) != 1)
+            {
+                j++;
+                continue;
+            }
+
+            released_bytes += mat_bytes(bucket[j].m);
+
+            bucket[j] = bucket[bucket.size() - 1];
+            bucket.resize(bucket.size() - 1);
+            d->entry_count--;
+        }
+    }
+
+    d->cached_bytes -= released_bytes;
+
+    return released_bytes;
+}
+
+Mat WeightCache::share(const Mat& m)
+{
+    // external memory may go away with its owner
+    if (m.empty() || !m.refcount)
+        return m;
+
+    const uint64_t hash = hash_mat(m);
+
+    MutexLockGuard lock(d->lock);
+
+    const std::vector<WeightCachePrivate::weight_cache_entry>& bucket = d->bucket(hash);
+    for (size_t i = 0; i < bucket.size(); i++)
+    {
+        const WeightCachePrivate::weight_cache_entry& entry = bucket[i];
+        if (entry.hash != hash)
+            continue;
+
+        if (entry.m.data == m.data)
+            return m;
+
+        if (!mat_equal(entry.m, m))
+            continue;
+
+        d->shared_bytes += mat_bytes(m);
+        return entry.m;
+    }
+
+    // keep the chains short
+    if (d->entry_count >= d->buckets.size())
+    {
+        d->rehash(d->buckets.size() * 2);
+    }
+
+    WeightCachePrivate::weight_cache_entry entry;
+    entry.hash = hash;
+    entry.m = m;
+    d->bucket(hash).push_back(entry);
+    d->entry_count++;
+    d->cached_bytes += mat_bytes(m);
+
+    return m;
+}
+
+size_t WeightCache::cached_bytes() const
+{
+    MutexLockGuard lock(d->lock);
+
+    return d->cached_bytes;
+}
+
+size_t WeightCache::shared_bytes() const
+{
+    MutexLockGuard lock(d->lock);
+
+    return d->shared_bytes;
+}
+
+} // namespace ncnn
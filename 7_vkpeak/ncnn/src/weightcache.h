@@ -0,0 +1,64 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef NCNN_WEIGHTCACHE_H
+#define NCNN_WEIGHTCACHE_H
+
+#include "mat.h"
+#include "platform.h"
+
+namespace ncnn {
+
+// weight cache shared by several nets
+// set the same cache in opt.weight_cache of every net before loading
+// weights with identical shape and content are deduplicated by content hash
+// so that fine-tuned variants of one backbone keep a single copy of it
+class WeightCachePrivate;
+class NCNN_EXPORT WeightCache
+{
+public:
+    WeightCache();
+    virtual ~WeightCache();
+
+    // drop all cached weights, nets keep their own references
+    void clear();
+
+    // drop the cached weights that no net references any more,
+    // call it after clearing or destroying a net that shared the cache
+    // return the bytes released
+    // thread-safe
+    size_t trim();
+
+    // return the cached mat identical to m, or insert m and return it
+    // mats referencing external memory are returned as is
+    // thread-safe
+    Mat share(const Mat& m);
+
+    // bytes referenced by the cache
+    size_t cached_bytes() const;
+
+    // bytes saved by returning cached mats
+    size_t shared_bytes() const;
+
+private:
+    WeightCache(const WeightCache&);
+    WeightCache& operator=(const WeightCache&);
+
+private:
+    WeightCachePrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_WEIGHTCACHE_H
@@ -0,0 +1,228 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "algorithmcache.h"
+#include "datareader.h"
+#include "net.h"
+#include "testutil.h"
+
+class DataReaderFromBuffer : public ncnn::DataReader
+{
+public:
+    DataReaderFromBuffer(const std::vector<unsigned char>& _buffer)
+        : buffer(_buffer), offset(0)
+    {
+    }
+
+    virtual int scan(const char* /*format*/, void* /*p*/) const
+    {
+        return 0;
+    }
+
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (offset + size > buffer.size())
+            return 0;
+
+        memcpy(buf, buffer.data() + offset, size);
+        offset += size;
+        return size;
+    }
+
+private:
+    const std::vector<unsigned char>& buffer;
+    mutable size_t offset;
+};
+
+// the input shape hint lets the 3x3 s1 convolution time its kernels at load
+static const char test_param[] = "7767517\n"
+                                 "2 2\n"
+                                 "Input        data   0 1 data -23330=4,3,20,18,16 0=20 1=18 2=16\n"
+                                 "Convolution  conv   1 1 data conv -23330=4,3,20,18,16 0=16 1=3 4=1 5=1 6=2304\n";
+
+static std::vector<unsigned char> test_weights()
+{
+    std::vector<unsigned char> buffer(4, 0);
+    for (int i = 0; i < 2304 + 16; i++)
+    {
+        const float v = sinf(i * 0.37f) * 0.5f;
+
+        unsigned char bytes[4];
+        memcpy(bytes, &v, 4);
+        buffer.insert(buffer.end(), bytes, bytes + 4);
+    }
+
+    return buffer;
+}
+
+static int test_forward(const ncnn::Option& opt, ncnn::Mat& out)
+{
+    ncnn::Net net;
+    net.opt = opt;
+    if (net.load_param_mem(test_param) != 0)
+        return -1;
+
+    const std::vector<unsigned char> weights = test_weights();
+    if (net.load_model(DataReaderFromBuffer(weights)) != 0)
+        return -1;
+
+    ncnn::Mat in = RandomMat(20, 18, 16);
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", in);
+    return ex.extract("conv", out);
+}
+
+static int test_algorithmcache_0()
+{
+    const char* path = "test_algorithmcache_0.txt";
+
+    ncnn::AlgorithmCache cache;
+    cache.insert("Convolution_x86 a", 2);
+    cache.insert("Convolution_x86 b", 5);
+    cache.insert("Convolution_x86 a", 3);
+    if (cache.save(path) != 0)
+    {
+        fprintf(stderr, "save %s failed\n", path);
+        return -1;
+    }
+
+    // load merges into the choices already there
+    ncnn::AlgorithmCache cache2;
+    cache2.insert("Convolution_x86 c", 1);
+    if (cache2.load(path) != 0)
+    {
+        fprintf(stderr, "load %s failed\n", path);
+        return -1;
+    }
+
+    if (cache2.find("Convolution_x86 a") != 3 || cache2.find("Convolution_x86 b") != 5 || cache2.find("Convolution_x86 c") != 1 || cache2.find("Convolution_x86 d") != -1)
+    {
+        fprintf(stderr, "round trip mismatch %d %d %d %d\n", cache2.find("Convolution_x86 a"), cache2.find("Convolution_x86 b"), cache2.find("Convolution_x86 c"), cache2.find("Convolution_x86 d"));
+        return -1;
+    }
+
+    remove(path);
+
+    return 0;
+}
+
+static int test_algorithmcache_1(bool use_packing_layout)
+{
+    const char* path = "test_algorithmcache_1.txt";
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+    opt.use_packing_layout = use_packing_layout;
+
+    SRAND(7767517);
+    ncnn::Mat out;
+    if (test_forward(opt, out) != 0)
+    {
+        fprintf(stderr, "default forward failed\n");
+        return -1;
+    }
+
+    // time the kernels once to learn the layer signature
+    std::string entry;
+    {
+        ncnn::AlgorithmCache cache;
+        opt.algorithm_cache = &cache;
+
+        ncnn::Mat out_timed;
+        SRAND(7767517);
+        if (test_forward(opt, out_timed) != 0 || CompareMat(out, out_timed, 0.001) != 0)
+        {
+            fprintf(stderr, "timed forward mismatch\n");
+            return -1;
+        }
+
+        cache.save(path);
+
+        FILE* fp = fopen(path, "rb");
+        if (!fp)
+        {
+            fprintf(stderr, "fopen %s failed\n", path);
+            return -1;
+        }
+
+        char line[1024];
+        int line_count = 0;
+        while (fgets(line, 1024, fp))
+        {
+            entry = line;
+            line_count++;
+        }
+        fclose(fp);
+
+        if (line_count != 1)
+        {
+            fprintf(stderr, "expect one timed layer, got %d\n", line_count);
+            return -1;
+        }
+    }
+
+    // force each kernel family through a loaded file
+    const std::string entry_prefix = entry.substr(0, entry.rfind('\t') + 1);
+    const std::string signature = entry.substr(entry.find('\t') + 1, entry.rfind('\t') - entry.find('\t') - 1);
+    for (int algorithm = 1; algorithm <= 5; algorithm++)
+    {
+        FILE* fp = fopen(path, "wb");
+        if (!fp)
+        {
+            fprintf(stderr, "fopen %s failed\n", path);
+            return -1;
+        }
+        fprintf(fp, "%s%d\n", entry_prefix.c_str(), algorithm);
+        fclose(fp);
+
+        ncnn::AlgorithmCache cache;
+        cache.load(path);
+        opt.algorithm_cache = &cache;
+
+        ncnn::Mat out_forced;
+        SRAND(7767517);
+        if (test_forward(opt, out_forced) != 0 || CompareMat(out, out_forced, 0.001) != 0)
+        {
+            fprintf(stderr, "algorithm %d mismatch use_packing_layout=%d\n", algorithm, use_packing_layout);
+            return -1;
+        }
+
+        // the layer found the choice instead of timing again
+        if (cache.find(signature.c_str()) != algorithm)
+        {
+            fprintf(stderr, "algorithm %d not picked up for %s\n", algorithm, signature.c_str());
+            return -1;
+        }
+    }
+
+    remove(path);
+
+    return 0;
+}
+
+int main()
+{
+    return 0
+           || test_algorithmcache_0()
+           || test_algorithmcache_1(false)
+           || test_algorithmcache_1(true);
+}
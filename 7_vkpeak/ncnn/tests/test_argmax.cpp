@@ -0,0 +1,165 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "layer/argmax.h"
+#include "testutil.h"
+
+// few distinct values so that many of them tie
+static ncnn::Mat RandomTiedMat(int w)
+{
+    ncnn::Mat m(w);
+    for (int i = 0; i < w; i++)
+    {
+        m[i] = (float)(RAND() % 7) - 3.f;
+    }
+    return m;
+}
+
+static int test_argmax(const ncnn::Mat& a, int out_max_val, int topk, int softmax)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, out_max_val);
+    pd.set(1, topk);
+    pd.set(2, softmax);
+
+    std::vector<ncnn::Mat> weights(0);
+
+    int ret = test_layer<ncnn::ArgMax>("ArgMax", pd, weights, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_argmax failed a.dims=%d a=(%d %d %d) out_max_val=%d topk=%d softmax=%d\n", a.dims, a.w, a.h, a.c, out_max_val, topk, softmax);
+    }
+
+    return ret;
+}
+
+// test_layer runs on one thread, large inputs are also split into one segment per thread
+static int test_argmax_threads(const ncnn::Mat& a, int out_max_val, int topk, int softmax, int num_threads)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, out_max_val);
+    pd.set(1, topk);
+    pd.set(2, softmax);
+
+    ncnn::Option opt;
+    opt.num_threads = num_threads;
+    opt.use_vulkan_compute = false;
+    opt.use_packing_layout = false;
+    opt.use_fp16_storage = false;
+    opt.use_bf16_storage = false;
+
+    ncnn::Layer* op_naive = new ncnn::ArgMax;
+    ncnn::Layer* op = ncnn::create_layer("ArgMax");
+
+    op_naive->load_param(pd);
+    op->load_param(pd);
+
+    op_naive->create_pipeline(opt);
+    op->create_pipeline(opt);
+
+    ncnn::Mat b;
+    ncnn::Mat c;
+    int ret = op_naive->forward(a, b, opt) || op->forward(a, c, opt);
+
+    op_naive->destroy_pipeline(opt);
+    op->destroy_pipeline(opt);
+
+    delete op_naive;
+    delete op;
+
+    if (ret == 0)
+    {
+        ret = CompareMat(b, c, 0.001);
+    }
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_argmax_threads failed a.dims=%d a=(%d %d %d) out_max_val=%d topk=%d softmax=%d num_threads=%d\n", a.dims, a.w, a.h, a.c, out_max_val, topk, softmax, num_threads);
+    }
+
+    return ret;
+}
+
+static int test_argmax_0()
+{
+    return 0
+           || test_argmax(RandomMat(1), 0, 1, 0)
+           || test_argmax(RandomMat(5), 1, 1, 0)
+           || test_argmax(RandomMat(23), 0, 1, 0)
+           || test_argmax(RandomMat(23), 1, 1, 0)
+           || test_argmax(RandomMat(128), 1, 1, 0)
+           || test_argmax(RandomMat(11, 13), 0, 1, 0)
+           || test_argmax(RandomMat(11, 13), 1, 1, 0);
+}
+
+static int test_argmax_1()
+{
+    // topk > 1 and topk > size
+    return 0
+           || test_argmax(RandomMat(23), 0, 5, 0)
+           || test_argmax(RandomMat(23), 1, 5, 0)
+           || test_argmax(RandomMat(131), 1, 16, 0)
+           || test_argmax(RandomMat(11, 13), 1, 7, 0)
+           || test_argmax(RandomMat(5), 0, 10, 0)
+           || test_argmax(RandomMat(5), 1, 10, 0)
+           || test_argmax(RandomMat(5), 1, 10, 1);
+}
+
+static int test_argmax_2()
+{
+    // softmax
+    return 0
+           || test_argmax(RandomMat(1), 1, 1, 1)
+           || test_argmax(RandomMat(23), 1, 1, 1)
+           || test_argmax(RandomMat(23), 1, 5, 1)
+           || test_argmax(RandomMat(131, -10.f, 10.f), 1, 3, 1)
+           || test_argmax(RandomMat(11, 13), 1, 7, 1);
+}
+
+static int test_argmax_3()
+{
+    // ties rank the larger index first
+    return 0
+           || test_argmax(RandomTiedMat(23), 0, 1, 0)
+           || test_argmax(RandomTiedMat(23), 1, 5, 0)
+           || test_argmax(RandomTiedMat(131), 1, 16, 0)
+           || test_argmax(RandomTiedMat(131), 1, 9, 1)
+           || test_argmax(RandomTiedMat(40000), 1, 13, 0);
+}
+
+static int test_argmax_4()
+{
+    // inputs above 16k merge the per thread segments
+    return 0
+           || test_argmax(RandomMat(40000), 1, 5, 1)
+           || test_argmax_threads(RandomMat(40000), 0, 1, 0, 4)
+           || test_argmax_threads(RandomMat(40000), 1, 5, 0, 4)
+           || test_argmax_threads(RandomMat(40000, -10.f, 10.f), 1, 5, 1, 4)
+           || test_argmax_threads(RandomMat(70001), 1, 33, 1, 3)
+           || test_argmax_threads(RandomTiedMat(70001), 1, 21, 0, 4)
+           || test_argmax_threads(RandomTiedMat(70001), 1, 21, 1, 2)
+           || test_argmax_threads(RandomMat(16385), 1, 3, 1, 8);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_argmax_0()
+           || test_argmax_1()
+           || test_argmax_2()
+           || test_argmax_3()
+           || test_argmax_4();
+}
@@ -0,0 +1,119 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "datareader.h"
+#include "layer.h"
+#include "net.h"
+
+class DataReaderFromEmpty : public ncnn::DataReader
+{
+public:
+    virtual int scan(const char* /*format*/, void* /*p*/) const
+    {
+        return 0;
+    }
+    virtual size_t read(void* buf, size_t size) const
+    {
+        memset(buf, 0, size);
+        return size;
+    }
+};
+
+// takes unpacked fp32 blobs only, so packed neighbours convert around it
+class Unpacked : public ncnn::Layer
+{
+public:
+    Unpacked()
+    {
+        one_blob_only = true;
+        support_inplace = true;
+    }
+
+    virtual int forward_inplace(ncnn::Mat& /*bottom_top_blob*/, const ncnn::Option& /*opt*/) const
+    {
+        return 0;
+    }
+};
+
+DEFINE_LAYER_CREATOR(Unpacked)
+
+static const char test_param[] = "7767517\n"
+                                 "4 4\n"
+                                 "Input        data   0 1 data 0=8 1=8 2=16\n"
+                                 "Convolution  conv0  1 1 data c0 0=16 1=1 6=256\n"
+                                 "Unpacked     probe  1 1 c0 u0\n"
+                                 "Convolution  conv1  1 1 u0 c1 0=16 1=1 6=256\n";
+
+static int test_convert_layout_bytes_0()
+{
+    ncnn::Net net;
+    net.opt.num_threads = 1;
+    net.opt.use_vulkan_compute = false;
+    net.opt.use_packing_layout = true;
+    net.opt.use_fp16_storage = false;
+    net.opt.use_bf16_storage = false;
+
+    net.register_custom_layer("Unpacked", Unpacked_layer_creator);
+    net.load_param_mem(test_param);
+    net.load_model(DataReaderFromEmpty());
+
+    ncnn::Mat in(8, 8, 16);
+    in.fill(1.f);
+
+    if (net.convert_layout_bytes() != 0)
+    {
+        fprintf(stderr, "convert_layout_bytes %zu before extract\n", net.convert_layout_bytes());
+        return -1;
+    }
+
+    ncnn::Mat c0;
+    ncnn::Mat c1;
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", in);
+        ex.extract("c0", c0, 1);
+        ex.extract("c1", c1);
+    }
+
+    if (c0.elempack == 1)
+    {
+        // no packed layout on this build, nothing to convert
+        return 0;
+    }
+
+    // the packed conv0 output is unpacked for the probe layer
+    const size_t unpack_bytes = 8 * 8 * 16 * sizeof(float);
+    if (net.convert_layout_bytes() < unpack_bytes)
+    {
+        fprintf(stderr, "convert_layout_bytes %zu after extract, expect at least %zu\n", net.convert_layout_bytes(), unpack_bytes);
+        return -1;
+    }
+
+    net.reset_convert_layout_bytes();
+    if (net.convert_layout_bytes() != 0)
+    {
+        fprintf(stderr, "convert_layout_bytes %zu after reset\n", net.convert_layout_bytes());
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    return test_convert_layout_bytes_0();
+}
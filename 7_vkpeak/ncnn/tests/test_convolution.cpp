@@ -159,7 +159,9 @@ static int test_convolution_0()
            || test_convolution(12, 18, 32, 160, 3, 1, 1, 1, 1)
            || test_convolution(12, 18, 4, 12, 3, 1, 1, 1, 1)
            || test_convolution(42, 18, 28, 140, 3, 1, 1, 1, 1)
-           || test_convolution(12, 18, 28, 140, 3, 1, 1, 1, 1);
+           || test_convolution(12, 18, 28, 140, 3, 1, 1, 1, 1)
+           || test_convolution(64, 60, 16, 16, 5, 1, 1, 2, 1)
+           || test_convolution(66, 62, 16, 16, 5, 1, 2, 0, 0);
 }
 
 static int test_convolution_vec(int w, int outch, int kernel, int dilation, int stride, int pad, int bias)
@@ -288,9 +290,10 @@ static int test_convolution_3()
 }
 
 #if NCNN_INT8
-static int test_convolution_int8(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias, bool requant = false)
+static int test_convolution_int8(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias, bool requant = false, bool asymmetric = false)
 {
-    ncnn::Mat a = RandomMat(w, h, c);
+    // asymmetric input behaves like post relu activation
+    ncnn::Mat a = asymmetric ? RandomMat(w, h, c, 0.f, 2.4f) : RandomMat(w, h, c);
 
     ncnn::ParamDict pd;
     pd.set(0, outch);
@@ -301,6 +304,7 @@ static int test_convolution_int8(int w, int h, int c, int outch, int kernel, int
     pd.set(5, bias);
     pd.set(6, outch * c * kernel * kernel);
     pd.set(8, requant ? 101 : 1); // int8_scale_term
+    pd.set(20, asymmetric ? -127 : 0); // bottom_blob_int8_zero_point
 
     int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
     ncnn::Mat activation_params(2);
@@ -315,6 +319,11 @@ static int test_convolution_int8(int w, int h, int c, int outch, int kernel, int
     ncnn::Mat weight_scales = scales_mat(weights[0], outch, c * kernel * kernel, c * kernel * kernel);
     ncnn::Mat input_scales = scales_mat(a, 1, w * h * c, a.cstep);
     ncnn::Mat top_scales = requant ? scales_mat(a, 1, w * h * c, a.cstep) : ncnn::Mat();
+    if (asymmetric)
+    {
+        // [0, max] maps to [-127, 127]
+        input_scales[0] *= 2;
+    }
     if (bias)
     {
         weights[1] = RandomMat(outch);
@@ -333,7 +342,7 @@ static int test_convolution_int8(int w, int h, int c, int outch, int kernel, int
     int ret = test_layer<ncnn::Convolution>("Convolution", pd, weights, a, requant ? 1.0f : 0.001f, 0, flag);
     if (ret != 0)
     {
-        fprintf(stderr, "test_convolution_int8 failed w=%d h=%d c=%d outch=%d kernel=%d dilation=%d stride=%d pad=%d bias=%d requant=%d act=%d actparams=[%f,%f]\n", w, h, c, outch, kernel, dilation, stride, pad, bias, requant, activation_type, activation_params[0], activation_params[1]);
+        fprintf(stderr, "test_convolution_int8 failed w=%d h=%d c=%d outch=%d kernel=%d dilation=%d stride=%d pad=%d bias=%d requant=%d asymmetric=%d act=%d actparams=[%f,%f]\n", w, h, c, outch, kernel, dilation, stride, pad, bias, requant, asymmetric, activation_type, activation_params[0], activation_params[1]);
     }
 
     return ret;
@@ -414,7 +423,25 @@ static int test_convolution_1()
            || test_convolution_int8(4, 20, 16, 24, 3, 1, 1, 1, 0)
            || test_convolution_int8(6, 7, 64, 64, 3, 1, 2, 0, 1)
            || test_convolution_int8(25, 33, 16, 15, 3, 1, 1, 1, 0)
-           || test_convolution_int8(7, 7, 15, 12, 3, 1, 1, 1, 0);
+           || test_convolution_int8(7, 7, 15, 12, 3, 1, 1, 1, 0)
+           || test_convolution_int8(15, 13, 17, 18, 3, 1, 1, 1, 1)
+           || test_convolution_int8(64, 60, 16, 16, 5, 1, 1, 2, 1)
+           || test_convolution_int8(66, 62, 16, 16, 5, 1, 2, 0, 0);
+}
+
+static int test_convolution_4()
+{
+    return 0
+           || test_convolution_int8(9, 7, 1, 1, 1, 1, 1, 0, 1, false, true)
+           || test_convolution_int8(9, 7, 4, 4, 3, 1, 1, 1, 0, false, true)
+           || test_convolution_int8(9, 7, 8, 8, 3, 1, 2, 1, 1, false, true)
+           || test_convolution_int8(9, 7, 16, 15, 1, 1, 1, 0, 1, false, true)
+           || test_convolution_int8(11, 11, 8, 16, 3, 1, 1, 1, 1, false, true)
+           || test_convolution_int8(13, 16, 16, 24, 3, 1, 1, 1, 0, false, true)
+           || test_convolution_int8(9, 7, 15, 16, 5, 2, 1, -233, 1, false, true)
+           || test_convolution_int8(9, 7, 8, 8, 3, 1, 1, 1, 1, true, true)
+           || test_convolution_int8(9, 7, 16, 16, 3, 1, 2, 1, 0, true, true)
+           || test_convolution_int8(15, 13, 17, 18, 3, 1, 1, 1, 0, false, true);
 }
 #endif // NCNN_INT8
 
@@ -427,7 +454,8 @@ int main()
            || test_convolution_0()
            || test_convolution_1()
            || test_convolution_2()
-           || test_convolution_3();
+           || test_convolution_3()
+           || test_convolution_4();
 #else
     return 0
            || test_convolution_0()
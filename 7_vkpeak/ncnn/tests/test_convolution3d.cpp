@@ -87,9 +87,19 @@ static int test_convolution3d_0()
     return 0;
 }
 
+static int test_convolution3d_1()
+{
+    // several depth slabs, the later ones start mid plane
+    return 0
+           || test_convolution3d(37, 39, 14, 12, 5, 3, 1, 1, 0, 1)
+           || test_convolution3d(37, 39, 14, 12, 8, 3, 1, 1, 0, 0);
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_convolution3d_0();
+    return 0
+           || test_convolution3d_0()
+           || test_convolution3d_1();
 }
@@ -205,9 +205,62 @@ static int test_convolutiondepthwise1d_1()
     return 0;
 }
 
+static int test_convolutiondepthwise1d_streaming(int w, int h, int outh, int kernel, int dilation, int stride, int pad, int group)
+{
+    ncnn::Mat a = RandomMat(w, h);
+
+    ncnn::ParamDict pd;
+    pd.set(0, outh);     // num_output
+    pd.set(1, kernel);   // kernel_w
+    pd.set(2, dilation); // dilation_w
+    pd.set(3, stride);   // stride_w
+    pd.set(4, pad);      // pad_left
+    pd.set(15, 0);       // pad_right
+    pd.set(5, 1);        // bias_term
+    pd.set(6, outh / group * h / group * kernel * group);
+    pd.set(7, group);
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    ncnn::ParamDict pd_streaming = pd;
+    pd_streaming.set(20, 1); // streaming
+
+    std::vector<ncnn::Mat> weights(2);
+    weights[0] = RandomMat(outh / group * h / group * kernel * group);
+    weights[1] = RandomMat(outh);
+
+    // the last output waits for the next window to start when stride exceeds the kernel extent
+    const int kernel_extent = dilation * (kernel - 1) + 1;
+    const int outw = std::min((w + pad - kernel_extent) / stride + 1, (w + pad) / stride);
+
+    int ret = test_layer_streaming("ConvolutionDepthWise1D", pd, pd_streaming, weights, a, outw);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_convolutiondepthwise1d_streaming failed w=%d h=%d outh=%d kernel=%d dilation=%d stride=%d pad=%d group=%d act=%d actparams=[%f,%f]\n", w, h, outh, kernel, dilation, stride, pad, group, activation_type, activation_params[0], activation_params[1]);
+    }
+
+    return ret;
+}
+
+static int test_convolutiondepthwise1d_2()
+{
+    return 0
+           || test_convolutiondepthwise1d_streaming(19, 1, 1, 3, 1, 1, 2, 1)
+           || test_convolutiondepthwise1d_streaming(19, 8, 8, 3, 2, 1, 4, 8)
+           || test_convolutiondepthwise1d_streaming(23, 16, 16, 5, 1, 2, 4, 16)
+           || test_convolutiondepthwise1d_streaming(23, 12, 12, 2, 1, 3, 1, 4)
+           || test_convolutiondepthwise1d_streaming(24, 4, 8, 1, 1, 4, 0, 2)
+           || test_convolutiondepthwise1d_streaming(25, 8, 8, 2, 1, 5, 0, 8);
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_convolutiondepthwise1d_0() || test_convolutiondepthwise1d_1();
+    return test_convolutiondepthwise1d_0() || test_convolutiondepthwise1d_1() || test_convolutiondepthwise1d_2();
 }
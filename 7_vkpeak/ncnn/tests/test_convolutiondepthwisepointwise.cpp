@@ -0,0 +1,129 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "layer/convolutiondepthwisepointwise.h"
+#include "testutil.h"
+
+static int test_convolutiondepthwisepointwise(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias)
+{
+    ncnn::Mat a = RandomMat(w, h, c);
+
+    ncnn::ParamDict pd;
+    pd.set(0, c);
+    pd.set(1, kernel);
+    pd.set(2, dilation);
+    pd.set(3, stride);
+    pd.set(4, pad);
+    pd.set(5, bias);
+    pd.set(6, c * kernel * kernel);
+    pd.set(20, outch);
+    pd.set(25, bias);
+    pd.set(26, c * outch);
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    int pointwise_activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat pointwise_activation_params(2);
+    pointwise_activation_params[0] = (pointwise_activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    pointwise_activation_params[1] = RandomFloat(0, 1);                                                         // beta
+    pd.set(29, pointwise_activation_type);
+    pd.set(30, pointwise_activation_params);
+
+    std::vector<ncnn::Mat> weights(bias ? 4 : 2);
+    if (bias)
+    {
+        weights[0] = RandomMat(c * kernel * kernel);
+        weights[1] = RandomMat(c);
+        weights[2] = RandomMat(c * outch);
+        weights[3] = RandomMat(outch);
+    }
+    else
+    {
+        weights[0] = RandomMat(c * kernel * kernel);
+        weights[1] = RandomMat(c * outch);
+    }
+
+    int ret = test_layer<ncnn::ConvolutionDepthWisePointWise>("ConvolutionDepthWisePointWise", pd, weights, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_convolutiondepthwisepointwise failed w=%d h=%d c=%d outch=%d kernel=%d dilation=%d stride=%d pad=%d bias=%d act=%d actparams=[%f,%f] pwact=%d pwactparams=[%f,%f]\n", w, h, c, outch, kernel, dilation, stride, pad, bias, activation_type, activation_params[0], activation_params[1], pointwise_activation_type, pointwise_activation_params[0], pointwise_activation_params[1]);
+    }
+
+    return ret;
+}
+
+static int test_convolutiondepthwisepointwise_0()
+{
+    static const int kdsp[10][4] = {
+        {1, 1, 1, 0},
+        {2, 1, 2, -233},
+        {3, 1, 1, 1},
+        {3, 1, 2, 1},
+        {3, 2, 1, 2},
+        {3, 1, 2, -234},
+        {5, 1, 1, 2},
+        {5, 1, 2, 2},
+        {5, 1, 2, -233},
+        {7, 1, 1, 3},
+    };
+
+    for (int i = 0; i < 10; i++)
+    {
+        const int k = kdsp[i][0];
+        const int d = kdsp[i][1];
+        const int s = kdsp[i][2];
+        const int p = kdsp[i][3];
+
+        int ret = 0
+                  || test_convolutiondepthwisepointwise(15, 7, 1, 1, k, d, s, p, 1)
+                  || test_convolutiondepthwisepointwise(15, 7, 3, 5, k, d, s, p, 0)
+                  || test_convolutiondepthwisepointwise(15, 7, 4, 8, k, d, s, p, 1)
+                  || test_convolutiondepthwisepointwise(15, 7, 8, 4, k, d, s, p, 0)
+                  || test_convolutiondepthwisepointwise(15, 7, 16, 24, k, d, s, p, 1)
+                  || test_convolutiondepthwisepointwise(18, 17, 4, 3, k, d, s, p, 1)
+                  || test_convolutiondepthwisepointwise(18, 17, 12, 16, k, d, s, p, 0)
+                  || test_convolutiondepthwisepointwise(18, 17, 16, 16, k, d, s, p, 1)
+                  || test_convolutiondepthwisepointwise(25, 33, 8, 12, k, d, s, p, 1)
+                  || test_convolutiondepthwisepointwise(25, 33, 32, 16, k, d, s, p, 0);
+
+        if (ret != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int test_convolutiondepthwisepointwise_1()
+{
+    // several fused bands
+    return 0
+           || test_convolutiondepthwisepointwise(64, 64, 64, 64, 3, 1, 1, 1, 1)
+           || test_convolutiondepthwisepointwise(64, 63, 96, 24, 3, 1, 2, 1, 1)
+           || test_convolutiondepthwisepointwise(57, 61, 48, 32, 5, 1, 1, 2, 0)
+           || test_convolutiondepthwisepointwise(63, 64, 32, 40, 5, 1, 2, -233, 1);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_convolutiondepthwisepointwise_0()
+           || test_convolutiondepthwisepointwise_1();
+}
@@ -124,9 +124,19 @@ static int test_deformableconv2d_0()
            || test_deformableconv2d(7, 5, 32, 26, 4, 2, 2, 2, 1);
 }
 
+static int test_deformableconv2d_1()
+{
+    // several row bands, the later ones start mid row
+    return 0
+           || test_deformableconv2d(165, 202, 12, 5, 3, 1, 1, 0, 1)
+           || test_deformableconv2d(165, 202, 12, 8, 3, 1, 1, 0, 0);
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_deformableconv2d_0();
+    return 0
+           || test_deformableconv2d_0()
+           || test_deformableconv2d_1();
 }
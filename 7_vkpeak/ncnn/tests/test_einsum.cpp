@@ -161,6 +161,21 @@ static int test_einsum_11()
     return test_einsum(a, "imnj,kmln->ijkl");
 }
 
+static int test_einsum_12()
+{
+    std::vector<ncnn::Mat> a(2);
+    a[0] = RandomMat(16, 24, 4);
+    a[1] = RandomMat(16, 21, 4);
+
+    std::vector<ncnn::Mat> b(2);
+    b[0] = RandomMat(12, 10, 3);
+    b[1] = RandomMat(19, 12);
+
+    return 0
+           || test_einsum(a, "ijl,ikl->ijk")
+           || test_einsum(b, "ijl,lk->ijk");
+}
+
 int main()
 {
     SRAND(7767517);
@@ -177,5 +192,6 @@ int main()
            || test_einsum_8()
            || test_einsum_9()
            || test_einsum_10()
-           || test_einsum_11();
+           || test_einsum_11()
+           || test_einsum_12();
 }
@@ -119,6 +119,56 @@ static int test_gridsample_3()
            || test_gridsample(RandomMat(16, 12, 10, 5), RandomMat(3, 16, 12, 10), 2, 3, 1);
 }
 
+static int test_gridsample_4()
+{
+    return 0
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 1, 1, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 1, 1, 1)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 1, 2, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 1, 2, 1)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 1, 3, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 1, 3, 1)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 2, 1, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 2, 1, 1)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 2, 2, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 2, 2, 1)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 2, 3, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 2, 3, 1)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 3, 1, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 3, 1, 1)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 3, 2, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 3, 2, 1)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 3, 3, 0)
+           || test_gridsample(RandomMat(13, 11, 16), RandomMat(2, 17, 13), 3, 3, 1)
+           || test_gridsample(RandomMat(9, 7, 8), RandomMat(2, 27, 24), 1, 1, 0)
+           || test_gridsample(RandomMat(9, 7, 12), RandomMat(2, 27, 24), 1, 3, 1)
+           || test_gridsample(RandomMat(9, 7, 8), RandomMat(2, 27, 24), 2, 1, 0)
+           || test_gridsample(RandomMat(9, 7, 12), RandomMat(2, 27, 24), 2, 3, 1)
+           || test_gridsample(RandomMat(9, 7, 8), RandomMat(2, 27, 24), 3, 1, 0)
+           || test_gridsample(RandomMat(9, 7, 12), RandomMat(2, 27, 24), 3, 3, 1);
+}
+
+static int test_gridsample_5()
+{
+    return 0
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 1, 1, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 1, 1, 1)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 1, 2, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 1, 2, 1)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 1, 3, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 1, 3, 1)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 2, 1, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 2, 1, 1)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 2, 2, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 2, 2, 1)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 2, 3, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 16), RandomMat(3, 13, 12, 8), 2, 3, 1)
+           || test_gridsample(RandomMat(11, 9, 7, 8), RandomMat(3, 13, 12, 8), 1, 2, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 4), RandomMat(3, 13, 12, 8), 1, 3, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 8), RandomMat(3, 13, 12, 8), 2, 2, 0)
+           || test_gridsample(RandomMat(11, 9, 7, 4), RandomMat(3, 13, 12, 8), 2, 3, 0);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -127,5 +177,7 @@ int main()
            || test_gridsample_0()
            || test_gridsample_1()
            || test_gridsample_2()
-           || test_gridsample_3();
+           || test_gridsample_3()
+           || test_gridsample_4()
+           || test_gridsample_5();
 }
@@ -81,6 +81,15 @@ static int test_groupnorm_3()
            || test_groupnorm(RandomMat(324), 3, 0.0001f);
 }
 
+static int test_groupnorm_4()
+{
+    return 0
+           || test_groupnorm(RandomMat(13, 11, 32), 8, 0.001f)
+           || test_groupnorm(RandomMat(24, 23, 64), 4, 0.0001f)
+           || test_groupnorm(RandomMat(9, 7, 48), 12, 0.01f)
+           || test_groupnorm(RandomMat(40, 40, 16), 16, 0.001f);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -89,5 +98,6 @@ int main()
            || test_groupnorm_0()
            || test_groupnorm_1()
            || test_groupnorm_2()
-           || test_groupnorm_3();
+           || test_groupnorm_3()
+           || test_groupnorm_4();
 }
@@ -48,10 +48,22 @@ static int test_instancenorm_0()
            || test_instancenorm(RandomMat(5, 7, 16), 0.02f, 1);
 }
 
+static int test_instancenorm_1()
+{
+    return 0
+           || test_instancenorm(RandomMat(13, 11, 32), 0.001f, 0)
+           || test_instancenorm(RandomMat(48, 40, 8), 0.0001f, 0)
+           || test_instancenorm(RandomMat(7, 9, 24), 0.01f, 0)
+           || test_instancenorm(RandomMat(13, 11, 32), 0.001f, 1)
+           || test_instancenorm(RandomMat(48, 40, 8), 0.0001f, 1)
+           || test_instancenorm(RandomMat(7, 9, 24), 0.01f, 1);
+}
+
 int main()
 {
     SRAND(7767517);
 
     return 0
-           || test_instancenorm_0();
+           || test_instancenorm_0()
+           || test_instancenorm_1();
 }
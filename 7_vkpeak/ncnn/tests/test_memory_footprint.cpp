@@ -0,0 +1,152 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+
+#include "datareader.h"
+#include "net.h"
+
+class DataReaderFromEmpty : public ncnn::DataReader
+{
+public:
+    virtual int scan(const char* /*format*/, void* /*p*/) const
+    {
+        return 0;
+    }
+    virtual size_t read(void* buf, size_t size) const
+    {
+        memset(buf, 0, size);
+        return size;
+    }
+};
+
+class HighWaterAllocator : public ncnn::Allocator
+{
+public:
+    HighWaterAllocator()
+        : current(0), peak(0)
+    {
+    }
+
+    virtual void* fastMalloc(size_t size)
+    {
+        void* ptr = ncnn::fastMalloc(size);
+        bookkeeper[ptr] = size;
+        current += size;
+        peak = std::max(peak, current);
+        return ptr;
+    }
+
+    virtual void fastFree(void* ptr)
+    {
+        current -= bookkeeper[ptr];
+        bookkeeper.erase(ptr);
+        ncnn::fastFree(ptr);
+    }
+
+public:
+    size_t current;
+    size_t peak;
+    std::map<void*, size_t> bookkeeper;
+};
+
+static const char test_param[] = "7767517\n"
+                                 "5 5\n"
+                                 "Input        data   0 1 data 0=16 1=16 2=3\n"
+                                 "Convolution  conv1  1 1 data conv1 0=16 1=3 4=1 5=1 6=432\n"
+                                 "ReLU         relu1  1 1 conv1 relu1\n"
+                                 "Pooling      pool1  1 1 relu1 pool1 0=0 1=2 2=2\n"
+                                 "InnerProduct fc     1 1 pool1 fc 0=10 1=1 2=10240\n";
+
+static int test_memory_footprint_0()
+{
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_local_pool_allocator = false;
+
+    ncnn::Net net;
+    net.opt = opt;
+    net.load_param_mem(test_param);
+
+    DataReaderFromEmpty dr;
+    net.load_model(dr);
+
+    std::vector<ncnn::Mat> input_shapes(1);
+    input_shapes[0] = ncnn::Mat(16, 16, 3, (void*)0);
+
+    ncnn::MemoryFootprint footprint;
+    int ret = net.estimate_memory_footprint(input_shapes, opt, footprint);
+    if (ret != 0)
+    {
+        fprintf(stderr, "estimate_memory_footprint failed\n");
+        return -1;
+    }
+
+    const size_t conv_weight_bytes = (432 + 16) * sizeof(float);
+    const size_t fc_weight_bytes = (10240 + 10) * sizeof(float);
+    if (footprint.layer_weight_bytes.size() != 5 || footprint.layer_weight_bytes[1] != conv_weight_bytes || footprint.layer_weight_bytes[4] != fc_weight_bytes || footprint.weight_bytes != conv_weight_bytes + fc_weight_bytes)
+    {
+        fprintf(stderr, "weight bytes mismatch %zu\n", footprint.weight_bytes);
+        return -1;
+    }
+
+    // run the same pass through an extractor and compare the high-water marks
+    HighWaterAllocator blob_allocator;
+    HighWaterAllocator workspace_allocator;
+    {
+        ncnn::Mat in(16, 16, 3, 4u, &blob_allocator);
+        in.fill(0.f);
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_num_threads(1);
+        ex.set_blob_allocator(&blob_allocator);
+        ex.set_workspace_allocator(&workspace_allocator);
+        ex.input("data", in);
+
+        ncnn::Mat out;
+        ex.extract("fc", out, 1);
+    }
+
+    if (footprint.blob_bytes != blob_allocator.peak || footprint.workspace_bytes != workspace_allocator.peak)
+    {
+        fprintf(stderr, "footprint mismatch blob %zu vs %zu  workspace %zu vs %zu\n", footprint.blob_bytes, blob_allocator.peak, footprint.workspace_bytes, workspace_allocator.peak);
+        return -1;
+    }
+
+    if (footprint.peak_bytes < footprint.blob_bytes || footprint.peak_bytes < footprint.workspace_bytes || footprint.peak_bytes > footprint.blob_bytes + footprint.workspace_bytes)
+    {
+        fprintf(stderr, "peak bytes out of range %zu\n", footprint.peak_bytes);
+        return -1;
+    }
+
+    for (int i = 1; i < 5; i++)
+    {
+        if (footprint.layer_blob_bytes[i] == 0 || footprint.layer_blob_bytes[i] > footprint.blob_bytes)
+        {
+            fprintf(stderr, "layer %d blob bytes out of range %zu\n", i, footprint.layer_blob_bytes[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    return test_memory_footprint_0();
+}
@@ -0,0 +1,224 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "net.h"
+
+// driven by run_ncnnpack_test.cmake
+//   test_ncnnpack write <dir>     writes ncnnpack.param and ncnnpack.bin
+//   ncnn2mem packs them into ncnnpack.ncnnpack
+//   test_ncnnpack compare <dir>   loads both forms and compares the outputs
+
+static const char test_param[] = "7767517\n"
+                                 "6 6\n"
+                                 "Input        data   0 1 data 0=16 1=16 2=3\n"
+                                 "Convolution  conv1  1 1 data conv1 0=16 1=3 4=1 5=1 6=432 9=1\n"
+                                 "ConvolutionDepthWise dw 1 1 conv1 dw 0=16 1=3 4=1 5=1 6=144 7=16\n"
+                                 "Convolution  conv2  1 1 dw conv2 0=8 1=1 5=1 6=128\n"
+                                 "Pooling      pool1  1 1 conv2 pool1 0=1 1=2 2=2\n"
+                                 "InnerProduct fc     1 1 pool1 fc 0=10 1=1 2=5120\n";
+
+// float32 weights with the type tag, then the raw bias, in load order
+static void write_weight(FILE* fp, int size, bool tagged, int seed)
+{
+    if (tagged)
+    {
+        const unsigned int tag = 0;
+        fwrite(&tag, sizeof(tag), 1, fp);
+    }
+
+    for (int i = 0; i < size; i++)
+    {
+        const float v = sinf(i * 0.37f + seed) * 0.5f;
+        fwrite(&v, sizeof(v), 1, fp);
+    }
+}
+
+static int write_model(const std::string& dir)
+{
+    FILE* pp = fopen((dir + "/ncnnpack.param").c_str(), "wb");
+    if (!pp)
+    {
+        fprintf(stderr, "fopen ncnnpack.param failed\n");
+        return -1;
+    }
+
+    fwrite(test_param, 1, strlen(test_param), pp);
+    fclose(pp);
+
+    FILE* bp = fopen((dir + "/ncnnpack.bin").c_str(), "wb");
+    if (!bp)
+    {
+        fprintf(stderr, "fopen ncnnpack.bin failed\n");
+        return -1;
+    }
+
+    write_weight(bp, 432, true, 1);
+    write_weight(bp, 16, false, 2);
+    write_weight(bp, 144, true, 3);
+    write_weight(bp, 16, false, 4);
+    write_weight(bp, 128, true, 5);
+    write_weight(bp, 8, false, 6);
+    write_weight(bp, 5120, true, 7);
+    write_weight(bp, 10, false, 8);
+    fclose(bp);
+
+    return 0;
+}
+
+static ncnn::Mat forward(const ncnn::Net& net)
+{
+    ncnn::Mat in(16, 16, 3);
+    for (int q = 0; q < 3; q++)
+    {
+        float* ptr = in.channel(q);
+        for (int i = 0; i < 16 * 16; i++)
+        {
+            ptr[i] = cosf(i * 0.11f + q);
+        }
+    }
+
+    // the binary param in the pack carries no blob names
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input(net.input_indexes()[0], in);
+
+    ncnn::Mat out;
+    ex.extract(net.output_indexes()[0], out);
+
+    return out;
+}
+
+static bool same_output(const ncnn::Mat& a, const ncnn::Mat& b)
+{
+    return a.w == 10 && b.w == 10 && memcmp(a.data, b.data, 10 * sizeof(float)) == 0;
+}
+
+static int compare_model(const std::string& dir)
+{
+    const std::string packpath = dir + "/ncnnpack.ncnnpack";
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+
+    ncnn::Net net;
+    net.opt = opt;
+    if (net.load_param((dir + "/ncnnpack.param").c_str()) != 0 || net.load_model((dir + "/ncnnpack.bin").c_str()) != 0)
+    {
+        fprintf(stderr, "load param and model failed\n");
+        return -1;
+    }
+
+    const ncnn::Mat out = forward(net);
+
+    // mapped file
+    {
+        ncnn::Net net_pack;
+        net_pack.opt = opt;
+        if (net_pack.load_pack(packpath.c_str()) != 0)
+        {
+            fprintf(stderr, "load_pack %s failed\n", packpath.c_str());
+            return -1;
+        }
+
+        if (!same_output(out, forward(net_pack)))
+        {
+            fprintf(stderr, "load_pack file output mismatch\n");
+            return -1;
+        }
+    }
+
+    // external memory
+    FILE* fp = fopen(packpath.c_str(), "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", packpath.c_str());
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    const size_t pack_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    unsigned char* pack_data = (unsigned char*)ncnn::fastMalloc(pack_size);
+    const size_t nread = fread(pack_data, 1, pack_size, fp);
+    fclose(fp);
+
+    int ret = 0;
+    if (nread != pack_size)
+    {
+        fprintf(stderr, "fread %s failed\n", packpath.c_str());
+        ret = -1;
+    }
+
+    if (ret == 0)
+    {
+        ncnn::Net net_pack;
+        net_pack.opt = opt;
+        const size_t consumed = net_pack.load_pack(pack_data);
+        if (consumed != pack_size)
+        {
+            fprintf(stderr, "load_pack consumed %zu bytes, expect %zu\n", consumed, pack_size);
+            ret = -1;
+        }
+        else if (!same_output(out, forward(net_pack)))
+        {
+            fprintf(stderr, "load_pack memory output mismatch\n");
+            ret = -1;
+        }
+    }
+
+    // a corrupted weight byte fails the hash check
+    if (ret == 0)
+    {
+        pack_data[pack_size - 1] ^= 1;
+
+        ncnn::Net net_pack;
+        net_pack.opt = opt;
+        if (net_pack.load_pack(pack_data) != 0)
+        {
+            fprintf(stderr, "load_pack accepted a corrupted pack\n");
+            ret = -1;
+        }
+    }
+
+    ncnn::fastFree(pack_data);
+
+    return ret;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s [write|compare] [dir]\n", argv[0]);
+        return -1;
+    }
+
+    const std::string dir = argv[2];
+
+    if (strcmp(argv[1], "write") == 0)
+        return write_model(dir);
+
+    if (strcmp(argv[1], "compare") == 0)
+        return compare_model(dir);
+
+    fprintf(stderr, "unknown mode %s\n", argv[1]);
+    return -1;
+}
@@ -431,6 +431,43 @@ static int test_padding_7()
            || test_padding_int8(c, 0, 0, 10, 6, 0, 0, 2, 0.f, 0);
 }
 
+static int test_padding_streaming(int w, int h, int top, int bottom, int left, float value)
+{
+    ncnn::Mat a = RandomMat(w, h);
+
+    ncnn::ParamDict pd;
+    pd.set(0, top);
+    pd.set(1, bottom);
+    pd.set(2, left);
+    pd.set(3, 0);
+    pd.set(4, 0);
+    pd.set(5, value);
+
+    ncnn::ParamDict pd_streaming = pd;
+    pd_streaming.set(20, 1); // streaming
+
+    std::vector<ncnn::Mat> weights(0);
+
+    int ret = test_layer_streaming("Padding", pd, pd_streaming, weights, a, left + w);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_padding_streaming failed w=%d h=%d top=%d bottom=%d left=%d value=%f\n", w, h, top, bottom, left, value);
+    }
+
+    return ret;
+}
+
+static int test_padding_8()
+{
+    return 0
+           || test_padding_streaming(13, 1, 0, 0, 2, 0.f)
+           || test_padding_streaming(13, 4, 0, 0, 3, -1.f)
+           || test_padding_streaming(17, 8, 0, 0, 0, 0.f)
+           || test_padding_streaming(17, 16, 0, 0, 5, 2.f)
+           || test_padding_streaming(15, 3, 1, 2, 2, 0.f)
+           || test_padding_streaming(15, 8, 4, 4, 1, -2.f);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -442,5 +479,6 @@ int main()
            || test_padding_4()
            || test_padding_5()
            || test_padding_6()
-           || test_padding_7();
+           || test_padding_7()
+           || test_padding_8();
 }
@@ -0,0 +1,191 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "datareader.h"
+#include "layer.h"
+#include "net.h"
+#include "paramdict.h"
+
+// keeps the param dict of the last loaded layer
+static ncnn::ParamDict g_pd;
+
+class ParamProbe : public ncnn::Layer
+{
+public:
+    ParamProbe()
+    {
+        one_blob_only = true;
+        support_inplace = true;
+    }
+
+    virtual int load_param(const ncnn::ParamDict& pd)
+    {
+        g_pd = pd;
+        return 0;
+    }
+
+    virtual int forward_inplace(ncnn::Mat& /*bottom_top_blob*/, const ncnn::Option& /*opt*/) const
+    {
+        return 0;
+    }
+};
+
+DEFINE_LAYER_CREATOR(ParamProbe)
+
+static int load_probe(const char* param)
+{
+    ncnn::Net net;
+    net.register_custom_layer("ParamProbe", ParamProbe_layer_creator);
+    return net.load_param_mem(param);
+}
+
+static int expect_int(int id, int expect)
+{
+    if (g_pd.type(id) != 2 || g_pd.get(id, 0) != expect)
+    {
+        fprintf(stderr, "param %d type %d value %d, expect %d\n", id, g_pd.type(id), g_pd.get(id, 0), expect);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int expect_float(int id, float expect)
+{
+    if (g_pd.type(id) != 3 || fabsf(g_pd.get(id, 0.f) - expect) > fabsf(expect) * 1e-6f)
+    {
+        fprintf(stderr, "param %d type %d value %f, expect %f\n", id, g_pd.type(id), g_pd.get(id, 0.f), expect);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_paramdict_0()
+{
+    // scalar ints and floats, with uneven whitespace between pairs
+    static const char param[] = "7767517\n"
+                                "2 2\n"
+                                "Input      data  0 1 data 0=4\n"
+                                "ParamProbe probe 1 1 data out 0=0 1=-1 2=-2147483648  3=2147483647\t4=+7 5=-0 6=1.5 7=-2.5e-3 8=3e2\n";
+
+    if (load_probe(param) != 0)
+    {
+        fprintf(stderr, "load_param_mem failed\n");
+        return -1;
+    }
+
+    return 0
+           || expect_int(0, 0)
+           || expect_int(1, -1)
+           || expect_int(2, INT_MIN)
+           || expect_int(3, INT_MAX)
+           || expect_int(4, 7)
+           || expect_int(5, 0)
+           || expect_float(6, 1.5f)
+           || expect_float(7, -2.5e-3f)
+           || expect_float(8, 300.f);
+}
+
+static int test_paramdict_1()
+{
+    // int and float arrays
+    static const char param[] = "7767517\n"
+                                "2 2\n"
+                                "Input      data  0 1 data 0=4\n"
+                                "ParamProbe probe 1 1 data out -23300=6,-3,0,-2147483648,2147483647,12,-1 -23301=3,0.5,-1.0,2e2 2=5\n";
+
+    if (load_probe(param) != 0)
+    {
+        fprintf(stderr, "load_param_mem failed\n");
+        return -1;
+    }
+
+    static const int expect_ints[6] = {-3, 0, INT_MIN, INT_MAX, 12, -1};
+    ncnn::Mat v0 = g_pd.get(0, ncnn::Mat());
+    if (g_pd.type(0) != 5 || v0.w != 6 || memcmp(v0.data, expect_ints, sizeof(expect_ints)) != 0)
+    {
+        fprintf(stderr, "int array type %d size %d mismatch\n", g_pd.type(0), v0.w);
+        return -1;
+    }
+
+    static const float expect_floats[3] = {0.5f, -1.f, 200.f};
+    ncnn::Mat v1 = g_pd.get(1, ncnn::Mat());
+    if (g_pd.type(1) != 6 || v1.w != 3 || memcmp(v1.data, expect_floats, sizeof(expect_floats)) != 0)
+    {
+        fprintf(stderr, "float array type %d size %d mismatch\n", g_pd.type(1), v1.w);
+        return -1;
+    }
+
+    return expect_int(2, 5);
+}
+
+static int test_paramdict_2()
+{
+    // a failed scan consumes nothing, the next scan sees the same token
+    static const char text[] = "  12=  abc\n\t-23300=2,-5,6";
+
+    const unsigned char* mem = (const unsigned char*)text;
+    ncnn::DataReaderFromMemory dr(mem);
+
+    int id = 0;
+    int len = 0;
+    int v = 0;
+    char vstr[16];
+    if (dr.scan("%d=", &id) != 1 || id != 12)
+    {
+        fprintf(stderr, "scan id failed\n");
+        return -1;
+    }
+    if (dr.scan("%d=", &id) != 0)
+    {
+        fprintf(stderr, "scan id on a value token succeeded\n");
+        return -1;
+    }
+    if (dr.scan("%15s", vstr) != 1 || strcmp(vstr, "abc") != 0)
+    {
+        fprintf(stderr, "scan value failed\n");
+        return -1;
+    }
+    if (dr.scan("%d=", &id) != 1 || id != -23300 || dr.scan("%d", &len) != 1 || len != 2)
+    {
+        fprintf(stderr, "scan array header failed\n");
+        return -1;
+    }
+    if (dr.scan(",%15[^,\n ]", vstr) != 1 || strcmp(vstr, "-5") != 0 || dr.scan(",%d", &v) != 1 || v != 6)
+    {
+        fprintf(stderr, "scan array elements failed\n");
+        return -1;
+    }
+    if (dr.scan("%d=", &id) != 0)
+    {
+        fprintf(stderr, "scan past the end succeeded\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    return 0
+           || test_paramdict_0()
+           || test_paramdict_1()
+           || test_paramdict_2();
+}
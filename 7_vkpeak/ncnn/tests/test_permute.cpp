@@ -115,6 +115,27 @@ static int test_permute_3()
     return 0;
 }
 
+static int test_permute_4()
+{
+    // exercise the transpose tiles and their tails
+    ncnn::Mat a = RandomMat(67, 72);
+    ncnn::Mat b = RandomMat(70, 35, 24);
+    ncnn::Mat c = RandomMat(19, 13, 11, 16);
+
+    for (int order_type = 0; order_type < 24; order_type++)
+    {
+        int ret = 0
+                  || (order_type < 2 && test_permute(a, order_type))
+                  || (order_type < 6 && test_permute(b, order_type))
+                  || test_permute(c, order_type);
+
+        if (ret != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
 int main()
 {
     SRAND(7767517);
@@ -123,5 +144,6 @@ int main()
            || test_permute_0()
            || test_permute_1()
            || test_permute_2()
-           || test_permute_3();
+           || test_permute_3()
+           || test_permute_4();
 }
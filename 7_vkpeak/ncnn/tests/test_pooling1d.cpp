@@ -248,6 +248,49 @@ static int test_pooling1d_4()
            || test_pooling1d(13, 16, 0, 1, 1, 0, 0, 0, 1, 0, 12);
 }
 
+static int test_pooling1d_streaming(int w, int h, int pooling_type, int kernel, int stride, int pad)
+{
+    ncnn::Mat a = RandomMat(w, h);
+
+    // streaming average pooling counts the initial pad frames
+    ncnn::ParamDict pd;
+    pd.set(0, pooling_type); // pooling_type
+    pd.set(1, kernel);       // kernel_w
+    pd.set(2, stride);       // stride_w
+    pd.set(3, pad);          // pad_left
+    pd.set(14, 0);           // pad_right
+    pd.set(5, 1);            // pad_mode
+    pd.set(6, 1);            // avgpool_count_include_pad
+
+    ncnn::ParamDict pd_streaming = pd;
+    pd_streaming.set(20, 1); // streaming
+
+    std::vector<ncnn::Mat> weights(0);
+
+    // the last output waits for the next window to start when stride exceeds the kernel extent
+    const int outw = std::min((w + pad - kernel) / stride + 1, (w + pad) / stride);
+
+    int ret = test_layer_streaming("Pooling1D", pd, pd_streaming, weights, a, outw);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_pooling1d_streaming failed w=%d h=%d pooling_type=%d kernel=%d stride=%d pad=%d\n", w, h, pooling_type, kernel, stride, pad);
+    }
+
+    return ret;
+}
+
+static int test_pooling1d_5()
+{
+    return 0
+           || test_pooling1d_streaming(19, 1, 0, 3, 1, 2)
+           || test_pooling1d_streaming(19, 4, 1, 3, 1, 2)
+           || test_pooling1d_streaming(23, 8, 0, 4, 2, 1)
+           || test_pooling1d_streaming(23, 8, 1, 4, 2, 3)
+           || test_pooling1d_streaming(24, 12, 0, 2, 3, 0)
+           || test_pooling1d_streaming(25, 16, 1, 2, 5, 1)
+           || test_pooling1d_streaming(17, 3, 0, 1, 4, 0);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -257,5 +300,6 @@ int main()
            || test_pooling1d_1()
            || test_pooling1d_2()
            || test_pooling1d_3()
-           || test_pooling1d_4();
+           || test_pooling1d_4()
+           || test_pooling1d_5();
 }
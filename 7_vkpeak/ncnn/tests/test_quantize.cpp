@@ -15,7 +15,7 @@
 #include "layer/quantize.h"
 #include "testutil.h"
 
-static int test_quantize(const ncnn::Mat& a, float scale_low, float scale_high)
+static int test_quantize(const ncnn::Mat& a, float scale_low, float scale_high, int zero_point = 0)
 {
     ncnn::Mat scale_data;
     if (scale_low == scale_high)
@@ -33,6 +33,7 @@ static int test_quantize(const ncnn::Mat& a, float scale_low, float scale_high)
 
     ncnn::ParamDict pd;
     pd.set(0, scale_data.w);
+    pd.set(1, zero_point);
 
     std::vector<ncnn::Mat> weights(1);
     weights[0] = scale_data;
@@ -40,7 +41,7 @@ static int test_quantize(const ncnn::Mat& a, float scale_low, float scale_high)
     int ret = test_layer<ncnn::Quantize>("Quantize", pd, weights, a);
     if (ret != 0)
     {
-        fprintf(stderr, "test_quantize failed a.dims=%d a=(%d %d %d) scale_low=%f scale_high=%f\n", a.dims, a.w, a.h, a.c, scale_low, scale_high);
+        fprintf(stderr, "test_quantize failed a.dims=%d a=(%d %d %d) scale_low=%f scale_high=%f zero_point=%d\n", a.dims, a.w, a.h, a.c, scale_low, scale_high, zero_point);
     }
 
     return ret;
@@ -79,6 +80,16 @@ static int test_quantize_2()
            || test_quantize(RandomMat(127), 120.f, 140.f);
 }
 
+static int test_quantize_3()
+{
+    return 0
+           || test_quantize(RandomMat(5, 7, 24, 0.f, 2.4f), 100.f, 100.f, -127)
+           || test_quantize(RandomMat(3, 5, 13, 0.f, 2.4f), 100.f, 100.f, -127)
+           || test_quantize(RandomMat(17, 12, 0.f, 2.4f), 100.f, 100.f, -127)
+           || test_quantize(RandomMat(128, 0.f, 2.4f), 100.f, 100.f, -127)
+           || test_quantize(RandomMat(127), 50.f, 50.f, 13);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -86,5 +97,6 @@ int main()
     return 0
            || test_quantize_0()
            || test_quantize_1()
-           || test_quantize_2();
+           || test_quantize_2()
+           || test_quantize_3();
 }
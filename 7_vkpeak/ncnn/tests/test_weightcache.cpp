@@ -0,0 +1,183 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "datareader.h"
+#include "layer/convolution.h"
+#include "net.h"
+#include "weightcache.h"
+
+// copies the weights out instead of referencing the buffer,
+// so that every net owns its weights and the cache can share them
+class DataReaderFromBuffer : public ncnn::DataReader
+{
+public:
+    DataReaderFromBuffer(const std::vector<unsigned char>& _buffer)
+        : buffer(_buffer), offset(0)
+    {
+    }
+
+    virtual int scan(const char* /*format*/, void* /*p*/) const
+    {
+        return 0;
+    }
+
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (offset + size > buffer.size())
+            return 0;
+
+        memcpy(buf, buffer.data() + offset, size);
+        offset += size;
+        return size;
+    }
+
+private:
+    const std::vector<unsigned char>& buffer;
+    mutable size_t offset;
+};
+
+static const char test_param[] = "7767517\n"
+                                 "6 6\n"
+                                 "Input        data   0 1 data 0=16 1=16 2=3\n"
+                                 "Convolution  conv1  1 1 data conv1 0=16 1=3 4=1 5=1 6=432\n"
+                                 "ReLU         relu1  1 1 conv1 relu1\n"
+                                 "Convolution  conv2  1 1 relu1 conv2 0=16 1=1 5=1 6=256\n"
+                                 "Pooling      pool1  1 1 conv2 pool1 0=0 1=2 2=2\n"
+                                 "InnerProduct fc     1 1 pool1 fc 0=10 1=1 2=10240\n";
+
+// float32 weights with the type tag, then the raw bias, in load order
+static void append_weight(std::vector<unsigned char>& buffer, int size, bool tagged)
+{
+    if (tagged)
+    {
+        buffer.resize(buffer.size() + 4, 0);
+    }
+
+    for (int i = 0; i < size; i++)
+    {
+        const float v = sinf(i * 0.37f + buffer.size()) * 0.5f;
+
+        unsigned char bytes[4];
+        memcpy(bytes, &v, 4);
+        buffer.insert(buffer.end(), bytes, bytes + 4);
+    }
+}
+
+static int test_weightcache_0()
+{
+    std::vector<unsigned char> weights;
+    append_weight(weights, 432, true);
+    append_weight(weights, 16, false);
+    append_weight(weights, 256, true);
+    append_weight(weights, 16, false);
+    append_weight(weights, 1024 * 10, true);
+    append_weight(weights, 10, false);
+
+    ncnn::WeightCache weight_cache;
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.lightmode = false;
+    opt.use_vulkan_compute = false;
+    opt.weight_cache = &weight_cache;
+
+    ncnn::Net net0;
+    net0.opt = opt;
+    net0.load_param_mem(test_param);
+    net0.load_model(DataReaderFromBuffer(weights));
+
+    const size_t cached_bytes = weight_cache.cached_bytes();
+    if (cached_bytes == 0 || weight_cache.shared_bytes() != 0)
+    {
+        fprintf(stderr, "first net cached %zu shared %zu\n", cached_bytes, weight_cache.shared_bytes());
+        return -1;
+    }
+
+    ncnn::Net net1;
+    net1.opt = opt;
+    net1.load_param_mem(test_param);
+    net1.load_model(DataReaderFromBuffer(weights));
+
+    // the second net gets every weight and packed weight from the cache
+    if (weight_cache.cached_bytes() != cached_bytes || weight_cache.shared_bytes() != cached_bytes)
+    {
+        fprintf(stderr, "second net cached %zu shared %zu, expect %zu\n", weight_cache.cached_bytes(), weight_cache.shared_bytes(), cached_bytes);
+        return -1;
+    }
+
+    for (int i = 1; i < 4; i += 2)
+    {
+        const ncnn::Convolution* conv0 = (const ncnn::Convolution*)net0.layers()[i];
+        const ncnn::Convolution* conv1 = (const ncnn::Convolution*)net1.layers()[i];
+        if (conv0->weight_data.data != conv1->weight_data.data || conv0->bias_data.data != conv1->bias_data.data)
+        {
+            fprintf(stderr, "layer %d weights not shared\n", i);
+            return -1;
+        }
+    }
+
+    ncnn::Mat in(16, 16, 3);
+    for (int q = 0; q < 3; q++)
+    {
+        float* ptr = in.channel(q);
+        for (int i = 0; i < 16 * 16; i++)
+        {
+            ptr[i] = cosf(i * 0.11f + q);
+        }
+    }
+
+    ncnn::Mat out0;
+    ncnn::Mat out1;
+    {
+        ncnn::Extractor ex0 = net0.create_extractor();
+        ex0.input("data", in);
+        ex0.extract("fc", out0);
+
+        ncnn::Extractor ex1 = net1.create_extractor();
+        ex1.input("data", in);
+        ex1.extract("fc", out1);
+    }
+
+    if (out0.w != 10 || out1.w != 10 || memcmp(out0.data, out1.data, 10 * sizeof(float)) != 0)
+    {
+        fprintf(stderr, "outputs differ\n");
+        return -1;
+    }
+
+    // weights still used by the other net stay
+    net0.clear();
+    if (weight_cache.trim() != 0 || weight_cache.cached_bytes() != cached_bytes)
+    {
+        fprintf(stderr, "trim released weights in use, cached %zu\n", weight_cache.cached_bytes());
+        return -1;
+    }
+
+    net1.clear();
+    if (weight_cache.trim() != cached_bytes || weight_cache.cached_bytes() != 0)
+    {
+        fprintf(stderr, "trim kept unused weights, cached %zu\n", weight_cache.cached_bytes());
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    return test_weightcache_0();
+}
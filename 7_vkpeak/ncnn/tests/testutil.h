@@ -23,6 +23,9 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
 
 #if NCNN_VULKAN
 #include "command.h"
@@ -1487,4 +1490,193 @@ int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vec
     return 0;
 }
 
+// feed a sequence to a streaming layer in chunks along w, with the second top blob fed back
+// as the second bottom blob of the next chunk, and compare the concatenated outputs with the
+// first outw frames the offline layer produces over the whole sequence
+static int test_layer_streaming_chunks(const char* layer_type, const ncnn::ParamDict& pd, const ncnn::ParamDict& pd_streaming, const std::vector<ncnn::Mat>& weights, const ncnn::Mat& a, const std::vector<int>& chunks, int outw, int use_packing_layout)
+{
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+    opt.use_packing_layout = use_packing_layout;
+    opt.use_fp16_packed = false;
+    opt.use_fp16_storage = false;
+    opt.use_fp16_arithmetic = false;
+    opt.use_bf16_storage = false;
+
+    ncnn::Layer* op = ncnn::create_layer(layer_type);
+    ncnn::Layer* op_streaming = ncnn::create_layer(layer_type);
+
+    op->load_param(pd);
+    op_streaming->load_param(pd_streaming);
+
+    ncnn::ModelBinFromMatArray mb(weights.data());
+    op->load_model(mb);
+    ncnn::ModelBinFromMatArray mb_streaming(weights.data());
+    op_streaming->load_model(mb_streaming);
+
+    op->create_pipeline(opt);
+    op_streaming->create_pipeline(opt);
+
+    const int h = a.h;
+
+    // pack the channels as the net would
+    int elempack = 1;
+    if (use_packing_layout && op->support_packing && op_streaming->support_packing)
+    {
+#if NCNN_AVX512
+        if (h % 16 == 0 && ncnn::cpu_support_x86_avx512())
+            elempack = 16;
+        else if (h % 8 == 0 && ncnn::cpu_support_x86_avx())
+            elempack = 8;
+        else if (h % 4 == 0)
+            elempack = 4;
+#elif NCNN_AVX
+        if (h % 8 == 0 && ncnn::cpu_support_x86_avx())
+            elempack = 8;
+        else if (h % 4 == 0)
+            elempack = 4;
+#elif NCNN_RVV
+        const int packn = ncnn::cpu_riscv_vlenb() / 4;
+        if (h % packn == 0)
+            elempack = packn;
+#else
+        if (h % 4 == 0)
+            elempack = 4;
+#endif
+    }
+
+    int ret = 0;
+
+    // offline
+    ncnn::Mat b;
+    {
+        ncnn::Mat a4;
+        ncnn::convert_packing(a, a4, elempack, opt);
+
+        ncnn::Mat b4;
+        ret = op->forward(a4, b4, opt);
+        if (ret == 0)
+            ncnn::convert_packing(b4, b, 1, opt);
+    }
+
+    // streaming
+    std::vector<ncnn::Mat> outputs;
+    ncnn::Mat cache;
+    int w0 = 0;
+    for (size_t i = 0; i < chunks.size() && ret == 0; i++)
+    {
+        const int chunk_w = chunks[i];
+
+        ncnn::Mat chunk(chunk_w, h);
+        for (int y = 0; y < h; y++)
+        {
+            memcpy(chunk.row(y), a.row(y) + w0, chunk_w * sizeof(float));
+        }
+        w0 += chunk_w;
+
+        std::vector<ncnn::Mat> bottom_blobs(2);
+        ncnn::convert_packing(chunk, bottom_blobs[0], elempack, opt);
+        bottom_blobs[1] = cache;
+
+        std::vector<ncnn::Mat> top_blobs(2);
+        ret = op_streaming->forward(bottom_blobs, top_blobs, opt);
+        if (ret != 0)
+            break;
+
+        if (!top_blobs[0].empty())
+        {
+            ncnn::Mat out;
+            ncnn::convert_packing(top_blobs[0], out, 1, opt);
+            outputs.push_back(out);
+        }
+
+        cache = top_blobs[1];
+    }
+
+    op->destroy_pipeline(opt);
+    op_streaming->destroy_pipeline(opt);
+
+    delete op;
+    delete op_streaming;
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_layer_streaming %s forward failed\n", layer_type);
+        return ret;
+    }
+
+    int streamed_w = 0;
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        streamed_w += outputs[i].w;
+    }
+
+    if (streamed_w != outw || b.w < outw)
+    {
+        fprintf(stderr, "test_layer_streaming %s streamed %d frames, expect %d of %d\n", layer_type, streamed_w, outw, b.w);
+        return -1;
+    }
+
+    ncnn::Mat c(outw, b.h);
+    ncnn::Mat b_head(outw, b.h);
+    int x0 = 0;
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        const ncnn::Mat& out = outputs[i];
+        if (out.h != b.h)
+        {
+            fprintf(stderr, "test_layer_streaming %s output h %d, expect %d\n", layer_type, out.h, b.h);
+            return -1;
+        }
+
+        for (int y = 0; y < b.h; y++)
+        {
+            memcpy(c.row(y) + x0, out.row(y), out.w * sizeof(float));
+        }
+        x0 += out.w;
+    }
+    for (int y = 0; y < b.h; y++)
+    {
+        memcpy(b_head.row(y), b.row(y), outw * sizeof(float));
+    }
+
+    if (CompareMat(b_head, c, 0.001) != 0)
+    {
+        fprintf(stderr, "test_layer_streaming %s output mismatch\n", layer_type);
+        return -1;
+    }
+
+    return 0;
+}
+
+// one frame at a time, then uneven chunks
+static int test_layer_streaming(const char* layer_type, const ncnn::ParamDict& pd, const ncnn::ParamDict& pd_streaming, const std::vector<ncnn::Mat>& weights, const ncnn::Mat& a, int outw)
+{
+    static const int uneven[7] = {1, 4, 1, 2, 7, 1, 3};
+
+    std::vector<int> frames(a.w, 1);
+
+    std::vector<int> chunks;
+    for (int i = 0, w = a.w; w > 0; i++)
+    {
+        chunks.push_back(std::min(uneven[i % 7], w));
+        w -= chunks.back();
+    }
+
+    for (int use_packing_layout = 0; use_packing_layout < 2; use_packing_layout++)
+    {
+        int ret = 0
+                  || test_layer_streaming_chunks(layer_type, pd, pd_streaming, weights, a, frames, outw, use_packing_layout)
+                  || test_layer_streaming_chunks(layer_type, pd, pd_streaming, weights, a, chunks, outw, use_packing_layout);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_layer_streaming %s failed use_packing_layout=%d\n", layer_type, use_packing_layout);
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
 #endif // TESTUTIL_H
@@ -40,6 +40,7 @@
 #include "layer/convolutiondepthwise.h"
 #include "layer/convolutiondepthwise1d.h"
 #include "layer/convolutiondepthwise3d.h"
+#include "layer/convolutiondepthwisepointwise.h"
 #include "layer/crop.h"
 #include "layer/deconvolution.h"
 #include "layer/deconvolution1d.h"
@@ -497,6 +498,8 @@ int ModelWriter::estimate_memory_footprint()
         fprintf(stderr, "input = %s\n", blobs[layer->tops[0]].name.c_str());
     }
 
+    reset_convert_layout_bytes();
+
     // find output blobs and do inference
     std::vector<ncnn::Mat> outputs;
     for (size_t i = 0; i < blob_count; i++)
@@ -519,6 +522,9 @@ int ModelWriter::estimate_memory_footprint()
 
     fprintf(stderr, "estimated memory footprint = %.2f KB = %.2f MB\n", allocator.memory_footprint / 1024.f, allocator.memory_footprint / 1024.f / 1024.f);
 
+    const size_t convert_bytes = convert_layout_bytes();
+    fprintf(stderr, "measured layout conversion = %.2f KB = %.2f MB\n", convert_bytes / 1024.f, convert_bytes / 1024.f / 1024.f);
+
     return 0;
 }
 
@@ -879,6 +885,9 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             {
                 if (!op->activation_params.empty()) fprintf_param_float_array(10, op->activation_params, pp);
             }
+#if NCNN_INT8
+            fprintf_param_value(" 20=%d", bottom_blob_int8_zero_point)
+#endif // NCNN_INT8
 
             fwrite_weight_tag_data(op->weight_data, bp);
             fwrite_weight_data(op->bias_data, bp);
@@ -1160,6 +1169,64 @@ int ModelWriter::save(const char* parampath, const char* binpath)
                 mac += (uint64_t)op->kernel_d * op->kernel_h * op->kernel_w * outw * outh * outd * (outc / op->group) * (inc / op->group) * op->group;
             }
         }
+        else if (layer->type == "ConvolutionDepthWisePointWise")
+        {
+            ncnn::ConvolutionDepthWisePointWise* op = (ncnn::ConvolutionDepthWisePointWise*)layer;
+            ncnn::ConvolutionDepthWisePointWise* op_default = (ncnn::ConvolutionDepthWisePointWise*)layer_default;
+
+            fprintf_param_value(" 0=%d", num_output)
+            fprintf_param_value(" 1=%d", kernel_w)
+            {
+                if (op->kernel_h != op->kernel_w) fprintf(pp, " 11=%d", op->kernel_h);
+            }
+            fprintf_param_value(" 2=%d", dilation_w)
+            {
+                if (op->dilation_h != op->dilation_w) fprintf(pp, " 12=%d", op->dilation_h);
+            }
+            fprintf_param_value(" 3=%d", stride_w)
+            {
+                if (op->stride_h != op->stride_w) fprintf(pp, " 13=%d", op->stride_h);
+            }
+            fprintf_param_value(" 4=%d", pad_left)
+            {
+                if (op->pad_top != op->pad_left) fprintf(pp, " 14=%d", op->pad_top);
+            }
+            {
+                if (op->pad_right != op->pad_left) fprintf(pp, " 15=%d", op->pad_right);
+            }
+            {
+                if (op->pad_bottom != op->pad_top) fprintf(pp, " 16=%d", op->pad_bottom);
+            }
+            fprintf_param_value(" 18=%e", pad_value)
+            fprintf_param_value(" 5=%d", bias_term)
+            fprintf_param_value(" 6=%d", weight_data_size)
+            fprintf_param_value(" 9=%d", activation_type)
+            {
+                if (!op->activation_params.empty()) fprintf_param_float_array(10, op->activation_params, pp);
+            }
+            fprintf_param_value(" 20=%d", pointwise_num_output)
+            fprintf_param_value(" 25=%d", pointwise_bias_term)
+            fprintf_param_value(" 26=%d", pointwise_weight_data_size)
+            fprintf_param_value(" 29=%d", pointwise_activation_type)
+            {
+                if (!op->pointwise_activation_params.empty()) fprintf_param_float_array(30, op->pointwise_activation_params, pp);
+            }
+
+            fwrite_weight_tag_data(op->weight_data, bp);
+            fwrite_weight_data(op->bias_data, bp);
+            fwrite_weight_tag_data(op->pointwise_weight_data, bp);
+            fwrite_weight_data(op->pointwise_bias_data, bp);
+
+            if (shape_ready)
+            {
+                int outw = blobs[layer->tops[0]].shape.w;
+                int outh = blobs[layer->tops[0]].shape.h;
+                int outc = blobs[layer->tops[0]].shape.c;
+
+                mac += (uint64_t)op->kernel_h * op->kernel_w * outw * outh * op->num_output;
+                mac += (uint64_t)outw * outh * outc * op->num_output;
+            }
+        }
         else if (layer->type == "Crop")
         {
             ncnn::Crop* op = (ncnn::Crop*)layer;
@@ -2000,6 +2067,7 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             ncnn::Quantize* op_default = (ncnn::Quantize*)layer_default;
 
             fprintf_param_value(" 0=%d", scale_data_size)
+            fprintf_param_value(" 1=%d", zero_point)
 
             fwrite_weight_data(op->scale_data, bp);
         }
@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <ctype.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <string>
@@ -468,11 +469,113 @@ static int write_memcpp(const char* parambinpath, const char* modelpath, const c
     return 0;
 }
 
+static int read_file(const char* path, std::vector<unsigned char>& data)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", path);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    data.resize(size);
+    size_t nread = size > 0 ? fread(&data[0], 1, size, fp) : 0;
+    fclose(fp);
+
+    if (nread != (size_t)size)
+    {
+        fprintf(stderr, "fread %s failed\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+static uint64_t fnv1a_hash(const std::vector<unsigned char>& data, uint64_t hash)
+{
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+// ncnnpack layout, must match ncnnpack_header in net.cpp
+//   0  magic NCPK
+//   4  version
+//   8  param offset
+//  16  param size
+//  24  model offset, 64-byte aligned
+//  32  model size
+//  40  fnv-1a hash of param and model sections
+//  48  reserved
+//  64  binary param section
+//      zero padding
+//      model section
+static int write_pack(const char* parambinpath, const char* modelpath, const char* packpath)
+{
+    std::vector<unsigned char> param_data;
+    std::vector<unsigned char> model_data;
+    if (read_file(parambinpath, param_data) != 0 || read_file(modelpath, model_data) != 0)
+        return -1;
+
+    const uint64_t header_size = 64;
+    uint64_t param_offset = header_size;
+    uint64_t param_size = param_data.size();
+    uint64_t model_offset = (param_offset + param_size + 63) / 64 * 64;
+    uint64_t model_size = model_data.size();
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = fnv1a_hash(param_data, hash);
+    hash = fnv1a_hash(model_data, hash);
+
+    unsigned char header[64] = {0};
+    uint32_t magic = 0x4b50434e;
+    uint32_t version = 1;
+    memcpy(header + 0, &magic, 4);
+    memcpy(header + 4, &version, 4);
+    memcpy(header + 8, &param_offset, 8);
+    memcpy(header + 16, &param_size, 8);
+    memcpy(header + 24, &model_offset, 8);
+    memcpy(header + 32, &model_size, 8);
+    memcpy(header + 40, &hash, 8);
+
+    FILE* pp = fopen(packpath, "wb");
+    if (!pp)
+    {
+        fprintf(stderr, "fopen %s failed\n", packpath);
+        return -1;
+    }
+
+    fwrite(header, 1, header_size, pp);
+    if (param_size)
+        fwrite(&param_data[0], 1, param_size, pp);
+
+    std::vector<unsigned char> padding(model_offset - param_offset - param_size, 0);
+    if (!padding.empty())
+        fwrite(&padding[0], 1, padding.size(), pp);
+
+    if (model_size)
+        fwrite(&model_data[0], 1, model_size, pp);
+
+    fclose(pp);
+
+    fprintf(stderr, "ncnnpack hash %016llx\n", (unsigned long long)hash);
+
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
-    if (argc != 5)
+    if (argc != 5 && argc != 6)
     {
-        fprintf(stderr, "Usage: %s [ncnnproto] [ncnnbin] [idcpppath] [memcpppath]\n", argv[0]);
+        fprintf(stderr, "Usage: %s [ncnnproto] [ncnnbin] [idcpppath] [memcpppath] (packpath)\n", argv[0]);
         return -1;
     }
 
@@ -487,5 +590,13 @@ int main(int argc, char** argv)
 
     write_memcpp(parambinpath.c_str(), modelpath, memcpppath);
 
+    if (argc == 6)
+    {
+        const char* packpath = argv[5];
+
+        if (write_pack(parambinpath.c_str(), modelpath, packpath) != 0)
+            return -1;
+    }
+
     return 0;
 }
@@ -22,6 +22,7 @@
 #include <vector>
 
 // ncnn public header
+#include "cpu.h"
 #include "datareader.h"
 #include "layer.h"
 #include "layer_type.h"
@@ -69,8 +70,14 @@ public:
     int fuse_deconvolution_activation();
     int fuse_deconvolutiondepthwise_activation();
     int fuse_innerproduct_activation();
+    int fold_constant_subgraph();
     int fuse_memorydata_binaryop();
     int fuse_binaryop_eltwise();
+    int fuse_layernorm();
+    int fuse_gelu();
+    int fuse_padding_convolution();
+    int fuse_padding_convolutiondepthwise();
+    int fuse_convolutiondepthwise_convolution();
 
     int eliminate_dropout();
     int eliminate_pooling1x1();
@@ -86,6 +93,12 @@ public:
     int replace_prelu_with_leaky_relu();
     int replace_convolution_with_innerproduct_after_global_pooling();
     int replace_convolution_with_innerproduct_after_innerproduct();
+
+public:
+    int analyze_layout_conversion();
+
+protected:
+    int find_single_consumer(int blob_index) const;
 };
 
 NetOptimize::NetOptimize()
@@ -1739,6 +1752,211 @@ int NetOptimize::fuse_innerproduct_activation()
     return 0;
 }
 
+int NetOptimize::fold_constant_subgraph()
+{
+    if (has_custom_layer)
+    {
+        fprintf(stderr, "model has custom layer, fold_constant_subgraph skipped\n");
+        return -1;
+    }
+
+    // evaluate constant layers in plain fp32 layout, so the results can be stored as MemoryData
+    ncnn::Option opt_fold = opt;
+    opt_fold.use_packing_layout = false;
+    opt_fold.use_fp16_packed = false;
+    opt_fold.use_fp16_storage = false;
+    opt_fold.use_fp16_arithmetic = false;
+    opt_fold.use_bf16_storage = false;
+    opt_fold.use_int8_inference = false;
+    opt_fold.use_vulkan_compute = false;
+    opt_fold.blob_allocator = 0;
+    opt_fold.workspace_allocator = 0;
+
+    const size_t layer_count = layers.size();
+
+    std::map<int, ncnn::Mat> constant_blobs;
+    std::vector<bool> evaluated(layer_count, false);
+
+    // propagate MemoryData values through every layer whose inputs are all constant
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        ncnn::Layer* layer = layers[i];
+        if (layer->type == "ncnnfused")
+            continue;
+
+        if (layer->type == "MemoryData")
+        {
+            constant_blobs[layer->tops[0]] = ((ncnn::MemoryData*)layer)->data;
+            continue;
+        }
+
+        if (layer->type == "Input" || layer->bottoms.empty())
+            continue;
+
+        size_t bottom_elemcount = 0;
+        std::vector<ncnn::Mat> bottom_blobs(layer->bottoms.size());
+        bool all_constant = true;
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            std::map<int, ncnn::Mat>::const_iterator it = constant_blobs.find(layer->bottoms[j]);
+            if (it == constant_blobs.end())
+            {
+                all_constant = false;
+                break;
+            }
+
+            bottom_blobs[j] = it->second;
+            bottom_elemcount += (size_t)it->second.w * it->second.h * it->second.d * it->second.c;
+        }
+
+        if (!all_constant)
+            continue;
+
+        std::vector<ncnn::Mat> top_blobs(layer->tops.size());
+
+        layer->destroy_pipeline(opt);
+
+        int ret = layer->create_pipeline(opt_fold);
+        if (ret == 0)
+        {
+            if (layer->one_blob_only)
+                ret = layer->forward(bottom_blobs[0], top_blobs[0], opt_fold);
+            else
+                ret = layer->forward(bottom_blobs, top_blobs, opt_fold);
+        }
+
+        layer->destroy_pipeline(opt_fold);
+        layer->create_pipeline(opt);
+
+        if (ret != 0)
+            continue;
+
+        size_t top_elemcount = 0;
+        bool top_valid = true;
+        for (size_t j = 0; j < top_blobs.size(); j++)
+        {
+            const ncnn::Mat& m = top_blobs[j];
+            if (m.empty() || m.elempack != 1 || m.elemsize != 4u)
+            {
+                top_valid = false;
+                break;
+            }
+
+            top_elemcount += (size_t)m.w * m.h * m.d * m.c;
+        }
+
+        // keep expanding layers such as Tile at runtime instead of storing the larger constant
+        if (!top_valid || top_elemcount > bottom_elemcount)
+            continue;
+
+        for (size_t j = 0; j < layer->tops.size(); j++)
+        {
+            constant_blobs[layer->tops[j]] = top_blobs[j];
+        }
+
+        evaluated[i] = true;
+    }
+
+    // decide from the last layer backwards, so every consumer is settled before its producer
+    std::vector<bool> folded(layer_count, false);
+    std::vector<int> materialized_top(layer_count, -1);
+    for (int i = (int)layer_count - 1; i >= 0; i--)
+    {
+        const ncnn::Layer* layer = layers[i];
+
+        if (!evaluated[i] && layer->type != "MemoryData")
+            continue;
+
+        int materialized_count = 0;
+        for (size_t j = 0; j < layer->tops.size(); j++)
+        {
+            int top_blob_index = layer->tops[j];
+
+            bool consumed = false;
+            bool live = false;
+            for (size_t k = i + 1; k < layer_count; k++)
+            {
+                if (layers[k]->type == "ncnnfused")
+                    continue;
+
+                if (std::find(layers[k]->bottoms.begin(), layers[k]->bottoms.end(), top_blob_index) == layers[k]->bottoms.end())
+                    continue;
+
+                consumed = true;
+                if (!folded[k])
+                {
+                    live = true;
+                    break;
+                }
+            }
+
+            // a blob without any consumer is a graph output and stays live
+            // a blob feeding folded layers only is not needed at runtime
+            if (consumed && !live)
+                continue;
+
+            materialized_count++;
+            materialized_top[i] = top_blob_index;
+        }
+
+        if (!evaluated[i])
+        {
+            // the source MemoryData of a folded chain
+            if (materialized_count == 0)
+                folded[i] = true;
+            continue;
+        }
+
+        // replacing a fan-out such as Split would duplicate the constant
+        if (materialized_count > 1)
+            continue;
+
+        folded[i] = true;
+    }
+
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (!folded[i])
+            continue;
+
+        ncnn::Layer* layer = layers[i];
+
+        fprintf(stderr, "fold_constant_subgraph %s\n", layer->name.c_str());
+
+        if (materialized_top[i] == -1)
+        {
+            // consumed by other folded layers only
+            layer->type = "ncnnfused";
+            continue;
+        }
+
+        int top_blob_index = materialized_top[i];
+        const ncnn::Mat& m = constant_blobs[top_blob_index];
+
+        ncnn::MemoryData* memorydata = (ncnn::MemoryData*)ncnn::create_layer("MemoryData");
+
+        memorydata->type = "MemoryData";
+        memorydata->name = layer->name;
+        memorydata->tops.push_back(top_blob_index);
+
+        ncnn::ParamDict pd;
+        memorydata->load_param(pd);
+
+        memorydata->w = m.w;
+        memorydata->h = m.dims >= 2 ? m.h : 0;
+        memorydata->d = m.dims == 4 ? m.d : 0;
+        memorydata->c = m.dims >= 3 ? m.c : 0;
+        memorydata->data = m;
+
+        blobs[top_blob_index].producer = (int)i;
+
+        layers[i] = memorydata;
+        delete layer;
+    }
+
+    return 0;
+}
+
 int NetOptimize::fuse_memorydata_binaryop()
 {
     const size_t layer_count = layers.size();
@@ -1810,6 +2028,8 @@ int NetOptimize::fuse_memorydata_binaryop()
 
         binaryop->with_scalar = 1;
         binaryop->b = scalar;
+        binaryop->one_blob_only = true;
+        binaryop->support_inplace = true;
 
         fprintf(stderr, "fuse_memorydata_binaryop %s %s\n", memorydata->name.c_str(), binaryop->name.c_str());
 
@@ -1913,6 +2133,8 @@ int NetOptimize::fuse_memorydata_binaryop()
 
         binaryop->with_scalar = 1;
         binaryop->b = scalar;
+        binaryop->one_blob_only = true;
+        binaryop->support_inplace = true;
 
         fprintf(stderr, "fuse_memorydata_binaryop %s %s\n", memorydata->name.c_str(), binaryop->name.c_str());
 
@@ -2047,6 +2269,590 @@ int NetOptimize::fuse_binaryop_eltwise()
     return 0;
 }
 
+int NetOptimize::find_single_consumer(int blob_index) const
+{
+    int consumer = -1;
+
+    const size_t layer_count = layers.size();
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        const ncnn::Layer* layer = layers[i];
+        if (layer->type == "ncnnfused")
+            continue;
+
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            if (layer->bottoms[j] != blob_index)
+                continue;
+
+            if (consumer != -1)
+                return -1;
+
+            consumer = (int)i;
+        }
+    }
+
+    return consumer;
+}
+
+static bool is_scalar_binaryop(const ncnn::Layer* layer, int op_type, float b)
+{
+    if (layer->type != "BinaryOp")
+        return false;
+
+    const ncnn::BinaryOp* binaryop = (const ncnn::BinaryOp*)layer;
+
+    return binaryop->op_type == op_type && binaryop->with_scalar == 1 && fabs(binaryop->b - b) < 1e-4f;
+}
+
+static bool is_last_axis_mean(const ncnn::Layer* layer)
+{
+    if (layer->type != "Reduction")
+        return false;
+
+    const ncnn::Reduction* reduction = (const ncnn::Reduction*)layer;
+
+    if (reduction->operation != ncnn::Reduction::ReductionOp_MEAN || reduction->reduce_all != 0 || reduction->keepdims != 1 || reduction->coeff != 1.f)
+        return false;
+
+    return reduction->axes.w == 1 && ((const int*)reduction->axes)[0] == -1;
+}
+
+// the bottom of the 2-input binaryop that is not blob_index, -1 if it is not a plain binaryop of type op_type
+static int other_binaryop_bottom(const ncnn::Layer* layer, int op_type, int blob_index)
+{
+    if (layer->type != "BinaryOp" || layer->bottoms.size() != 2)
+        return -1;
+
+    if (((const ncnn::BinaryOp*)layer)->op_type != op_type)
+        return -1;
+
+    if (layer->bottoms[0] == blob_index)
+        return layer->bottoms[1];
+
+    if (layer->bottoms[1] == blob_index)
+        return layer->bottoms[0];
+
+    return -1;
+}
+
+int NetOptimize::fuse_layernorm()
+{
+    const size_t layer_count = layers.size();
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (!is_last_axis_mean(layers[i]))
+            continue;
+
+        // Split - Reduction(mean) - BinaryOp(sub) - Split - BinaryOp(pow 2) - Reduction(mean) - BinaryOp(add eps) - UnaryOp(sqrt) - BinaryOp(div) - BinaryOp(mul gamma) - BinaryOp(add beta)
+        ncnn::Layer* mean0 = layers[i];
+
+        int x0_blob_index = mean0->bottoms[0];
+        int split_index = blobs[x0_blob_index].producer;
+        if (split_index == -1 || layers[split_index]->type != "Split")
+            continue;
+
+        ncnn::Layer* split = layers[split_index];
+
+        int sub_index = find_single_consumer(mean0->tops[0]);
+        if (sub_index == -1 || layers[sub_index]->type != "BinaryOp")
+            continue;
+
+        ncnn::BinaryOp* sub = (ncnn::BinaryOp*)layers[sub_index];
+        if (sub->op_type != ncnn::BinaryOp::Operation_SUB || sub->with_scalar != 0 || sub->bottoms.size() != 2 || sub->bottoms[1] != mean0->tops[0])
+            continue;
+
+        int x1_blob_index = sub->bottoms[0];
+        if (blobs[x1_blob_index].producer != split_index)
+            continue;
+
+        // the centered value feeds both the variance and the division
+        int split1_index = find_single_consumer(sub->tops[0]);
+        if (split1_index == -1 || layers[split1_index]->type != "Split" || layers[split1_index]->tops.size() != 2)
+            continue;
+
+        ncnn::Layer* split1 = layers[split1_index];
+
+        int sq_index = -1;
+        int d_blob_index = -1;
+        for (int k = 0; k < 2; k++)
+        {
+            int consumer = find_single_consumer(split1->tops[k]);
+            if (consumer == -1)
+                break;
+
+            const ncnn::Layer* layer = layers[consumer];
+            if (is_scalar_binaryop(layer, ncnn::BinaryOp::Operation_POW, 2.f) || (layer->type == "UnaryOp" && ((const ncnn::UnaryOp*)layer)->op_type == ncnn::UnaryOp::Operation_SQUARE))
+            {
+                sq_index = consumer;
+                d_blob_index = split1->tops[1 - k];
+                break;
+            }
+        }
+
+        if (sq_index == -1)
+            continue;
+
+        int mean1_index = find_single_consumer(layers[sq_index]->tops[0]);
+        if (mean1_index == -1 || !is_last_axis_mean(layers[mean1_index]))
+            continue;
+
+        int add_eps_index = find_single_consumer(layers[mean1_index]->tops[0]);
+        if (add_eps_index == -1 || layers[add_eps_index]->type != "BinaryOp")
+            continue;
+
+        ncnn::BinaryOp* add_eps = (ncnn::BinaryOp*)layers[add_eps_index];
+        if (add_eps->op_type != ncnn::BinaryOp::Operation_ADD || add_eps->with_scalar != 1)
+            continue;
+
+        int rstd_index = find_single_consumer(add_eps->tops[0]);
+        if (rstd_index == -1 || layers[rstd_index]->type != "UnaryOp")
+            continue;
+
+        // x / sqrt(var + eps) or x * rsqrt(var + eps)
+        int rstd_op_type = ((const ncnn::UnaryOp*)layers[rstd_index])->op_type;
+
+        int norm_index = find_single_consumer(layers[rstd_index]->tops[0]);
+        if (norm_index == -1)
+            continue;
+
+        if (rstd_op_type == ncnn::UnaryOp::Operation_SQRT)
+        {
+            const ncnn::Layer* div = layers[norm_index];
+            if (div->type != "BinaryOp" || ((const ncnn::BinaryOp*)div)->op_type != ncnn::BinaryOp::Operation_DIV || div->bottoms.size() != 2)
+                continue;
+
+            if (div->bottoms[0] != d_blob_index || div->bottoms[1] != layers[rstd_index]->tops[0])
+                continue;
+        }
+        else if (rstd_op_type == ncnn::UnaryOp::Operation_RSQRT)
+        {
+            if (other_binaryop_bottom(layers[norm_index], ncnn::BinaryOp::Operation_MUL, layers[rstd_index]->tops[0]) != d_blob_index)
+                continue;
+        }
+        else
+        {
+            continue;
+        }
+
+        // affine
+        int mul_gamma_index = find_single_consumer(layers[norm_index]->tops[0]);
+        if (mul_gamma_index == -1)
+            continue;
+
+        int gamma_blob_index = other_binaryop_bottom(layers[mul_gamma_index], ncnn::BinaryOp::Operation_MUL, layers[norm_index]->tops[0]);
+        if (gamma_blob_index == -1)
+            continue;
+
+        int add_beta_index = find_single_consumer(layers[mul_gamma_index]->tops[0]);
+        if (add_beta_index == -1)
+            continue;
+
+        int beta_blob_index = other_binaryop_bottom(layers[add_beta_index], ncnn::BinaryOp::Operation_ADD, layers[mul_gamma_index]->tops[0]);
+        if (beta_blob_index == -1)
+            continue;
+
+        int gamma_index = blobs[gamma_blob_index].producer;
+        int beta_index = blobs[beta_blob_index].producer;
+        if (gamma_index == -1 || layers[gamma_index]->type != "MemoryData" || beta_index == -1 || layers[beta_index]->type != "MemoryData")
+            continue;
+
+        ncnn::MemoryData* gamma = (ncnn::MemoryData*)layers[gamma_index];
+        ncnn::MemoryData* beta = (ncnn::MemoryData*)layers[beta_index];
+        if (gamma->h != 0 || gamma->c != 0 || beta->h != 0 || beta->c != 0 || gamma->w != beta->w)
+        {
+            // not a per-element vector
+            continue;
+        }
+
+        if (gamma->w == 1)
+        {
+            // per-tensor scale, would normalize the whole blob as one row
+            continue;
+        }
+
+        // binaryop broadcasts a vector per row or per channel of a blob with more dims
+        // so the vector runs along the normalized axis only when the input is a vector as long
+        const ncnn::Mat& x0_shape = blobs[x0_blob_index].shape;
+        if (x0_shape.dims != 0 && (x0_shape.dims != 1 || x0_shape.w != gamma->w))
+            continue;
+
+        if (find_single_consumer(gamma_blob_index) != mul_gamma_index || find_single_consumer(beta_blob_index) != add_beta_index)
+            continue;
+
+        // fuse to LayerNorm
+        ncnn::Layer* add_beta = layers[add_beta_index];
+
+        fprintf(stderr, "fuse_layernorm %s %s\n", mean0->name.c_str(), add_beta->name.c_str());
+
+        ncnn::LayerNorm* layernorm = (ncnn::LayerNorm*)ncnn::create_layer("LayerNorm");
+
+        layernorm->type = "LayerNorm";
+        layernorm->name = add_beta->name;
+        layernorm->bottoms.push_back(x0_blob_index);
+        layernorm->tops = add_beta->tops;
+
+        ncnn::ParamDict pd;
+        layernorm->load_param(pd);
+
+        layernorm->affine_size = gamma->w;
+        layernorm->eps = add_eps->b;
+        layernorm->affine = 1;
+        layernorm->gamma_data = gamma->data;
+        layernorm->beta_data = beta->data;
+
+        blobs[x0_blob_index].consumer = add_beta_index;
+        blobs[add_beta->tops[0]].producer = add_beta_index;
+
+        // the centered branch is consumed inside LayerNorm now
+        split->tops.erase(std::find(split->tops.begin(), split->tops.end(), x1_blob_index));
+
+        mean0->type = "ncnnfused";
+        sub->type = "ncnnfused";
+        split1->type = "ncnnfused";
+        layers[sq_index]->type = "ncnnfused";
+        layers[mean1_index]->type = "ncnnfused";
+        add_eps->type = "ncnnfused";
+        layers[rstd_index]->type = "ncnnfused";
+        layers[norm_index]->type = "ncnnfused";
+        layers[mul_gamma_index]->type = "ncnnfused";
+        gamma->type = "ncnnfused";
+        beta->type = "ncnnfused";
+
+        layers[add_beta_index] = layernorm;
+        delete add_beta;
+    }
+
+    return 0;
+}
+
+int NetOptimize::fuse_gelu()
+{
+    const size_t layer_count = layers.size();
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (layers[i]->type != "UnaryOp" || ((const ncnn::UnaryOp*)layers[i])->op_type != ncnn::UnaryOp::Operation_TANH)
+            continue;
+
+        // 0.5x * (1 + tanh(sqrt(2/pi) * (x + 0.044715x^3)))
+        // Split - BinaryOp(pow 3) - BinaryOp(mul 0.044715) - BinaryOp(add x) - BinaryOp(mul sqrt(2/pi)) - UnaryOp(tanh) - BinaryOp(add 1) - BinaryOp(mul x or 0.5x) [- BinaryOp(mul 0.5)]
+        ncnn::Layer* unaryop = layers[i];
+
+        int mul_sqrt_index = blobs[unaryop->bottoms[0]].producer;
+        if (mul_sqrt_index == -1 || !is_scalar_binaryop(layers[mul_sqrt_index], ncnn::BinaryOp::Operation_MUL, 0.7978845608f))
+            continue;
+
+        int add_x_index = blobs[layers[mul_sqrt_index]->bottoms[0]].producer;
+        if (add_x_index == -1 || layers[add_x_index]->type != "BinaryOp" || layers[add_x_index]->bottoms.size() != 2)
+            continue;
+
+        ncnn::Layer* add_x = layers[add_x_index];
+        if (((const ncnn::BinaryOp*)add_x)->op_type != ncnn::BinaryOp::Operation_ADD)
+            continue;
+
+        // one side is x, the other 0.044715x^3
+        int mul_cube_index = -1;
+        int x0_blob_index = -1;
+        for (int k = 0; k < 2; k++)
+        {
+            int producer = blobs[add_x->bottoms[k]].producer;
+            if (producer != -1 && is_scalar_binaryop(layers[producer], ncnn::BinaryOp::Operation_MUL, 0.044715f))
+            {
+                mul_cube_index = producer;
+                x0_blob_index = add_x->bottoms[1 - k];
+                break;
+            }
+        }
+
+        if (mul_cube_index == -1)
+            continue;
+
+        int pow_index = blobs[layers[mul_cube_index]->bottoms[0]].producer;
+        if (pow_index == -1 || !is_scalar_binaryop(layers[pow_index], ncnn::BinaryOp::Operation_POW, 3.f))
+            continue;
+
+        int x1_blob_index = layers[pow_index]->bottoms[0];
+
+        int split_index = blobs[x0_blob_index].producer;
+        if (split_index == -1 || layers[split_index]->type != "Split" || blobs[x1_blob_index].producer != split_index)
+            continue;
+
+        ncnn::Layer* split = layers[split_index];
+
+        int add_one_index = find_single_consumer(unaryop->tops[0]);
+        if (add_one_index == -1 || !is_scalar_binaryop(layers[add_one_index], ncnn::BinaryOp::Operation_ADD, 1.f))
+            continue;
+
+        int mul_index = find_single_consumer(layers[add_one_index]->tops[0]);
+        if (mul_index == -1)
+            continue;
+
+        int x2_blob_index = other_binaryop_bottom(layers[mul_index], ncnn::BinaryOp::Operation_MUL, layers[add_one_index]->tops[0]);
+        if (x2_blob_index == -1)
+            continue;
+
+        // 0.5 is applied either to x before or to the product after
+        int half_index = -1;
+        int last_index = mul_index;
+        if (blobs[x2_blob_index].producer != split_index)
+        {
+            half_index = blobs[x2_blob_index].producer;
+            if (half_index == -1 || !is_scalar_binaryop(layers[half_index], ncnn::BinaryOp::Operation_MUL, 0.5f))
+                continue;
+
+            x2_blob_index = layers[half_index]->bottoms[0];
+            if (blobs[x2_blob_index].producer != split_index || find_single_consumer(layers[half_index]->tops[0]) != mul_index)
+                continue;
+        }
+        else
+        {
+            half_index = find_single_consumer(layers[mul_index]->tops[0]);
+            if (half_index == -1 || !is_scalar_binaryop(layers[half_index], ncnn::BinaryOp::Operation_MUL, 0.5f))
+                continue;
+
+            last_index = half_index;
+        }
+
+        if (x0_blob_index == x1_blob_index || x0_blob_index == x2_blob_index || x1_blob_index == x2_blob_index)
+            continue;
+
+        // fuse to GELU
+        ncnn::Layer* last = layers[last_index];
+
+        fprintf(stderr, "fuse_gelu %s %s\n", layers[pow_index]->name.c_str(), last->name.c_str());
+
+        ncnn::GELU* gelu = (ncnn::GELU*)ncnn::create_layer("GELU");
+
+        gelu->type = "GELU";
+        gelu->name = last->name;
+        gelu->bottoms.push_back(x0_blob_index);
+        gelu->tops = last->tops;
+
+        ncnn::ParamDict pd;
+        gelu->load_param(pd);
+
+        gelu->fast_gelu = 1;
+
+        blobs[x0_blob_index].consumer = last_index;
+        blobs[last->tops[0]].producer = last_index;
+
+        split->tops.erase(std::find(split->tops.begin(), split->tops.end(), x1_blob_index));
+        split->tops.erase(std::find(split->tops.begin(), split->tops.end(), x2_blob_index));
+
+        layers[pow_index]->type = "ncnnfused";
+        layers[mul_cube_index]->type = "ncnnfused";
+        add_x->type = "ncnnfused";
+        layers[mul_sqrt_index]->type = "ncnnfused";
+        unaryop->type = "ncnnfused";
+        layers[add_one_index]->type = "ncnnfused";
+        if (last_index != mul_index)
+            layers[mul_index]->type = "ncnnfused";
+        if (last_index != half_index)
+            layers[half_index]->type = "ncnnfused";
+
+        layers[last_index] = gelu;
+        delete last;
+    }
+
+    return 0;
+}
+
+int NetOptimize::fuse_padding_convolution()
+{
+    const size_t layer_count = layers.size();
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (layers[i]->type != "Padding")
+            continue;
+
+        ncnn::Padding* padding = (ncnn::Padding*)layers[i];
+
+        // constant zero spatial padding only
+        if (padding->bottoms.size() != 1 || padding->type != 0 || padding->per_channel_pad_data_size != 0 || padding->value != 0.f)
+            continue;
+
+        if (padding->front != 0 || padding->behind != 0)
+            continue;
+
+        if (padding->top < 0 || padding->bottom < 0 || padding->left < 0 || padding->right < 0)
+            continue;
+
+        // Padding - Convolution
+        int top_blob_index = padding->tops[0];
+
+        int j = find_single_consumer(top_blob_index);
+        if (j == -1 || layers[j]->type != "Convolution")
+            continue;
+
+        ncnn::Convolution* convolution = (ncnn::Convolution*)layers[j];
+
+        if (convolution->pad_left < 0 || convolution->pad_right < 0 || convolution->pad_top < 0 || convolution->pad_bottom < 0)
+            continue;
+
+        bool convolution_has_pad = convolution->pad_left > 0 || convolution->pad_right > 0 || convolution->pad_top > 0 || convolution->pad_bottom > 0;
+        if (convolution_has_pad && convolution->pad_value != 0.f)
+            continue;
+
+        fprintf(stderr, "fuse_padding_convolution %s %s\n", padding->name.c_str(), convolution->name.c_str());
+
+        convolution->pad_left += padding->left;
+        convolution->pad_right += padding->right;
+        convolution->pad_top += padding->top;
+        convolution->pad_bottom += padding->bottom;
+        convolution->pad_value = 0.f;
+
+        int bottom_blob_index_final = padding->bottoms[0];
+        convolution->bottoms[0] = bottom_blob_index_final;
+        blobs[bottom_blob_index_final].consumer = j;
+        layers[i]->type = "ncnnfused";
+    }
+
+    return 0;
+}
+
+int NetOptimize::fuse_padding_convolutiondepthwise()
+{
+    const size_t layer_count = layers.size();
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (layers[i]->type != "Padding")
+            continue;
+
+        ncnn::Padding* padding = (ncnn::Padding*)layers[i];
+
+        // constant zero spatial padding only
+        if (padding->bottoms.size() != 1 || padding->type != 0 || padding->per_channel_pad_data_size != 0 || padding->value != 0.f)
+            continue;
+
+        if (padding->front != 0 || padding->behind != 0)
+            continue;
+
+        if (padding->top < 0 || padding->bottom < 0 || padding->left < 0 || padding->right < 0)
+            continue;
+
+        // Padding - ConvolutionDepthWise
+        int top_blob_index = padding->tops[0];
+
+        int j = find_single_consumer(top_blob_index);
+        if (j == -1 || layers[j]->type != "ConvolutionDepthWise")
+            continue;
+
+        ncnn::ConvolutionDepthWise* convolutiondepthwise = (ncnn::ConvolutionDepthWise*)layers[j];
+
+        if (convolutiondepthwise->pad_left < 0 || convolutiondepthwise->pad_right < 0 || convolutiondepthwise->pad_top < 0 || convolutiondepthwise->pad_bottom < 0)
+            continue;
+
+        bool convolutiondepthwise_has_pad = convolutiondepthwise->pad_left > 0 || convolutiondepthwise->pad_right > 0 || convolutiondepthwise->pad_top > 0 || convolutiondepthwise->pad_bottom > 0;
+        if (convolutiondepthwise_has_pad && convolutiondepthwise->pad_value != 0.f)
+            continue;
+
+        fprintf(stderr, "fuse_padding_convolutiondepthwise %s %s\n", padding->name.c_str(), convolutiondepthwise->name.c_str());
+
+        convolutiondepthwise->pad_left += padding->left;
+        convolutiondepthwise->pad_right += padding->right;
+        convolutiondepthwise->pad_top += padding->top;
+        convolutiondepthwise->pad_bottom += padding->bottom;
+        convolutiondepthwise->pad_value = 0.f;
+
+        int bottom_blob_index_final = padding->bottoms[0];
+        convolutiondepthwise->bottoms[0] = bottom_blob_index_final;
+        blobs[bottom_blob_index_final].consumer = j;
+        layers[i]->type = "ncnnfused";
+    }
+
+    return 0;
+}
+
+int NetOptimize::fuse_convolutiondepthwise_convolution()
+{
+    const size_t layer_count = layers.size();
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (layers[i]->type != "ConvolutionDepthWise")
+            continue;
+
+        ncnn::ConvolutionDepthWise* convolutiondepthwise = (ncnn::ConvolutionDepthWise*)layers[i];
+
+        // fp32 depth-wise only
+        const int maxk = convolutiondepthwise->kernel_w * convolutiondepthwise->kernel_h;
+        if (convolutiondepthwise->group != convolutiondepthwise->num_output || convolutiondepthwise->weight_data_size != convolutiondepthwise->num_output * maxk)
+            continue;
+
+        if (convolutiondepthwise->int8_scale_term || convolutiondepthwise->dynamic_weight)
+            continue;
+
+        // ConvolutionDepthWise - Convolution1x1
+        int top_blob_index = convolutiondepthwise->tops[0];
+
+        int j = find_single_consumer(top_blob_index);
+        if (j == -1 || layers[j]->type != "Convolution")
+            continue;
+
+        ncnn::Convolution* convolution = (ncnn::Convolution*)layers[j];
+
+        if (convolution->kernel_w != 1 || convolution->kernel_h != 1 || convolution->stride_w != 1 || convolution->stride_h != 1)
+            continue;
+
+        if (convolution->pad_left != 0 || convolution->pad_right != 0 || convolution->pad_top != 0 || convolution->pad_bottom != 0)
+            continue;
+
+        if (convolution->int8_scale_term || convolution->dynamic_weight)
+            continue;
+
+        if (convolution->weight_data_size != convolution->num_output * convolutiondepthwise->num_output)
+            continue;
+
+        fprintf(stderr, "fuse_convolutiondepthwise_convolution %s %s\n", convolutiondepthwise->name.c_str(), convolution->name.c_str());
+
+        ncnn::ConvolutionDepthWisePointWise* convolutiondepthwisepointwise = (ncnn::ConvolutionDepthWisePointWise*)ncnn::create_layer("ConvolutionDepthWisePointWise");
+
+        convolutiondepthwisepointwise->type = "ConvolutionDepthWisePointWise";
+        convolutiondepthwisepointwise->name = convolutiondepthwise->name;
+        convolutiondepthwisepointwise->bottoms = convolutiondepthwise->bottoms;
+        convolutiondepthwisepointwise->tops = convolution->tops;
+
+        ncnn::ParamDict pd;
+        convolutiondepthwisepointwise->load_param(pd);
+
+        convolutiondepthwisepointwise->num_output = convolutiondepthwise->num_output;
+        convolutiondepthwisepointwise->kernel_w = convolutiondepthwise->kernel_w;
+        convolutiondepthwisepointwise->kernel_h = convolutiondepthwise->kernel_h;
+        convolutiondepthwisepointwise->dilation_w = convolutiondepthwise->dilation_w;
+        convolutiondepthwisepointwise->dilation_h = convolutiondepthwise->dilation_h;
+        convolutiondepthwisepointwise->stride_w = convolutiondepthwise->stride_w;
+        convolutiondepthwisepointwise->stride_h = convolutiondepthwise->stride_h;
+        convolutiondepthwisepointwise->pad_left = convolutiondepthwise->pad_left;
+        convolutiondepthwisepointwise->pad_right = convolutiondepthwise->pad_right;
+        convolutiondepthwisepointwise->pad_top = convolutiondepthwise->pad_top;
+        convolutiondepthwisepointwise->pad_bottom = convolutiondepthwise->pad_bottom;
+        convolutiondepthwisepointwise->pad_value = convolutiondepthwise->pad_value;
+        convolutiondepthwisepointwise->bias_term = convolutiondepthwise->bias_term;
+        convolutiondepthwisepointwise->weight_data_size = convolutiondepthwise->weight_data_size;
+        convolutiondepthwisepointwise->activation_type = convolutiondepthwise->activation_type;
+        convolutiondepthwisepointwise->activation_params = convolutiondepthwise->activation_params;
+
+        convolutiondepthwisepointwise->pointwise_num_output = convolution->num_output;
+        convolutiondepthwisepointwise->pointwise_bias_term = convolution->bias_term;
+        convolutiondepthwisepointwise->pointwise_weight_data_size = convolution->weight_data_size;
+        convolutiondepthwisepointwise->pointwise_activation_type = convolution->activation_type;
+        convolutiondepthwisepointwise->pointwise_activation_params = convolution->activation_params;
+
+        convolutiondepthwisepointwise->weight_data = convolutiondepthwise->weight_data;
+        convolutiondepthwisepointwise->bias_data = convolutiondepthwise->bias_data;
+        convolutiondepthwisepointwise->pointwise_weight_data = convolution->weight_data;
+        convolutiondepthwisepointwise->pointwise_bias_data = convolution->bias_data;
+
+        int top_blob_index_final = convolution->tops[0];
+        blobs[top_blob_index_final].producer = i;
+        convolution->type = "ncnnfused";
+
+        layers[i] = convolutiondepthwisepointwise;
+        delete convolutiondepthwise;
+    }
+
+    return 0;
+}
+
 int NetOptimize::eliminate_dropout()
 {
     const size_t layer_count = layers.size();
@@ -2293,12 +3099,10 @@ int NetOptimize::eliminate_orphaned_memorydata()
         // MemoryData - X
         int top_blob_index = layers[i]->tops[0];
 
+        bool consumed = false;
         size_t j = i + 1;
         for (; j < layer_count; j++)
         {
-            if (layers[j]->type == "ncnnfused")
-                continue;
-
             bool orphaned = true;
             for (size_t k = 0; k < layers[j]->bottoms.size(); k++)
             {
@@ -2309,11 +3113,16 @@ int NetOptimize::eliminate_orphaned_memorydata()
                 }
             }
 
-            if (!orphaned)
+            if (orphaned)
+                continue;
+
+            consumed = true;
+            if (layers[j]->type != "ncnnfused")
                 break;
         }
 
-        if (j < layer_count)
+        // MemoryData without any consumer is a graph output
+        if (!consumed || j < layer_count)
             continue;
 
         // assert orphaned == true
@@ -2753,6 +3562,127 @@ int NetOptimize::replace_convolution_with_innerproduct_after_innerproduct()
     return 0;
 }
 
+// mirror the dst_elempack resolution of the runtime convert_layout
+static int resolve_dst_elempack(int elemcount, int elembits)
+{
+    if (elembits == 32)
+    {
+#if NCNN_AVX512
+        if (elemcount % 16 == 0 && ncnn::cpu_support_x86_avx512())
+            return 16;
+        if (elemcount % 8 == 0 && ncnn::cpu_support_x86_avx())
+            return 8;
+#elif NCNN_AVX
+        if (elemcount % 8 == 0 && ncnn::cpu_support_x86_avx())
+            return 8;
+#endif
+        if (elemcount % 4 == 0)
+            return 4;
+    }
+    if (elembits == 16)
+    {
+        if (elemcount % 4 == 0)
+            return 4;
+    }
+
+    return 1;
+}
+
+int NetOptimize::analyze_layout_conversion()
+{
+    if (has_custom_layer)
+    {
+        fprintf(stderr, "model has custom layer, analyze_layout_conversion skipped\n");
+        return -1;
+    }
+
+    const size_t layer_count = layers.size();
+    const size_t blob_count = blobs.size();
+
+    // elempack and storage bits of every blob as its producer emits it
+    std::vector<int> blob_elempack(blob_count, 1);
+    std::vector<int> blob_elembits(blob_count, 32);
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        const ncnn::Layer* layer = layers[i];
+        if (layer->type == "ncnnfused" || layer->type == "Input")
+            continue;
+
+        for (size_t j = 0; j < layer->tops.size(); j++)
+        {
+            int top_blob_index = layer->tops[j];
+            const ncnn::Mat& shape = blobs[top_blob_index].shape;
+            if (shape.dims == 0)
+                continue;
+
+            int elembits = opt.use_bf16_storage && layer->support_bf16_storage ? 16 : 32;
+            int elemcount = shape.dims == 1 ? shape.w : shape.dims == 2 ? shape.h : shape.c;
+
+            blob_elembits[top_blob_index] = elembits;
+            blob_elempack[top_blob_index] = opt.use_packing_layout && layer->support_packing ? resolve_dst_elempack(elemcount, elembits) : 1;
+        }
+    }
+
+    fprintf(stderr, "analyze_layout_conversion\n");
+
+    // walk every consumer edge the way convert_layout does
+    int conversion_count = 0;
+    size_t conversion_bytes = 0;
+    std::map<std::pair<int, int>, int> conversion_targets;
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        const ncnn::Layer* layer = layers[i];
+        if (layer->type == "ncnnfused")
+            continue;
+
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            int bottom_blob_index = layer->bottoms[j];
+            const ncnn::Blob& blob = blobs[bottom_blob_index];
+            if (blob.shape.dims == 0)
+                continue;
+
+            int elembits = blob_elembits[bottom_blob_index];
+            int elempack = blob_elempack[bottom_blob_index];
+
+            int dst_elembits = elembits;
+            if (opt.use_bf16_storage)
+                dst_elembits = layer->support_bf16_storage ? 16 : 32;
+
+            int elemcount = blob.shape.dims == 1 ? blob.shape.w : blob.shape.dims == 2 ? blob.shape.h : blob.shape.c;
+            int dst_elempack = opt.use_packing_layout && layer->support_packing ? resolve_dst_elempack(elemcount, dst_elembits) : 1;
+
+            if (elembits == dst_elembits && elempack == dst_elempack)
+                continue;
+
+            const size_t bytes = (size_t)blob.shape.w * blob.shape.h * blob.shape.d * blob.shape.c * dst_elembits / 8;
+            const char* producer_name = blob.producer == -1 ? "" : layers[blob.producer]->name.c_str();
+
+            fprintf(stderr, "layout conversion %s -> %s  blob %s  elempack %d -> %d  elembits %d -> %d  %.2f KB\n", producer_name, layer->name.c_str(), blob.name.c_str(), elempack, dst_elempack, elembits, dst_elembits, bytes / 1024.f);
+
+            conversion_count++;
+            conversion_bytes += bytes;
+            conversion_targets[std::make_pair(bottom_blob_index, dst_elempack * 64 + dst_elembits)]++;
+        }
+    }
+
+    // the same conversion repeated for sibling consumers is a candidate for one explicit conversion point
+    for (std::map<std::pair<int, int>, int>::const_iterator it = conversion_targets.begin(); it != conversion_targets.end(); ++it)
+    {
+        if (it->second < 2)
+            continue;
+
+        const int dst_elempack = it->first.second / 64;
+        const int dst_elembits = it->first.second % 64;
+
+        fprintf(stderr, "blob %s converted %d times to elempack %d elembits %d, convert once before the split\n", blobs[it->first.first].name.c_str(), it->second, dst_elempack, dst_elembits);
+    }
+
+    fprintf(stderr, "layout conversion = %d times %.2f KB = %.2f MB\n", conversion_count, conversion_bytes / 1024.f, conversion_bytes / 1024.f / 1024.f);
+
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
     if (argc < 6)
@@ -2781,7 +3711,7 @@ int main(int argc, char** argv)
 
     NetOptimize optimizer;
 
-    if (flag == 65536 || flag == 1)
+    if ((flag & 65536) || (flag & 1))
     {
         optimizer.storage_type = 1;
     }
@@ -2829,8 +3759,13 @@ int main(int argc, char** argv)
     optimizer.fuse_deconvolution_activation();
     optimizer.fuse_deconvolutiondepthwise_activation();
     optimizer.fuse_innerproduct_activation();
+    optimizer.fold_constant_subgraph();
     optimizer.fuse_memorydata_binaryop();
+    optimizer.fuse_layernorm();
+    optimizer.fuse_gelu();
     optimizer.fuse_binaryop_eltwise();
+    optimizer.fuse_padding_convolution();
+    optimizer.fuse_padding_convolutiondepthwise();
 
     optimizer.eliminate_dropout();
     optimizer.eliminate_pooling1x1();
@@ -2846,8 +3781,16 @@ int main(int argc, char** argv)
     optimizer.eliminate_flatten_after_innerproduct();
     optimizer.eliminate_orphaned_memorydata();
 
+    // flag bit 2 fuses depth-wise and point-wise convolution blocks for x86 cpu
+    if (flag & 2)
+    {
+        optimizer.fuse_convolutiondepthwise_convolution();
+    }
+
     optimizer.shape_inference();
 
+    optimizer.analyze_layout_conversion();
+
     optimizer.estimate_memory_footprint();
 
     optimizer.save(outparam, outbin);
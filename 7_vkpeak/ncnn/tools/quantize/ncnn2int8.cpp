@@ -190,6 +190,15 @@ int NetQuantize::quantize_convolution()
         convolution->int8_scale_term = 2;
         convolution->weight_data_int8_scales = weight_data_int8_scales;
         convolution->bottom_blob_int8_scales = bottom_blob_int8_scales;
+
+        // asymmetric activation
+        sprintf(key, "%s_zero_point", layers[i]->name.c_str());
+
+        std::map<std::string, ncnn::Mat>::iterator iter_zero_point = blob_int8scale_table.find(key);
+        if (iter_zero_point != blob_int8scale_table.end())
+        {
+            convolution->bottom_blob_int8_zero_point = (int)iter_zero_point->second[0];
+        }
     }
 
     return 0;
@@ -350,6 +359,10 @@ int NetQuantize::fuse_requantize()
             if (convolution1->weight_data.elemsize != 1u || convolution2->weight_data.elemsize != 1u)
                 continue;
 
+            // requantize output has no zero point
+            if (convolution2->bottom_blob_int8_zero_point != 0)
+                continue;
+
             convolution1->int8_scale_term += 100;
             convolution1->top_blob_int8_scales = convolution2->bottom_blob_int8_scales;
         }
@@ -372,6 +385,10 @@ int NetQuantize::fuse_requantize()
             if (convolution1->weight_data.elemsize != 1u || convolution2->weight_data.elemsize != 1u)
                 continue;
 
+            // requantize output has no zero point
+            if (convolution2->bottom_blob_int8_zero_point != 0)
+                continue;
+
             convolution1->int8_scale_term += 100;
             convolution1->top_blob_int8_scales = convolution2->bottom_blob_int8_scales;
         }
@@ -441,7 +458,7 @@ int NetQuantize::fuse_requantize()
             if (layers[k]->type == "Convolution")
             {
                 ncnn::Convolution* convolution = (ncnn::Convolution*)layers[k];
-                if (convolution->weight_data.elemsize != 1u)
+                if (convolution->weight_data.elemsize != 1u || convolution->bottom_blob_int8_zero_point != 0)
                 {
                     all_conv = false;
                     break;
@@ -474,6 +491,10 @@ int NetQuantize::fuse_requantize()
             if (convolution1->weight_data.elemsize != 1u || convolution2->weight_data.elemsize != 1u)
                 continue;
 
+            // requantize output has no zero point
+            if (convolution2->bottom_blob_int8_zero_point != 0)
+                continue;
+
             convolution1->int8_scale_term += 100;
             convolution1->top_blob_int8_scales = convolution2->bottom_blob_int8_scales;
         }
@@ -496,6 +517,10 @@ int NetQuantize::fuse_requantize()
             if (convolution1->weight_data.elemsize != 1u || convolution2->weight_data.elemsize != 1u)
                 continue;
 
+            // requantize output has no zero point
+            if (convolution2->bottom_blob_int8_zero_point != 0)
+                continue;
+
             convolution1->int8_scale_term += 100;
             convolution1->top_blob_int8_scales = convolution2->bottom_blob_int8_scales;
         }
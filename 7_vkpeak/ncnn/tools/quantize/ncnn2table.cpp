@@ -36,6 +36,8 @@
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #endif
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -56,6 +58,8 @@ public:
     {
         threshold = 0.f;
         absmax = 0.f;
+        minval = 0.f;
+        maxval = 0.f;
         total = 0;
     }
 
@@ -63,6 +67,10 @@ public:
     float threshold;
     float absmax;
 
+    // asymmetric, range always covers zero
+    float minval;
+    float maxval;
+
     // ACIQ
     int total;
 
@@ -86,6 +94,8 @@ public:
     std::vector<std::vector<int> > shapes;
     std::vector<int> type_to_pixels;
     int quantize_num_threads;
+    float sensitivity_budget;
+    int quantize_asymmetric;
 
 public:
     int init();
@@ -94,6 +104,7 @@ public:
     int quantize_KL();
     int quantize_ACIQ();
     int quantize_EQ();
+    int quantize_sensitivity();
 
 public:
     std::vector<int> input_blobs;
@@ -105,12 +116,19 @@ public:
     std::vector<QuantBlobStat> quant_blob_stats;
     std::vector<ncnn::Mat> weight_scales;
     std::vector<ncnn::Mat> bottom_blob_scales;
+    std::vector<int> bottom_blob_zero_points;
+
+    // sensitivity
+    std::vector<float> layer_sensitivities;
+    std::vector<bool> layer_keep_fp32;
 };
 
 QuantNet::QuantNet()
     : blobs(mutable_blobs()), layers(mutable_layers())
 {
     quantize_num_threads = ncnn::get_cpu_count();
+    sensitivity_budget = 0.01f;
+    quantize_asymmetric = 0;
 }
 
 int QuantNet::init()
@@ -143,6 +161,10 @@ int QuantNet::init()
     quant_blob_stats.resize(conv_bottom_blob_count);
     weight_scales.resize(conv_layer_count);
     bottom_blob_scales.resize(conv_bottom_blob_count);
+    bottom_blob_zero_points.resize(conv_bottom_blob_count, 0);
+
+    layer_sensitivities.resize(conv_layer_count, 0.f);
+    layer_keep_fp32.resize(conv_layer_count, false);
 
     return 0;
 }
@@ -161,6 +183,10 @@ int QuantNet::save_table(const char* tablepath)
 
     for (int i = 0; i < conv_layer_count; i++)
     {
+        // layers absent from the table stay in fp32
+        if (layer_keep_fp32[i])
+            continue;
+
         const ncnn::Mat& weight_scale = weight_scales[i];
 
         fprintf(fp, "%s_param_0 ", layers[conv_layers[i]]->name.c_str());
@@ -173,6 +199,9 @@ int QuantNet::save_table(const char* tablepath)
 
     for (int i = 0; i < conv_bottom_blob_count; i++)
     {
+        if (layer_keep_fp32[i])
+            continue;
+
         const ncnn::Mat& bottom_blob_scale = bottom_blob_scales[i];
 
         fprintf(fp, "%s ", layers[conv_layers[i]]->name.c_str());
@@ -181,6 +210,11 @@ int QuantNet::save_table(const char* tablepath)
             fprintf(fp, "%f ", bottom_blob_scale[j]);
         }
         fprintf(fp, "\n");
+
+        if (bottom_blob_zero_points[i] != 0)
+        {
+            fprintf(fp, "%s_zero_point %d\n", layers[conv_layers[i]]->name.c_str(), bottom_blob_zero_points[i]);
+        }
     }
 
     fclose(fp);
@@ -251,6 +285,27 @@ static float compute_kl_divergence(const std::vector<float>& a, const std::vecto
     return result;
 }
 
+static int histogram_range_exponent(float absmax)
+{
+    int exponent;
+    frexpf(absmax, &exponent);
+    return exponent;
+}
+
+static void rescale_histogram(std::vector<uint64_t>& histogram, int shift)
+{
+    // merge the bins after doubling the range shift times
+    const int num_histogram_bins = (int)histogram.size();
+
+    std::vector<uint64_t> histogram_rescaled(num_histogram_bins, 0);
+    for (int k = 0; k < num_histogram_bins; k++)
+    {
+        histogram_rescaled[k >> std::min(shift, 31)] += histogram[k];
+    }
+
+    histogram.swap(histogram_rescaled);
+}
+
 int QuantNet::quantize_KL()
 {
     const int input_blob_count = (int)input_blobs.size();
@@ -258,7 +313,8 @@ int QuantNet::quantize_KL()
     const int conv_bottom_blob_count = (int)conv_bottom_blobs.size();
     const int image_count = (int)listspaths[0].size();
 
-    const int num_histogram_bins = 2048;
+    // histogram range is the power of two above absmax, so more than half of the bins are in use
+    const int num_histogram_bins = 4096;
 
     std::vector<ncnn::UnlockedPoolAllocator> blob_allocators(quantize_num_threads);
     std::vector<ncnn::UnlockedPoolAllocator> workspace_allocators(quantize_num_threads);
@@ -361,13 +417,27 @@ int QuantNet::quantize_KL()
         }
     }
 
-    // count the absmax
+    // per thread histograms, merged once all images are done
+    std::vector<std::vector<QuantBlobStat> > thread_blob_stats(quantize_num_threads);
+    for (int t = 0; t < quantize_num_threads; t++)
+    {
+        thread_blob_stats[t].resize(conv_bottom_blob_count);
+        for (int j = 0; j < conv_bottom_blob_count; j++)
+        {
+            thread_blob_stats[t][j].histogram.resize(num_histogram_bins, 0);
+        }
+    }
+
+    const double start_time = ncnn::get_current_time();
+
+    // count the absmax and build histogram in one forward pass
     #pragma omp parallel for num_threads(quantize_num_threads) schedule(static, 1)
     for (int i = 0; i < image_count; i++)
     {
         if (i % 100 == 0)
         {
-            fprintf(stderr, "count the absmax %.2f%% [ %d / %d ]\n", i * 100.f / image_count, i, image_count);
+            const double elapsed = (ncnn::get_current_time() - start_time) / 1000;
+            fprintf(stderr, "build histogram %.2f%% [ %d / %d ]  %.2f images/s\n", i * 100.f / image_count, i, image_count, elapsed > 0 ? i / elapsed : 0.0);
         }
 
         ncnn::Extractor ex = create_extractor();
@@ -401,88 +471,47 @@ int QuantNet::quantize_KL()
             ncnn::Mat out;
             ex.extract(conv_bottom_blobs[j], out);
 
+            QuantBlobStat& stat = thread_blob_stats[thread_num][j];
+
+            const int outc = out.c;
+            const int outsize = out.w * out.h;
+
             // count absmax
             {
-                float absmax = 0.f;
-
-                const int outc = out.c;
-                const int outsize = out.w * out.h;
+                float minval = 0.f;
+                float maxval = 0.f;
                 for (int p = 0; p < outc; p++)
                 {
                     const float* ptr = out.channel(p);
                     for (int k = 0; k < outsize; k++)
                     {
-                        absmax = std::max(absmax, (float)fabs(ptr[k]));
+                        minval = std::min(minval, ptr[k]);
+                        maxval = std::max(maxval, ptr[k]);
                     }
                 }
 
-                #pragma omp critical
-                {
-                    QuantBlobStat& stat = quant_blob_stats[j];
-                    stat.absmax = std::max(stat.absmax, absmax);
-                }
-            }
-        }
-    }
-
-    // initialize histogram
-    #pragma omp parallel for num_threads(quantize_num_threads)
-    for (int i = 0; i < conv_bottom_blob_count; i++)
-    {
-        QuantBlobStat& stat = quant_blob_stats[i];
-
-        stat.histogram.resize(num_histogram_bins, 0);
-        stat.histogram_normed.resize(num_histogram_bins, 0);
-    }
-
-    // build histogram
-    #pragma omp parallel for num_threads(quantize_num_threads) schedule(static, 1)
-    for (int i = 0; i < image_count; i++)
-    {
-        if (i % 100 == 0)
-        {
-            fprintf(stderr, "build histogram %.2f%% [ %d / %d ]\n", i * 100.f / image_count, i, image_count);
-        }
-
-        ncnn::Extractor ex = create_extractor();
-        ex.set_light_mode(true);
-
-        const int thread_num = ncnn::get_omp_thread_num();
-        ex.set_blob_allocator(&blob_allocators[thread_num]);
-        ex.set_workspace_allocator(&workspace_allocators[thread_num]);
+                stat.minval = std::min(stat.minval, minval);
+                stat.maxval = std::max(stat.maxval, maxval);
 
-        for (int j = 0; j < input_blob_count; j++)
-        {
-            const int type_to_pixel = type_to_pixels[j];
-            const std::vector<float>& mean_vals = means[j];
-            const std::vector<float>& norm_vals = norms[j];
+                const float absmax = std::max(-minval, maxval);
+                if (absmax > stat.absmax)
+                {
+                    if (stat.absmax > 0.f)
+                    {
+                        rescale_histogram(stat.histogram, histogram_range_exponent(absmax) - histogram_range_exponent(stat.absmax));
+                    }
 
-            int pixel_convert_type = ncnn::Mat::PIXEL_BGR;
-            if (type_to_pixel != pixel_convert_type)
-            {
-                pixel_convert_type = pixel_convert_type | (type_to_pixel << ncnn::Mat::PIXEL_CONVERT_SHIFT);
+                    stat.absmax = absmax;
+                }
             }
 
-            ncnn::Mat in = read_and_resize_image(shapes[j], listspaths[j][i], pixel_convert_type);
-
-            in.substract_mean_normalize(mean_vals.data(), norm_vals.data());
-
-            ex.input(input_blobs[j], in);
-        }
-
-        for (int j = 0; j < conv_bottom_blob_count; j++)
-        {
-            ncnn::Mat out;
-            ex.extract(conv_bottom_blobs[j], out);
+            if (stat.absmax == 0.f)
+                continue;
 
             // count histogram bin
             {
-                const float absmax = quant_blob_stats[j].absmax;
-
-                std::vector<uint64_t> histogram(num_histogram_bins, 0);
+                const float range = ldexpf(1.f, histogram_range_exponent(stat.absmax));
 
-                const int outc = out.c;
-                const int outsize = out.w * out.h;
                 for (int p = 0; p < outc; p++)
                 {
                     const float* ptr = out.channel(p);
@@ -491,23 +520,59 @@ int QuantNet::quantize_KL()
                         if (ptr[k] == 0.f)
                             continue;
 
-                        const int index = std::min((int)(fabs(ptr[k]) / absmax * num_histogram_bins), (num_histogram_bins - 1));
+                        const int index = std::min((int)(fabs(ptr[k]) / range * num_histogram_bins), (num_histogram_bins - 1));
 
-                        histogram[index] += 1;
+                        stat.histogram[index] += 1;
                     }
                 }
+            }
+        }
+    }
 
-                #pragma omp critical
-                {
-                    QuantBlobStat& stat = quant_blob_stats[j];
+    {
+        const double elapsed = (ncnn::get_current_time() - start_time) / 1000;
+        fprintf(stderr, "build histogram 100.00%% [ %d / %d ]  %.2f images/s\n", image_count, image_count, elapsed > 0 ? image_count / elapsed : 0.0);
+    }
 
-                    for (int k = 0; k < num_histogram_bins; k++)
-                    {
-                        stat.histogram[k] += histogram[k];
-                    }
-                }
+    // merge histogram
+    #pragma omp parallel for num_threads(quantize_num_threads)
+    for (int i = 0; i < conv_bottom_blob_count; i++)
+    {
+        QuantBlobStat& stat = quant_blob_stats[i];
+
+        for (int t = 0; t < quantize_num_threads; t++)
+        {
+            stat.absmax = std::max(stat.absmax, thread_blob_stats[t][i].absmax);
+            stat.minval = std::min(stat.minval, thread_blob_stats[t][i].minval);
+            stat.maxval = std::max(stat.maxval, thread_blob_stats[t][i].maxval);
+        }
+
+        stat.histogram.resize(num_histogram_bins, 0);
+
+        if (stat.absmax == 0.f)
+            continue;
+
+        const int range_exponent = histogram_range_exponent(stat.absmax);
+
+        for (int t = 0; t < quantize_num_threads; t++)
+        {
+            const QuantBlobStat& thread_stat = thread_blob_stats[t][i];
+            if (thread_stat.absmax == 0.f)
+                continue;
+
+            const int shift = std::min(range_exponent - histogram_range_exponent(thread_stat.absmax), 31);
+            for (int k = 0; k < num_histogram_bins; k++)
+            {
+                stat.histogram[k >> shift] += thread_stat.histogram[k];
             }
         }
+
+        // drop the empty bins above absmax
+        const float range = ldexpf(1.f, range_exponent);
+        const int used_bins = std::min((int)(stat.absmax / range * num_histogram_bins) + 1, num_histogram_bins);
+
+        stat.histogram.resize(used_bins);
+        stat.histogram_normed.resize(used_bins, 0);
     }
 
     // using kld to find the best threshold value
@@ -516,15 +581,17 @@ int QuantNet::quantize_KL()
     {
         QuantBlobStat& stat = quant_blob_stats[i];
 
+        const int used_bins = (int)stat.histogram.size();
+
         // normalize histogram bin
         {
             uint64_t sum = 0;
-            for (int j = 0; j < num_histogram_bins; j++)
+            for (int j = 0; j < used_bins; j++)
             {
                 sum += stat.histogram[j];
             }
 
-            for (int j = 0; j < num_histogram_bins; j++)
+            for (int j = 0; j < used_bins; j++)
             {
                 stat.histogram_normed[j] = (float)(stat.histogram[j] / (double)sum);
             }
@@ -535,7 +602,7 @@ int QuantNet::quantize_KL()
         int target_threshold = target_bin;
         float min_kl_divergence = FLT_MAX;
 
-        for (int threshold = target_bin; threshold < num_histogram_bins; threshold++)
+        for (int threshold = target_bin; threshold < used_bins; threshold++)
         {
             const float kl_eps = 0.0001f;
 
@@ -545,7 +612,7 @@ int QuantNet::quantize_KL()
                 {
                     clip_distribution[j] += stat.histogram_normed[j];
                 }
-                for (int j = threshold; j < num_histogram_bins; j++)
+                for (int j = threshold; j < used_bins; j++)
                 {
                     clip_distribution[threshold - 1] += stat.histogram_normed[j];
                 }
@@ -694,9 +761,23 @@ int QuantNet::quantize_KL()
             }
         }
 
-        stat.threshold = (target_threshold + 0.5f) * stat.absmax / num_histogram_bins;
+        const float range = ldexpf(1.f, histogram_range_exponent(stat.absmax));
+
+        stat.threshold = (target_threshold + 0.5f) * range / num_histogram_bins;
         float scale = 127 / stat.threshold;
 
+        if (quantize_asymmetric && layers[conv_layers[i]]->type == "Convolution")
+        {
+            // map the clipped [min, max] to [-127, 127], skewed ranges such as post relu gain one bit
+            const float lo = std::max(stat.minval, -stat.threshold);
+            const float hi = std::min(stat.maxval, stat.threshold);
+            if (hi > lo)
+            {
+                scale = 254 / (hi - lo);
+                bottom_blob_zero_points[i] = std::min(std::max((int)round(-127 - lo * scale), -127), 127);
+            }
+        }
+
         bottom_blob_scales[i].create(1);
         bottom_blob_scales[i][0] = scale;
     }
@@ -935,6 +1016,28 @@ static float cosine_similarity(const ncnn::Mat& a, const ncnn::Mat& b)
     return sim;
 }
 
+static float mean_squared_error(const ncnn::Mat& a, const ncnn::Mat& b)
+{
+    const int chanenls = a.c;
+    const int size = a.w * a.h;
+
+    double sum = 0;
+
+    for (int p = 0; p < chanenls; p++)
+    {
+        const float* pa = a.channel(p);
+        const float* pb = b.channel(p);
+
+        for (int i = 0; i < size; i++)
+        {
+            float diff = pa[i] - pb[i];
+            sum += diff * diff;
+        }
+    }
+
+    return (float)(sum / (chanenls * size));
+}
+
 static int get_layer_param(const ncnn::Layer* layer, ncnn::ParamDict& pd)
 {
     if (layer->type == "Convolution")
@@ -1117,6 +1220,7 @@ int QuantNet::quantize_EQ()
                 ncnn::ParamDict pd;
                 get_layer_param(layer, pd);
                 pd.set(8, 1); //int8_scale_term
+                pd.set(20, bottom_blob_zero_points[i]);
                 layer_int8->load_param(pd);
 
                 std::vector<float> sims(search_steps);
@@ -1227,6 +1331,7 @@ int QuantNet::quantize_EQ()
                 ncnn::ParamDict pd;
                 get_layer_param(layer, pd);
                 pd.set(8, 1); //int8_scale_term
+                pd.set(20, bottom_blob_zero_points[i]);
                 layer_int8->load_param(pd);
 
                 std::vector<float> sims(search_steps);
@@ -1290,6 +1395,183 @@ int QuantNet::quantize_EQ()
     return 0;
 }
 
+int QuantNet::quantize_sensitivity()
+{
+    // find the initial scale via KL
+    quantize_KL();
+
+    const int input_blob_count = (int)input_blobs.size();
+    const int conv_layer_count = (int)conv_layers.size();
+
+    std::vector<ncnn::UnlockedPoolAllocator> blob_allocators(quantize_num_threads);
+    std::vector<ncnn::UnlockedPoolAllocator> workspace_allocators(quantize_num_threads);
+
+    // max 50 images for sensitivity
+    const int image_count = std::min((int)listspaths[0].size(), 50);
+
+    // network outputs are the blobs nobody consumes
+    std::vector<int> output_blobs;
+    for (int i = 0; i < (int)blobs.size(); i++)
+    {
+        if (blobs[i].producer != -1 && blobs[i].consumer == -1)
+            output_blobs.push_back(i);
+    }
+
+    const int output_blob_count = (int)output_blobs.size();
+
+    std::vector<ncnn::Mat> inputs(image_count * input_blob_count);
+    std::vector<ncnn::Mat> outputs_fp32(image_count * output_blob_count);
+
+    #pragma omp parallel for num_threads(quantize_num_threads) schedule(static, 1)
+    for (int ii = 0; ii < image_count; ii++)
+    {
+        ncnn::Extractor ex = create_extractor();
+        ex.set_light_mode(true);
+
+        const int thread_num = ncnn::get_omp_thread_num();
+        ex.set_blob_allocator(&blob_allocators[thread_num]);
+        ex.set_workspace_allocator(&workspace_allocators[thread_num]);
+
+        for (int jj = 0; jj < input_blob_count; jj++)
+        {
+            const int type_to_pixel = type_to_pixels[jj];
+            const std::vector<float>& mean_vals = means[jj];
+            const std::vector<float>& norm_vals = norms[jj];
+
+            int pixel_convert_type = ncnn::Mat::PIXEL_BGR;
+            if (type_to_pixel != pixel_convert_type)
+            {
+                pixel_convert_type = pixel_convert_type | (type_to_pixel << ncnn::Mat::PIXEL_CONVERT_SHIFT);
+            }
+
+            ncnn::Mat in = read_and_resize_image(shapes[jj], listspaths[jj][ii], pixel_convert_type);
+
+            in.substract_mean_normalize(mean_vals.data(), norm_vals.data());
+
+            inputs[ii * input_blob_count + jj] = in;
+
+            ex.input(input_blobs[jj], in);
+        }
+
+        for (int jj = 0; jj < output_blob_count; jj++)
+        {
+            ncnn::Mat out;
+            ex.extract(output_blobs[jj], out);
+
+            // keep the reference outside the per-thread pool allocator
+            outputs_fp32[ii * output_blob_count + jj] = out.clone();
+        }
+    }
+
+    for (int i = 0; i < conv_layer_count; i++)
+    {
+        const ncnn::Layer* layer = layers[conv_layers[i]];
+
+        // quantize this layer alone
+        ncnn::Layer* layer_int8 = ncnn::create_layer(layer->typeindex);
+
+        layer_int8->type = layer->type;
+        layer_int8->name = layer->name;
+        layer_int8->bottoms = layer->bottoms;
+        layer_int8->tops = layer->tops;
+        layer_int8->bottom_shapes = layer->bottom_shapes;
+        layer_int8->top_shapes = layer->top_shapes;
+
+        ncnn::ParamDict pd;
+        get_layer_param(layer, pd);
+        pd.set(8, 1); //int8_scale_term
+        pd.set(20, bottom_blob_zero_points[i]);
+        layer_int8->load_param(pd);
+
+        std::vector<ncnn::Mat> weights;
+        get_layer_weights(layer, weights);
+        weights.push_back(weight_scales[i]);
+        weights.push_back(bottom_blob_scales[i]);
+        layer_int8->load_model(ncnn::ModelBinFromMatArray(weights.data()));
+
+        layer_int8->create_pipeline(opt);
+
+        layers[conv_layers[i]] = layer_int8;
+
+        std::vector<double> sims(image_count, 0.0);
+        std::vector<double> mses(image_count, 0.0);
+
+        #pragma omp parallel for num_threads(quantize_num_threads) schedule(static, 1)
+        for (int ii = 0; ii < image_count; ii++)
+        {
+            ncnn::Extractor ex = create_extractor();
+            ex.set_light_mode(true);
+
+            const int thread_num = ncnn::get_omp_thread_num();
+            ex.set_blob_allocator(&blob_allocators[thread_num]);
+            ex.set_workspace_allocator(&workspace_allocators[thread_num]);
+
+            for (int jj = 0; jj < input_blob_count; jj++)
+            {
+                ex.input(input_blobs[jj], inputs[ii * input_blob_count + jj]);
+            }
+
+            for (int jj = 0; jj < output_blob_count; jj++)
+            {
+                ncnn::Mat out;
+                ex.extract(output_blobs[jj], out);
+
+                const ncnn::Mat& out_fp32 = outputs_fp32[ii * output_blob_count + jj];
+
+                sims[ii] += cosine_similarity(out_fp32, out) / output_blob_count;
+                mses[ii] += mean_squared_error(out_fp32, out) / output_blob_count;
+            }
+        }
+
+        layers[conv_layers[i]] = (ncnn::Layer*)layer;
+
+        layer_int8->destroy_pipeline(opt);
+        delete layer_int8;
+
+        double avgsim = 0.0;
+        double avgmse = 0.0;
+        for (int ii = 0; ii < image_count; ii++)
+        {
+            avgsim += sims[ii];
+            avgmse += mses[ii];
+        }
+        avgsim /= image_count;
+        avgmse /= image_count;
+
+        layer_sensitivities[i] = (float)(1.0 - avgsim);
+
+        fprintf(stderr, "sensitivity %.2f%% [ %d / %d ] %-40s : cosine = %-12f  mse = %-12f\n", (i + 1) * 100.f / conv_layer_count, i + 1, conv_layer_count, layer->name.c_str(), avgsim, avgmse);
+    }
+
+    // rank by cosine distance, the most sensitive first
+    std::vector<std::pair<float, int> > ranks(conv_layer_count);
+    float total_sensitivity = 0.f;
+    for (int i = 0; i < conv_layer_count; i++)
+    {
+        ranks[i] = std::make_pair(layer_sensitivities[i], i);
+        total_sensitivity += layer_sensitivities[i];
+    }
+
+    std::sort(ranks.begin(), ranks.end(), std::greater<std::pair<float, int> >());
+
+    // keep the most sensitive layers in fp32 until the remaining int8 layers fit the budget
+    fprintf(stderr, "---------------------------------------\n");
+    for (int i = 0; i < conv_layer_count; i++)
+    {
+        const int index = ranks[i].second;
+
+        if (total_sensitivity > sensitivity_budget)
+        {
+            layer_keep_fp32[index] = true;
+            total_sensitivity -= ranks[i].first;
+        }
+
+        fprintf(stderr, "%-40s : cosine distance = %-12f  %s\n", layers[conv_layers[index]]->name.c_str(), ranks[i].first, layer_keep_fp32[index] ? "fp32" : "int8");
+    }
+
+    return 0;
+}
+
 static std::vector<std::vector<std::string> > parse_comma_path_list(char* s)
 {
     std::vector<std::vector<std::string> > aps;
@@ -1585,7 +1867,9 @@ static void show_usage()
     fprintf(stderr, "  shape=[224,224,3],...[w,h,c] or [w,h] **[0,0] will not resize\n");
     fprintf(stderr, "  pixel=RAW/RGB/BGR/GRAY/RGBA/BGRA,...\n");
     fprintf(stderr, "  thread=8\n");
-    fprintf(stderr, "  method=kl/aciq/eq\n");
+    fprintf(stderr, "  method=kl/aciq/eq/sensitivity\n");
+    fprintf(stderr, "  budget=0.01 **sum of cosine distance allowed for int8 layers in sensitivity method\n");
+    fprintf(stderr, "  asymmetric=0/1 **zero point for convolution input with kl/sensitivity method\n");
     fprintf(stderr, "Sample usage: ncnn2table squeezenet.param squeezenet.bin imagelist.txt squeezenet.table mean=[104.0,117.0,123.0] norm=[1.0,1.0,1.0] shape=[227,227,3] pixel=BGR method=kl\n");
 }
 
@@ -1660,6 +1944,10 @@ int main(int argc, char** argv)
             net.quantize_num_threads = atoi(value);
         if (memcmp(key, "method", 6) == 0)
             method = std::string(value);
+        if (memcmp(key, "budget", 6) == 0)
+            net.sensitivity_budget = atof(value);
+        if (memcmp(key, "asymmetric", 10) == 0)
+            net.quantize_asymmetric = atoi(value);
     }
 
     // sanity check
@@ -1711,6 +1999,9 @@ int main(int argc, char** argv)
         fprintf(stderr, "\n");
         fprintf(stderr, "thread = %d\n", net.quantize_num_threads);
         fprintf(stderr, "method = %s\n", method.c_str());
+        if (method == "sensitivity")
+            fprintf(stderr, "budget = %f\n", net.sensitivity_budget);
+        fprintf(stderr, "asymmetric = %d\n", net.quantize_asymmetric);
         fprintf(stderr, "---------------------------------------\n");
     }
 
@@ -1726,10 +2017,14 @@ int main(int argc, char** argv)
     {
         net.quantize_EQ();
     }
+    else if (method == "sensitivity")
+    {
+        net.quantize_sensitivity();
+    }
     else
     {
         fprintf(stderr, "not implemented yet !\n");
-        fprintf(stderr, "unknown method %s, expect kl / aciq / eq\n", method.c_str());
+        fprintf(stderr, "unknown method %s, expect kl / aciq / eq / sensitivity\n", method.c_str());
         return -1;
     }
 